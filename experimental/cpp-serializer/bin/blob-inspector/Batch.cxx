@@ -0,0 +1,316 @@
+#include "Batch.h"
+
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+#include <glob.h>
+
+#include "CordaBytes.h"
+#include "BlobStream.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+Batch::Batch (
+    std::vector<std::string> files_,
+    size_t workers_,
+    bool ordered_,
+    bool json_
+) : m_files { std::move (files_) }
+  , m_workers { std::max<size_t> (workers_, 1) }
+  , m_ordered { ordered_ }
+  , m_json { json_ }
+  , m_blobs { 0 }
+  , m_failures { 0 }
+  , m_bytes { 0 }
+  , m_skipped { 0 }
+  , m_seconds { 0 }
+{ }
+
+/******************************************************************************/
+
+/**
+ * Only JSON can be pruned so selecting anything means JSON
+ */
+void
+Batch::select (amqp::internal::reader::Projection projection_) {
+    m_projection = std::move (projection_);
+    m_json = true;
+}
+
+/******************************************************************************/
+
+/**
+ * Turn a single argument into the files it names
+ *
+ *  * @file    - a file containing a list of blobs, one per line, "@-"
+ *               reads the list from stdin
+ *  * directory - every regular file beneath it
+ *  * a pattern containing any of *?[ is expanded as a glob
+ *  * anything else is taken to be a blob
+ */
+std::vector<std::string>
+Batch::expand (const std::string & arg_) {
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> rtn;
+
+    if (!arg_.empty() && arg_[0] == '@') {
+        std::ifstream file;
+        auto list = arg_.substr (1);
+
+        if (list != "-") {
+            file.open (list);
+
+            if (!file) {
+                throw std::runtime_error ("Can't read file list " + list);
+            }
+        }
+
+        std::istream & in = (list == "-") ? std::cin : file;
+
+        for (std::string line ; std::getline (in, line) ; ) {
+            if (!line.empty()) {
+                rtn.push_back (line);
+            }
+        }
+    } else if (fs::is_directory (arg_)) {
+        for (const auto & entry : fs::recursive_directory_iterator (arg_)) {
+            if (entry.is_regular_file()) {
+                rtn.push_back (entry.path().string());
+            }
+        }
+
+        // directory iteration order is whatever the file system felt like
+        std::sort (rtn.begin(), rtn.end());
+    } else if (arg_.find_first_of ("*?[") != std::string::npos) {
+        glob_t results { };
+
+        if (::glob (arg_.c_str(), 0, nullptr, &results) == 0) {
+            for (size_t i { 0 } ; i < results.gl_pathc ; ++i) {
+                rtn.emplace_back (results.gl_pathv[i]);
+            }
+        }
+
+        ::globfree (&results);
+    } else {
+        rtn.push_back (arg_);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+Batch::Result
+Batch::inspect (const std::string & file_) const {
+    try {
+        CordaBytes cb (file_);
+        return inspect (file_, cb);
+    } catch (const std::exception & e) {
+        return Result { file_, e.what(), 0, 0, false };
+    }
+}
+
+/******************************************************************************/
+
+Batch::Result
+Batch::inspect (std::string name_, CordaBytes & cb_) const {
+    Result rtn { std::move (name_), "", cb_.size(), 0, false };
+
+    try {
+        if (cb_.encoding() != amqp::DATA_AND_STOP) {
+            std::stringstream ss;
+            ss << "BAD ENCODING " << cb_.encoding() << " != "
+               << amqp::DATA_AND_STOP;
+
+            rtn.output = ss.str();
+        } else if (m_json) {
+            // a bad blob is just another result, there's nothing to unwind
+            BlobInspector inspector (cb_, std::nothrow);
+            auto json = inspector.tryJson (m_projection);
+
+            rtn.ok = static_cast<bool> (json);
+            rtn.output = rtn.ok ? std::move (*json) : json.error().str();
+            rtn.skipped = inspector.skipped();
+        } else {
+            BlobInspector inspector (cb_);
+            rtn.output = inspector.dump();
+            rtn.skipped = inspector.skipped();
+            rtn.ok = true;
+        }
+    } catch (const std::exception & e) {
+        rtn.output = e.what();
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+Batch::run (const Sink & sink_) {
+    size_t next { 0 };
+
+    run ([this, & next](size_t & index_, Job & job_) {
+        if (next == m_files.size()) {
+            return false;
+        }
+
+        index_ = next++;
+        job_ = [this, & file = m_files[index_]]() { return inspect (file); };
+
+        return true;
+    }, sink_);
+}
+
+/******************************************************************************/
+
+/**
+ * Records are found by whichever worker wants one next, all that takes
+ * is working out how long the record is, and inspected straight from the
+ * stream's bytes. Anything in the stream that isn't a blob ends it, as a
+ * failure, since we can't know where the next one starts.
+ */
+void
+Batch::run (BlobStream & stream_, const Sink & sink_) {
+    bool broken { false };
+
+    run ([this, & stream_, & broken](size_t & index_, Job & job_) {
+        if (broken) {
+            return false;
+        }
+
+        BlobStream::Record record { };
+
+        try {
+            if (!stream_.next (record)) {
+                return false;
+            }
+        } catch (const std::exception & e) {
+            broken = true;
+            index_ = stream_.blobs();
+
+            job_ = [name = stream_.name() + "#" + std::to_string (index_),
+                    what = std::string (e.what())]()
+            {
+                return Result { name, what, 0, 0, false };
+            };
+
+            return true;
+        }
+
+        index_ = record.index;
+
+        job_ = [this, name = stream_.name(), record = std::move (record)]() {
+            CordaBytes cb (record.bytes, record.size);
+            return inspect (name + "#" + std::to_string (record.index), cb);
+        };
+
+        return true;
+    }, sink_);
+}
+
+/******************************************************************************/
+
+void
+Batch::run (const Source & source_, const Sink & sink_) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::mutex lock;
+
+    // only used when ordered, results that finished ahead of those
+    // before them wait here until it's their turn
+    std::map<size_t, Result> pending;
+    size_t emitted { 0 };
+
+    auto emit = [this, & sink_](const Result & result_) {
+        ++m_blobs;
+        m_bytes += result_.bytes;
+        m_skipped += result_.skipped;
+        m_failures += result_.ok ? 0 : 1;
+        sink_ (result_);
+    };
+
+    auto worker = [&]() {
+        size_t i { 0 };
+        Job job;
+
+        for ( ; ; ) {
+            {
+                std::lock_guard<std::mutex> guard (lock);
+
+                if (!source_ (i, job)) {
+                    break;
+                }
+            }
+
+            auto result = job();
+
+            std::lock_guard<std::mutex> guard (lock);
+
+            if (!m_ordered) {
+                emit (result);
+                continue;
+            }
+
+            pending.emplace (i, std::move (result));
+
+            for (auto it = pending.begin() ;
+                 it != pending.end() && it->first == emitted ;
+                 it = pending.erase (it), ++emitted)
+            {
+                emit (it->second);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve (m_workers - 1);
+
+    for (size_t i { 1 } ; i < m_workers ; ++i) {
+        threads.emplace_back (worker);
+    }
+
+    // the calling thread pulls its weight too
+    worker();
+
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    m_seconds = std::chrono::duration<double> (
+            std::chrono::steady_clock::now() - start).count();
+}
+
+/******************************************************************************/
+
+std::string
+Batch::throughput() const {
+    auto seconds = std::max (m_seconds, 1e-9);
+    auto mb = m_bytes / (1024.0 * 1024.0);
+    auto skipped = m_skipped / (1024.0 * 1024.0);
+
+    std::stringstream ss;
+
+    ss << std::fixed << std::setprecision (2)
+       << m_blobs << " blobs (" << m_failures << " failed), "
+       << mb << " MB (" << mb - skipped << " decoded, "
+       << skipped << " skipped) in " << m_seconds << "s with "
+       << m_workers << " workers: "
+       << m_blobs / seconds << " blobs/s, "
+       << mb / seconds << " MB/s";
+
+    return ss.str();
+}
+
+/******************************************************************************/
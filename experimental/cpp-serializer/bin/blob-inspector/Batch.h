@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "amqp/reader/Projection.h"
+
+/******************************************************************************/
+
+class CordaBytes;
+class BlobStream;
+
+/******************************************************************************/
+
+/**
+ * Inspect a set of blobs on a pool of worker threads.
+ *
+ * The workers share the process wide reader cache so a schema is only
+ * turned into readers once however many blobs use it. Each blob gets its
+ * own [CordaBytes] and [BlobInspector], nothing else is written to.
+ *
+ * Results are handed to the sink one at a time, either as each blob
+ * finishes or, when ordered, in the order the files were given to us.
+ * Each is either the default dump format or, if asked for, JSON.
+ * Given a projection, see [select], it's JSON of just what's selected.
+ * Writing JSON, a blob we can't read is a failed result without anything
+ * having been thrown, see [BlobInspector::tryJson].
+ *
+ * Rather than files the blobs can come one after another from a single
+ * [BlobStream], each named for the stream and its index in it.
+ */
+class Batch {
+    public :
+        struct Result {
+            std::string file;
+            std::string output;
+            size_t bytes;
+            size_t skipped;
+            bool ok;
+        };
+
+        using Sink = std::function<void (const Result &)>;
+
+    private :
+        using Job = std::function<Result()>;
+
+        /*
+         * The index of the next blob and how to inspect it, false once
+         * there are none left. Only ever called by one worker at a time
+         */
+        using Source = std::function<bool (size_t &, Job &)>;
+
+    private :
+        std::vector<std::string> m_files;
+        size_t m_workers;
+        bool m_ordered;
+        bool m_json;
+        amqp::internal::reader::Projection m_projection;
+
+        size_t m_blobs;
+        size_t m_failures;
+        size_t m_bytes;
+        size_t m_skipped;
+        double m_seconds;
+
+        Result inspect (const std::string &) const;
+        Result inspect (std::string, CordaBytes &) const;
+
+        void run (const Source &, const Sink &);
+
+    public :
+        Batch (std::vector<std::string>, size_t, bool, bool json_ = false);
+
+        static std::vector<std::string> expand (const std::string &);
+
+        void select (amqp::internal::reader::Projection);
+
+        void run (const Sink &);
+
+        void run (BlobStream &, const Sink &);
+
+        size_t blobs() const { return m_blobs; }
+        size_t failures() const { return m_failures; }
+        size_t bytes() const { return m_bytes; }
+        size_t skipped() const { return m_skipped; }
+        double seconds() const { return m_seconds; }
+
+        std::string throughput() const;
+};
+
+/******************************************************************************/
@@ -3,71 +3,368 @@
 
 #include <iostream>
 #include <sstream>
+#include <optional>
+#include <stdexcept>
+#include <assert.h>
 
 #include "proton/codec.h"
 #include "proton/proton_wrapper.h"
 
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
 
-#include "amqp/CompositeFactory.h"
+#include "amqp/ReaderCache.h"
+#include "amqp/reader/References.h"
+#include "amqp/writer/JsonWriter.h"
 #include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/descriptors/corda-descriptors/EnvelopeDescriptor.h"
 
 /******************************************************************************/
 
-BlobInspector::BlobInspector (CordaBytes & cb_)
+BlobInspector::BlobInspector (CordaBytes & cb_, bool lazy_)
+    : BlobInspector (cb_, std::nothrow, lazy_)
+{
+    if (m_error) {
+        throw amqp::Failure (m_error);
+    }
+}
+
+/******************************************************************************/
+
+BlobInspector::BlobInspector (CordaBytes & cb_, std::nothrow_t, bool lazy_)
     : m_data { pn_data (cb_.size()) }
+    , m_lazy { lazy_ }
 {
-    // returns how many bytes we processed which right now we don't care
-    // about but I assume there is a case where it doesn't process the
-    // entire file
+    // returns how many bytes the blob took up, anything after that being
+    // another blob written straight after it, see [BlobStream]
     auto rtn = pn_data_decode (m_data, cb_.bytes(), cb_.size());
-    assert (rtn == cb_.size());
+
+    if (rtn < 0) {
+        m_error = { amqp::Errc::Malformed, 0 };
+    } else if (static_cast<size_t>(rtn) != cb_.size()) {
+        m_error = { amqp::Errc::TrailingBytes, static_cast<size_t>(rtn) };
+    }
 }
 
 /******************************************************************************/
 
-std::string
-BlobInspector::dump() {
-    std::unique_ptr<amqp::internal::schema::Envelope> envelope;
+BlobInspector::~BlobInspector() {
+    pn_data_free (m_data);
+}
 
-    if (pn_data_is_described (m_data)) {
-        proton::auto_enter p (m_data);
+/******************************************************************************/
 
-        auto a = pn_data_get_ulong(m_data);
+namespace {
 
-        envelope.reset (
-                dynamic_cast<amqp::internal::schema::Envelope *> (
-                        amqp::internal::AMQPDescriptorRegistory[a]->build(m_data).release()));
+    amqp::Error
+    error (amqp::Errc code_, pn_data_t * data_) {
+        return { code_, proton::offset (data_) };
     }
 
-    amqp::internal::CompositeFactory cf;
+    /**
+     * With [data_] on an envelope, where its [n_]th section starts, the
+     * blob itself being the first and its schema the second
+     */
+    size_t
+    section (pn_data_t * data_, size_t n_) {
+        proton::auto_enter p (data_);
+        pn_data_next (data_);
 
-    cf.process (envelope->schema());
+        proton::auto_enter p2 (data_);
 
-    auto reader = cf.byDescriptor (envelope->descriptor());
-    assert (reader);
+        for (size_t i { 0 } ; i < n_ ; ++i) {
+            pn_data_next (data_);
+        }
+
+        return proton::offset (data_);
+    }
+
+    /**
+     * Build the envelope in [data_], returning what's wrong with it, if
+     * anything, including that it didn't decode in the first place. Read
+     * lazily [cf_] is left holding the cached readers for its schema.
+     */
+    amqp::Result<void>
+    buildEnvelope (
+        pn_data_t * data_,
+        const amqp::Error & decoded_,
+        bool lazy_,
+        std::unique_ptr<amqp::internal::schema::Envelope> & envelope_,
+        amqp::internal::ReaderCache::FactoryPtr & cf_
+    ) {
+        using amqp::internal::ReaderCache;
+        using amqp::internal::schema::descriptors::EnvelopeDescriptor;
+
+        if (decoded_) {
+            return decoded_;
+        }
+
+        if (!pn_data_is_described (data_)) {
+            return error (amqp::Errc::NotAnEnvelope, data_);
+        }
+
+        proton::auto_enter p (data_);
+
+        if (pn_data_type (data_) != PN_ULONG) {
+            return error (amqp::Errc::NotAnEnvelope, data_);
+        }
+
+        // find rather than [] since we may share the registry with
+        // other threads and mustn't insert into it
+        auto it = amqp::internal::AMQPDescriptorRegistory.find (
+                pn_data_get_ulong (data_));
+
+        if (it == amqp::internal::AMQPDescriptorRegistory.end()) {
+            return error (amqp::Errc::NotAnEnvelope, data_);
+        }
+
+        auto descriptor = dynamic_cast<const EnvelopeDescriptor *> (
+                it->second.get());
+
+        if (!descriptor) {
+            return error (amqp::Errc::NotAnEnvelope, data_);
+        }
+
+        auto built = lazy_
+            ? descriptor->tryBuild (data_, [&cf_](pn_data_t * schema_)
+                -> amqp::Result<ReaderCache::SchemaPtr>
+            {
+                auto entry = ReaderCache::instance().tryEntry (schema_);
+
+                if (!entry) {
+                    return entry.error();
+                }
+
+                cf_ = entry->factory;
+                return entry->schema;
+            })
+            : descriptor->tryBuild (data_);
+
+        if (!built) {
+            return built.error();
+        }
+
+        envelope_ = std::move (*built);
+
+        return { };
+    }
+
+    /**
+     * Find the reader for the blob described by the envelope in [data_]
+     * and hand it, positioned on the blob itself, to [f_]. Anything wrong
+     * with the blob, including that it didn't decode in the first place,
+     * is returned rather than thrown, as is whatever [f_] returns.
+     */
+    template<class F>
+    amqp::Result<void>
+    inspect (pn_data_t * data_, const amqp::Error & decoded_, bool lazy_, F f_) {
+        using amqp::internal::ReaderCache;
+
+        std::unique_ptr<amqp::internal::schema::Envelope> envelope;
+        ReaderCache::FactoryPtr cf;
+
+        if (auto built = buildEnvelope (data_, decoded_, lazy_, envelope, cf); !built) {
+            return built;
+        }
+
+        // blobs tend to share schemas so rather than build the readers afresh
+        // each time reuse the ones from the last blob with the same set of types,
+        // which only doesn't happen when we're not lazy. Readers we can't build
+        // for a schema we could read are down to its types
+        if (!cf) {
+            try {
+                cf = ReaderCache::instance().factory (
+                        dynamic_cast<const amqp::internal::schema::Schema &>(
+                                envelope->schema()));
+            } catch (const amqp::Failure & e) {
+                return e.error();
+            } catch (const std::exception &) {
+                return amqp::Error { amqp::Errc::Unsupported, section (data_, 1) };
+            }
+        }
 
-    {
         // move to the actual blob entry in the tree - ideally we'd have
         // saved this on the Envelope but that's not easily doable as we
         // can't grab an actual copy of our data pointer
-        proton::auto_enter p (m_data);
-        pn_data_next (m_data);
-        proton::is_list (m_data);
-        assert (pn_data_get_list (m_data) == 3);
-        {
-            proton::auto_enter p (m_data);
+        proton::auto_enter p (data_);
+        pn_data_next (data_);
 
-            std::stringstream ss;
+        proton::auto_enter p2 (data_);
 
-            // We wrap our output like this to make sure it's valid JSON to
-            // facilitate easy pretty printing
-            ss << reader->dump ("{ Parsed", m_data, envelope->schema())->dump()
-               << " }";
+        auto reader = cf->byDescriptor (envelope->descriptor());
 
-            return ss.str();
+        if (!reader) {
+            return error (amqp::Errc::Unsupported, data_);
         }
+
+        return f_ (*reader, *envelope, *cf);
     }
+
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::dump() {
+    using amqp::internal::reader::Arena;
+    using amqp::internal::reader::References;
+
+    // The tree only lives as long as it takes to print it so rather than
+    // a new arena each time keep one per thread and reset it as we go
+    static thread_local Arena arena;
+
+    struct AutoReset {
+        Arena & m_arena;
+        ~AutoReset() { m_arena.reset(); }
+    } ar { arena };
+
+    Arena::Scope scope (arena);
+
+    References references;
+    References::Scope refs (references);
+
+    std::string rtn;
+
+    inspect (m_data, m_error, m_lazy, [&](auto & reader_, const auto & envelope_, auto &) {
+        auto value = reader_.dump ("{ Parsed", m_data, envelope_.schema());
+
+        std::stringstream ss;
+
+        // We wrap our output like this to make sure it's valid JSON to
+        // facilitate easy pretty printing
+        ss << value->dump() << " }";
+
+        // everything it owns is in the arena which is about to be reset
+        // so there's no need to walk the tree destroying it
+        value.release();
+
+        rtn = ss.str();
+
+        return amqp::Result<void> { };
+    }).value();
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * The blob as a tree of values, all of which live in an arena of their
+ * own that's released in one go when the result is dropped
+ */
+amqp::internal::reader::ArenaPtr<amqp::reader::IValue>
+BlobInspector::parse() {
+    using amqp::internal::reader::Arena;
+    using amqp::internal::reader::ArenaPtr;
+    using amqp::internal::reader::References;
+
+    auto arena = std::make_unique<Arena>();
+    Arena::Scope scope (*arena);
+
+    References references;
+    References::Scope refs (references);
+
+    std::optional<ArenaPtr<amqp::reader::IValue>> rtn;
+
+    inspect (m_data, m_error, m_lazy, [&](auto & reader_, const auto & envelope_, auto &) {
+        rtn.emplace (std::move (arena), reader_.dump ("Parsed", m_data, envelope_.schema()));
+
+        return amqp::Result<void> { };
+    }).value();
+
+    return std::move (*rtn);
+}
+
+/******************************************************************************/
+
+/**
+ * Stream the blob as JSON, wrapped the same way [dump] wraps its output
+ */
+void
+BlobInspector::write (
+    amqp::writer::IWriter & writer_,
+    const amqp::internal::reader::Projection & projection_
+) {
+    tryWrite (writer_, projection_).value();
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::json (const amqp::internal::reader::Projection & projection_) {
+    return tryJson (projection_).value();
+}
+
+/******************************************************************************/
+
+amqp::Result<void>
+BlobInspector::tryWrite (
+    amqp::writer::IWriter & writer_,
+    const amqp::internal::reader::Projection & projection_
+) {
+    return inspect (m_data, m_error, m_lazy, [&](auto &, const auto & envelope_, auto & factory_)
+        -> amqp::Result<void>
+    {
+        // a projection that doesn't fit this blob's types can't be compiled
+        std::pair<sPtr<const amqp::internal::reader::Program>, uint32_t> program;
+
+        try {
+            program = factory_.program (envelope_.descriptor(), projection_);
+        } catch (const std::exception &) {
+            return error (amqp::Errc::BadProjection, m_data);
+        }
+
+        writer_.beginObject();
+        writer_.key ("Parsed");
+
+        auto rtn = program.first->tryRun (program.second, m_data, writer_);
+
+        if (rtn) {
+            writer_.endObject();
+        }
+
+        return rtn;
+    });
+}
+
+/******************************************************************************/
+
+amqp::Result<std::string>
+BlobInspector::tryJson (const amqp::internal::reader::Projection & projection_) {
+    amqp::internal::writer::JsonWriter writer;
+
+    auto rtn = tryWrite (writer, projection_);
+
+    if (!rtn) {
+        return rtn.error();
+    }
+
+    return writer.take();
+}
+
+/******************************************************************************/
+
+/**
+ * Only the envelope is needed, readers for the blob being built as they
+ * were would be wasted or, a target having already been given that the
+ * blob's types can't be evolved to, impossible
+ */
+void
+BlobInspector::target() {
+    std::unique_ptr<amqp::internal::schema::Envelope> envelope;
+    amqp::internal::ReaderCache::FactoryPtr cf;
+
+    buildEnvelope (m_data, m_error, false, envelope, cf).value();
+
+    amqp::internal::ReaderCache::instance().evolveTo (
+            dynamic_cast<const amqp::internal::schema::Schema &> (envelope->schema()),
+            envelope->transforms());
+}
+
+/******************************************************************************/
+
+size_t
+BlobInspector::skipped() const {
+    return proton::skipped (m_data);
 }
 
 /******************************************************************************/
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <new>
 #include <iosfwd>
 #include "CordaBytes.h"
 
+#include "amqp/Result.h"
+#include "amqp/reader/IReader.h"
+#include "amqp/reader/Arena.h"
+#include "amqp/reader/Projection.h"
+
 /******************************************************************************/
 
 struct pn_data_t;
@@ -13,11 +19,74 @@ class BlobInspector {
     private :
         pn_data_t * m_data;
 
+        /*
+         * When lazy the envelope's schema is only parsed if the reader
+         * cache hasn't already seen it
+         */
+        bool m_lazy;
+
+        /*
+         * Why the blob wouldn't decode, if it wouldn't
+         */
+        amqp::Error m_error;
+
     public :
-        BlobInspector (CordaBytes &);
+        explicit BlobInspector (CordaBytes &, bool lazy_ = true);
+
+        /**
+         * As above but a blob that won't decode leaves us holding the
+         * error rather than throwing it, each of the try methods below
+         * returning it
+         */
+        BlobInspector (CordaBytes &, std::nothrow_t, bool lazy_ = true);
+
+        BlobInspector (const BlobInspector &) = delete;
+        BlobInspector & operator = (const BlobInspector &) = delete;
+
+        ~BlobInspector();
 
         std::string dump();
 
+        amqp::internal::reader::ArenaPtr<amqp::reader::IValue> parse();
+
+        /**
+         * Only what [projection_] selects is read and written, by default
+         * that's everything
+         */
+        void write (
+            amqp::writer::IWriter &,
+            const amqp::internal::reader::Projection & projection_ = { });
+
+        std::string json (
+            const amqp::internal::reader::Projection & = { });
+
+        /**
+         * As [write] and [json] but a blob that isn't what its schema
+         * says it is, or isn't a Corda blob at all, is an error rather
+         * than an exception, as is a projection that selects what its
+         * types don't have. What's been written of it by then stays
+         * written.
+         */
+        amqp::Result<void> tryWrite (
+            amqp::writer::IWriter &,
+            const amqp::internal::reader::Projection & = { });
+
+        amqp::Result<std::string> tryJson (
+            const amqp::internal::reader::Projection & = { });
+
+        /**
+         * Read every blob from now on as the versions of its types in
+         * this blob's schema, its enums' constants as named by its
+         * transforms, see [ReaderCache::evolveTo]
+         */
+        void target();
+
+        /**
+         * How many bytes of the blob have been stepped over rather than
+         * read, only the native codec keeps count
+         */
+        size_t skipped() const;
+
 };
 
 /******************************************************************************/
@@ -0,0 +1,230 @@
+#include "BlobStream.h"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "proton/codec.h"
+
+#include "amqp/AMQPHeader.h"
+#include "amqp/AMQPSectionId.h"
+
+/******************************************************************************/
+
+namespace {
+
+    constexpr size_t headerSize { amqp::AMQP_HEADER.size() + 1 };
+
+    /*
+     * How much of a pipe we read at once, doubled for any blob bigger
+     * than that
+     */
+    constexpr size_t chunkSize { 1 << 20 };
+
+}
+
+/******************************************************************************/
+
+BlobStream::BlobStream (const std::string & file_)
+    : m_name { file_ }
+    , m_data { pn_data (0) }
+    , m_mapped { nullptr }
+    , m_mappedSize { 0 }
+    , m_fd { file_ == "-" ? STDIN_FILENO : ::open (file_.c_str(), O_RDONLY) }
+    , m_close { file_ != "-" }
+    , m_eof { false }
+    , m_pos { nullptr }
+    , m_end { nullptr }
+    , m_index { 0 }
+    , m_offset { 0 }
+{
+    if (m_fd < 0) {
+        pn_data_free (m_data);
+        throw std::runtime_error ("Failed to open " + file_);
+    }
+
+    open();
+}
+
+/******************************************************************************/
+
+BlobStream::BlobStream (int fd_, std::string name_)
+    : m_name { std::move (name_) }
+    , m_data { pn_data (0) }
+    , m_mapped { nullptr }
+    , m_mappedSize { 0 }
+    , m_fd { fd_ }
+    , m_close { false }
+    , m_eof { false }
+    , m_pos { nullptr }
+    , m_end { nullptr }
+    , m_index { 0 }
+    , m_offset { 0 }
+{
+    open();
+}
+
+/******************************************************************************/
+
+BlobStream::~BlobStream() {
+    if (m_mapped) {
+        ::munmap (m_mapped, m_mappedSize);
+    }
+
+    if (m_close) {
+        ::close (m_fd);
+    }
+
+    pn_data_free (m_data);
+}
+
+/******************************************************************************/
+
+/**
+ * Map the whole of anything we can, pipes, and anything that won't map,
+ * being read as we go
+ */
+void
+BlobStream::open() {
+    struct stat results { };
+
+    if (::fstat (m_fd, &results) != 0 || !S_ISREG (results.st_mode)) {
+        return;
+    }
+
+    if (results.st_size == 0) {
+        m_eof = true;
+        return;
+    }
+
+    auto mapped = ::mmap (
+            nullptr, results.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+
+    if (mapped == MAP_FAILED) {
+        return;
+    }
+
+    m_eof = true;
+    m_mapped = mapped;
+    m_mappedSize = results.st_size;
+
+    ::madvise (m_mapped, m_mappedSize, MADV_SEQUENTIAL);
+
+    m_pos = static_cast<const char *>(m_mapped);
+    m_end = m_pos + m_mappedSize;
+}
+
+/******************************************************************************/
+
+/**
+ * Read whatever the pipe has for us onto the end of what we've not yet
+ * handed out. We never move bytes a record we've handed out points at,
+ * so once the chunk is full what's left of it is copied into a new one
+ * and those records keep the old one alive between them.
+ *
+ * False if there's nothing more to read.
+ */
+bool
+BlobStream::fill() {
+    if (m_eof) {
+        return false;
+    }
+
+    auto remaining = static_cast<size_t>(m_end - m_pos);
+
+    if (!m_chunk || m_end == m_chunk->data() + m_chunk->size()) {
+        auto chunk = std::make_shared<std::vector<char>> (
+                std::max (chunkSize, 2 * remaining));
+
+        if (remaining) {
+            std::memcpy (chunk->data(), m_pos, remaining);
+        }
+
+        m_chunk = std::move (chunk);
+        m_pos = m_chunk->data();
+        m_end = m_pos + remaining;
+    }
+
+    auto space = static_cast<size_t>(m_chunk->data() + m_chunk->size() - m_end);
+
+    for ( ; ; ) {
+        auto rtn = ::read (m_fd, const_cast<char *>(m_end), space);
+
+        if (rtn > 0) {
+            m_end += rtn;
+            return true;
+        }
+
+        if (rtn == 0) {
+            m_eof = true;
+            return false;
+        }
+
+        if (errno != EINTR) {
+            throw std::runtime_error (
+                    "Failed to read " + m_name + ": " + std::strerror (errno));
+        }
+    }
+}
+
+/******************************************************************************/
+
+bool
+BlobStream::next (Record & record_) {
+    for ( ; ; ) {
+        auto available = static_cast<size_t>(m_end - m_pos);
+
+        if (available >= headerSize) {
+            if (!std::equal (
+                    amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), m_pos))
+            {
+                throw std::runtime_error (
+                        m_name + ": not a Corda blob at byte "
+                        + std::to_string (m_offset));
+            }
+
+            auto encoding = m_pos[amqp::AMQP_HEADER.size()];
+
+            if (encoding != amqp::DATA_AND_STOP) {
+                throw std::runtime_error (
+                        m_name + ": can't stream a blob with section id "
+                        + std::to_string (encoding) + " at byte "
+                        + std::to_string (m_offset));
+            }
+
+            pn_data_clear (m_data);
+
+            auto rtn = pn_data_decode (
+                    m_data, m_pos + headerSize, available - headerSize);
+
+            if (rtn >= 0) {
+                auto size = headerSize + static_cast<size_t>(rtn);
+
+                record_ = Record { m_index++, m_offset, m_pos, size, m_chunk };
+
+                m_pos += size;
+                m_offset += size;
+
+                return true;
+            }
+        }
+
+        if (!fill()) {
+            if (available == 0) {
+                return false;
+            }
+
+            throw std::runtime_error (
+                    m_name + ": truncated blob at byte "
+                    + std::to_string (m_offset));
+        }
+    }
+}
+
+/******************************************************************************/
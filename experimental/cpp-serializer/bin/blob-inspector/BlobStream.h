@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+/******************************************************************************/
+
+/**
+ * Blobs written one after another into a single file, or piped in, each
+ * starting with its own Corda header and section id.
+ *
+ * Nothing says how long each one is so we find the end of a blob by
+ * decoding it, what [pn_data_decode] consumes being where the next
+ * begins. A regular file, stdin redirected from one included, is memory
+ * mapped and every record points straight into the mapping. A pipe is
+ * read a chunk at a time, a record that straddles the end of one chunk
+ * being the only thing ever copied, into the start of the next.
+ *
+ * Only uncompressed blobs can be streamed, Snappy's framing having no
+ * end we could find without decompressing it.
+ */
+class BlobStream {
+    public :
+        /**
+         * A blob, header and all, ready to hand to [CordaBytes]. The bytes
+         * stay valid for as long as the record, or rather [chunk], and the
+         * stream it came from do
+         */
+        struct Record {
+            size_t index;
+            size_t offset;
+            const char * bytes;
+            size_t size;
+
+            // what [bytes] points into when read from a pipe
+            std::shared_ptr<const std::vector<char>> chunk;
+        };
+
+    private :
+        std::string m_name;
+        pn_data_t * m_data;
+
+        void * m_mapped;
+        size_t m_mappedSize;
+
+        int m_fd;
+        bool m_close;
+        bool m_eof;
+        std::shared_ptr<std::vector<char>> m_chunk;
+
+        const char * m_pos;
+        const char * m_end;
+
+        size_t m_index;
+        size_t m_offset;
+
+        void open();
+        bool fill();
+
+    public :
+        /**
+         * "-" is stdin
+         */
+        explicit BlobStream (const std::string & file_);
+
+        /**
+         * Read from [fd_], which we don't close
+         */
+        BlobStream (int fd_, std::string name_);
+
+        BlobStream (const BlobStream &) = delete;
+        BlobStream & operator = (const BlobStream &) = delete;
+
+        ~BlobStream();
+
+        const std::string & name() const { return m_name; }
+
+        /**
+         * The next blob in [record_], false once there are none left.
+         * Throws if what's there isn't a blob or stops part way through one
+         */
+        bool next (Record & record_);
+
+        /**
+         * How many blobs, and how many bytes, we've read so far
+         */
+        size_t blobs() const { return m_index; }
+        size_t offset() const { return m_offset; }
+};
+
+/******************************************************************************/
@@ -1,38 +1,209 @@
 #include "CordaBytes.h"
 
 #include <array>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+
 #include "amqp/AMQPHeader.h"
+#include "Decompress.h"
 
 /******************************************************************************/
 
-CordaBytes::CordaBytes (const std::string & file_)
-    : m_blob { nullptr }
+namespace {
+
+    /**
+     * Closes the file descriptor once we've mapped it, the mapping keeps
+     * its own reference to the file
+     */
+    struct AutoFd {
+        int m_fd;
+
+        explicit AutoFd (int fd_) : m_fd (fd_) { }
+
+        ~AutoFd() {
+            if (m_fd >= 0) {
+                ::close (m_fd);
+            }
+        }
+    };
+
+    constexpr size_t headerSize { amqp::AMQP_HEADER.size() + 1 };
+
+    /*
+     * Compressed blobs are inflated into a buffer we hand back and forth
+     * between each blob a thread loads so it's only grown, never
+     * reallocated, once it's big enough
+     */
+    thread_local std::vector<char> spare; // NOLINT
+
+}
+
+/******************************************************************************/
+
+CordaBytes::CordaBytes (const std::string & file_, Mode mode_)
+    : m_encoding { amqp::DATA_AND_STOP }
+    , m_size { 0 }
+    , m_blob { nullptr }
+    , m_mapped { nullptr }
+    , m_mappedSize { 0 }
 {
-    std::ifstream file { file_, std::ios::in | std::ios::binary };
     struct stat results { };
 
-    if (::stat(file_.c_str(), &results) != 0) {
+    if (::stat (file_.c_str(), &results) != 0) {
         throw std::runtime_error ("Not a file");
     }
 
-    // Disregard the Corda header
-    m_size = results.st_size - (amqp::AMQP_HEADER.size() + 1);
+    if (static_cast<size_t>(results.st_size) < headerSize) {
+        throw std::runtime_error ("Not a Corda stream");
+    }
 
-    std::array<char, 7> header { };
-    file.read (header.data(), 7);
+    if (mode_ == Mode::map) {
+        AutoFd fd { ::open (file_.c_str(), O_RDONLY) };
 
-    if (header != amqp::AMQP_HEADER) {
-        throw std::runtime_error ("Not a Corda stream");
+        if (fd.m_fd < 0) {
+            throw std::runtime_error ("Failed to open " + file_);
+        }
+
+        m_mappedSize = results.st_size;
+        m_mapped = ::mmap (
+                nullptr, m_mappedSize, PROT_READ, MAP_PRIVATE, fd.m_fd, 0);
+
+        if (m_mapped == MAP_FAILED) {
+            m_mapped = nullptr;
+            throw std::runtime_error ("Failed to map " + file_);
+        }
+
+        // we read each blob front to back, let the kernel read ahead
+        ::madvise (m_mapped, m_mappedSize, MADV_SEQUENTIAL);
+
+        try {
+            header (static_cast<const char *>(m_mapped), m_mappedSize);
+            body();
+        } catch (...) {
+            ::munmap (m_mapped, m_mappedSize);
+            throw;
+        }
+    } else {
+        std::ifstream file { file_, std::ios::in | std::ios::binary };
+
+        if (!file) {
+            throw std::runtime_error ("Failed to open " + file_);
+        }
+
+        std::array<char, headerSize> header { };
+
+        if (!file.read (header.data(), header.size())) {
+            throw std::runtime_error ("Failed to read " + file_);
+        }
+
+        // validate the header before we allocate space for the body
+        this->header (header.data(), results.st_size);
+
+        m_heap.reset (new char[m_size]);
+        // nothing short of the whole body, a short read would have us
+        // decode whatever the heap last held
+        if (!file.read (m_heap.get(), m_size)) {
+            throw std::runtime_error ("Failed to read " + file_);
+        }
+
+        m_blob = m_heap.get();
+
+        body();
     }
+}
 
-    file.read (reinterpret_cast<char *>(&m_encoding), 1);
+/******************************************************************************/
 
-    m_blob = new char[m_size];
+CordaBytes::CordaBytes (const char * bytes_, size_t size_)
+    : m_encoding { amqp::DATA_AND_STOP }
+    , m_size { 0 }
+    , m_blob { nullptr }
+    , m_mapped { nullptr }
+    , m_mappedSize { 0 }
+{
+    header (bytes_, size_);
+    body();
+}
+
+/******************************************************************************/
+
+CordaBytes::~CordaBytes() {
+    if (m_mapped) {
+        ::munmap (m_mapped, m_mappedSize);
+    }
+
+    if (m_inflated.capacity() > spare.capacity()) {
+        spare.swap (m_inflated);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Validate the Corda header at the start of [bytes_] and point ourselves at
+ * what follows it, [size_] being the size of the whole blob including that
+ * header
+ */
+void
+CordaBytes::header (const char * bytes_, size_t size_) {
+    if (   size_ < headerSize
+        || !std::equal (
+                amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), bytes_))
+    {
+        throw std::runtime_error ("Not a Corda stream");
+    }
+
+    m_encoding = static_cast<amqp::amqp_section_id_t>(
+            bytes_[amqp::AMQP_HEADER.size()]);
 
-    memset (m_blob, 0, m_size);
-    file.read (m_blob, m_size);
+    m_blob = bytes_ + headerSize;
+    m_size = size_ - headerSize;
 }
 
 /******************************************************************************/
 
+/**
+ * If the blob has an ENCODING section the byte after it says how the rest
+ * was compressed. Decompressed it should be a DATA_AND_STOP section, that
+ * and what follows being what we point at from then on
+ */
+void
+CordaBytes::body() {
+    if (m_encoding != amqp::ENCODING) {
+        return;
+    }
+
+    if (m_size < 1) {
+        throw std::runtime_error ("Missing encoding");
+    }
+
+    auto compression = static_cast<amqp::amqp_encoding_t>(m_blob[0]);
+
+    m_inflated.swap (spare);
+    decompress (compression, m_blob + 1, m_size - 1, m_inflated);
+
+    if (m_inflated.empty() || m_inflated[0] != amqp::DATA_AND_STOP) {
+        throw std::runtime_error ("Compressed blob has no DATA_AND_STOP section");
+    }
+
+    // nothing needs the compressed bytes now
+    m_heap.reset();
+
+    if (m_mapped) {
+        ::munmap (m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+    }
+
+    m_compression = compression;
+    m_encoding = amqp::DATA_AND_STOP;
+    m_blob = m_inflated.data() + 1;
+    m_size = m_inflated.size() - 1;
+}
+
+/******************************************************************************/
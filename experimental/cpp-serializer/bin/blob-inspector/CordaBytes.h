@@ -1,31 +1,69 @@
 #pragma once
 
 #include "string"
-#include <fstream>
+#include <memory>
+#include <vector>
+#include <optional>
 #include "amqp/AMQPSectionId.h"
 
 /******************************************************************************/
 
+/**
+ * The body of a serialised Corda blob, that is everything after the 8 byte
+ * header. Where those bytes come from depends on how it's constructed
+ *
+ *  * From a file, either memory mapped (the default) or read onto the heap
+ *  * From a buffer owned by the caller, nothing is copied and that buffer
+ *    must outlive this object
+ *
+ * A blob written with an ENCODING section is decompressed as it's loaded,
+ * after which it looks just like any other DATA_AND_STOP blob other than
+ * [compression] saying how it was stored.
+ */
 class CordaBytes {
+    public :
+        enum class Mode { map, read };
+
     private :
         amqp::amqp_section_id_t m_encoding;
         size_t m_size;
-        char * m_blob;
+        const char * m_blob;
+
+        // what, if anything, we need to release
+        std::unique_ptr<char[]> m_heap;
+        void * m_mapped;
+        size_t m_mappedSize;
+
+        std::optional<amqp::amqp_encoding_t> m_compression;
+        std::vector<char> m_inflated;
+
+        void header (const char *, size_t);
+        void body();
 
     public :
-        explicit CordaBytes (const std::string &);
+        explicit CordaBytes (const std::string &, Mode = Mode::map);
 
-        ~CordaBytes() {
-            delete [] m_blob;
-        }
+        CordaBytes (const char *, size_t);
+
+        CordaBytes (const CordaBytes &) = delete;
+        CordaBytes & operator = (const CordaBytes &) = delete;
+
+        ~CordaBytes();
 
         const decltype (m_encoding) & encoding() const {
             return m_encoding;
         }
 
+        const decltype (m_compression) & compression() const {
+            return m_compression;
+        }
+
         decltype (m_size) size() const { return m_size; }
 
-        const char * const bytes() const { return m_blob; }
+        const char * bytes() const { return m_blob; }
+
+        const char * begin() const { return m_blob; }
+        const char * end() const { return m_blob + m_size; }
 };
 
 /******************************************************************************/
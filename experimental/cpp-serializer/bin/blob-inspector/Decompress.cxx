@@ -0,0 +1,363 @@
+#include "Decompress.h"
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <zlib.h>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Inflate's output grows by at least this much at a time
+     */
+    constexpr size_t inflateBlock { 4 * 1024 };
+
+    /**
+     * The most a chunk of the Snappy framing format can decode to, so the
+     * most we'll grow the output by for one, whatever it claims
+     */
+    constexpr size_t snappyChunk { 64 * 1024 };
+
+    /**
+     * Setting up an inflater allocates its window, which for a small blob
+     * costs more than inflating it, so each thread keeps one and resets it
+     * between blobs
+     */
+    class Inflater {
+        private :
+            z_stream m_stream;
+
+        public :
+            Inflater() : m_stream { } {
+                if (::inflateInit (&m_stream) != Z_OK) {
+                    throw std::runtime_error ("Failed to initialise inflate");
+                }
+            }
+
+            ~Inflater() {
+                ::inflateEnd (&m_stream);
+            }
+
+            Inflater (const Inflater &) = delete;
+            Inflater & operator = (const Inflater &) = delete;
+
+            z_stream & stream() {
+                ::inflateReset (&m_stream);
+                return m_stream;
+            }
+    };
+
+    /*
+     * CRC-32C (Castagnoli), the checksum the Snappy framing format uses,
+     * computed slicing by 8: table [k] advances a byte's contribution
+     * through k more bytes so eight can be folded in at once
+     */
+    constexpr auto crcTables = [] {
+        std::array<std::array<uint32_t, 256>, 8> rtn { };
+
+        for (uint32_t i { 0 } ; i < 256 ; ++i) {
+            uint32_t crc { i };
+
+            for (int j { 0 } ; j < 8 ; ++j) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78U : crc >> 1;
+            }
+
+            rtn[0][i] = crc;
+        }
+
+        for (size_t k { 1 } ; k < 8 ; ++k) {
+            for (size_t i { 0 } ; i < 256 ; ++i) {
+                auto prev = rtn[k - 1][i];
+                rtn[k][i] = (prev >> 8) ^ rtn[0][prev & 0xff];
+            }
+        }
+
+        return rtn;
+    } ();
+
+    uint32_t
+    crc32c (const char * bytes_, size_t size_) {
+        const auto & t = crcTables;
+        const auto * p = reinterpret_cast<const uint8_t *>(bytes_);
+
+        uint32_t crc { ~0U };
+
+        for ( ; size_ >= 8 ; size_ -= 8, p += 8) {
+            uint32_t lo = crc ^ (p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24);
+            uint32_t hi = p[4] | p[5] << 8 | p[6] << 16 | (uint32_t)p[7] << 24;
+
+            crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff]
+                ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24]
+                ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff]
+                ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        }
+
+        for ( ; size_ ; --size_, ++p) {
+            crc = t[0][(crc ^ *p) & 0xff] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+    /**
+     * Checksums are stored masked so that a checksum of data that itself
+     * contains checksums is still well distributed
+     */
+    uint32_t
+    masked (uint32_t crc_) {
+        return ((crc_ >> 15) | (crc_ << 17)) + 0xa282ead8U;
+    }
+
+    uint32_t
+    le (const uint8_t * bytes_, size_t size_) {
+        uint32_t rtn { 0 };
+
+        for (size_t i { 0 } ; i < size_ ; ++i) {
+            rtn |= static_cast<uint32_t>(bytes_[i]) << (8 * i);
+        }
+
+        return rtn;
+    }
+
+    [[noreturn]] void
+    corrupt (const std::string & what_) {
+        throw std::runtime_error ("Corrupt snappy stream: " + what_);
+    }
+
+    /**
+     * Decode a single block of raw Snappy, that being its uncompressed
+     * length as a varint followed by a run of literals and back references
+     * into what's been decoded so far, appending it to [out_]. Being from
+     * a framed chunk it can't be longer than one.
+     */
+    void
+    snappyBlock (const uint8_t * in_, size_t size_, std::vector<char> & out_) {
+        size_t pos { 0 };
+        size_t length { 0 };
+
+        for (int shift { 0 } ; ; shift += 7) {
+            if (pos == size_ || shift > 28) corrupt ("bad length");
+
+            length |= static_cast<size_t>(in_[pos] & 0x7f) << shift;
+
+            if (!(in_[pos++] & 0x80)) break;
+        }
+
+        if (length > snappyChunk) corrupt ("chunk too long");
+
+        auto base = out_.size();
+        out_.resize (base + length);
+
+        char * dst = out_.data() + base;
+        size_t op { 0 };
+
+        while (pos < size_) {
+            uint8_t tag = in_[pos++];
+            size_t len, offset;
+
+            switch (tag & 3) {
+                case 0 : {
+                    len = tag >> 2;
+
+                    // longer literals put their length in the next 1-4 bytes
+                    if (len >= 60) {
+                        auto extra = len - 59;
+                        if (pos + extra > size_) corrupt ("truncated literal");
+                        len = le (in_ + pos, extra);
+                        pos += extra;
+                    }
+
+                    ++len;
+
+                    if (len > size_ - pos || len > length - op) {
+                        corrupt ("literal overrun");
+                    }
+
+                    std::memcpy (dst + op, in_ + pos, len);
+                    pos += len;
+                    op += len;
+
+                    continue;
+                }
+                case 1 :
+                    if (pos + 1 > size_) corrupt ("truncated copy");
+                    len = 4 + ((tag >> 2) & 0x7);
+                    offset = ((tag >> 5) << 8) | in_[pos];
+                    pos += 1;
+                    break;
+                case 2 :
+                    if (pos + 2 > size_) corrupt ("truncated copy");
+                    len = 1 + (tag >> 2);
+                    offset = le (in_ + pos, 2);
+                    pos += 2;
+                    break;
+                default :
+                    if (pos + 4 > size_) corrupt ("truncated copy");
+                    len = 1 + (tag >> 2);
+                    offset = le (in_ + pos, 4);
+                    pos += 4;
+                    break;
+            }
+
+            if (offset == 0 || offset > op || len > length - op) {
+                corrupt ("bad copy");
+            }
+
+            // copies can overlap what they're producing, that's how runs
+            // are encoded. What's written then repeats every [offset] bytes
+            // so copying from the start of the run the non overlapping part
+            // doubles each time round
+            if (offset >= len) {
+                std::memcpy (dst + op, dst + op - offset, len);
+            } else {
+                for (size_t i { 0 } ; i < len ; ) {
+                    auto n = std::min (len - i, i + offset);
+                    std::memcpy (dst + op + i, dst + op - offset, n);
+                    i += n;
+                }
+            }
+
+            op += len;
+        }
+
+        if (op != length) corrupt ("short block");
+    }
+
+}
+
+/******************************************************************************/
+
+void
+decompress (
+    amqp::amqp_encoding_t encoding_,
+    const char * bytes_,
+    size_t size_,
+    std::vector<char> & out_
+) {
+    switch (encoding_) {
+        case amqp::DEFLATE : zlibInflate (bytes_, size_, out_); break;
+        case amqp::SNAPPY  : snappyDecode (bytes_, size_, out_); break;
+        default :
+            throw std::runtime_error (
+                "Unknown encoding " + std::to_string (encoding_));
+    }
+}
+
+/******************************************************************************/
+
+void
+zlibInflate (const char * bytes_, size_t size_, std::vector<char> & out_) {
+    static thread_local Inflater inflater;
+
+    auto & stream = inflater.stream();
+
+    out_.clear();
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(bytes_));
+    stream.avail_in = static_cast<uInt>(size_);
+
+    // start from a guess at the ratio and grow geometrically from there
+    size_t block { std::max (inflateBlock, size_ * 4) };
+
+    for (;;) {
+        auto have = out_.size();
+        out_.resize (have + block);
+
+        stream.next_out = reinterpret_cast<Bytef *>(out_.data() + have);
+        stream.avail_out = static_cast<uInt>(block);
+
+        auto rc = ::inflate (&stream, Z_NO_FLUSH);
+
+        out_.resize (have + block - stream.avail_out);
+
+        if (rc == Z_STREAM_END) {
+            break;
+        }
+
+        // with fresh space to write to the only reason for no progress
+        // is that we've run out of input
+        if (rc != Z_OK) {
+            throw std::runtime_error (
+                std::string ("Failed to inflate blob: ")
+                    + (stream.msg ? stream.msg : "truncated"));
+        }
+
+        block = out_.size();
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Each chunk of the framing format is a type byte, a 3 byte length and
+ * then that many bytes of data. The stream opens with an identifier chunk
+ * and then has compressed (0x00) or uncompressed (0x01) chunks of data,
+ * each prefixed by the masked checksum of what they decode to. Padding
+ * and the skippable reserved types we ignore.
+ */
+void
+snappyDecode (const char * bytes_, size_t size_, std::vector<char> & out_) {
+    static constexpr char streamId[] = "sNaPpY";
+
+    const auto * in = reinterpret_cast<const uint8_t *>(bytes_);
+    bool identified { false };
+    size_t pos { 0 };
+
+    out_.clear();
+
+    while (pos < size_) {
+        if (size_ - pos < 4) corrupt ("truncated chunk header");
+
+        auto type = in[pos];
+        size_t length = le (in + pos + 1, 3);
+        pos += 4;
+
+        if (size_ - pos < length) corrupt ("truncated chunk");
+
+        const uint8_t * chunk = in + pos;
+        pos += length;
+
+        if (type == 0xff) {
+            if (   length != sizeof (streamId) - 1
+                || std::memcmp (chunk, streamId, length) != 0)
+            {
+                corrupt ("bad stream identifier");
+            }
+
+            identified = true;
+            continue;
+        }
+
+        if (!identified) corrupt ("missing stream identifier");
+
+        if (type == 0x00 || type == 0x01) {
+            if (length < 4) corrupt ("chunk too short");
+
+            auto crc = le (chunk, 4);
+            auto start = out_.size();
+
+            if (type == 0x00) {
+                snappyBlock (chunk + 4, length - 4, out_);
+            } else {
+                if (length - 4 > snappyChunk) corrupt ("chunk too long");
+                out_.insert (out_.end(), chunk + 4, chunk + length);
+            }
+
+            if (masked (crc32c (out_.data() + start, out_.size() - start)) != crc) {
+                corrupt ("checksum mismatch");
+            }
+        } else if (type < 0x80) {
+            corrupt ("unskippable chunk " + std::to_string (type));
+        }
+    }
+
+    if (!identified) corrupt ("missing stream identifier");
+}
+
+/******************************************************************************/
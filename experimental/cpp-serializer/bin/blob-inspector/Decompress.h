@@ -0,0 +1,38 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <vector>
+#include <cstddef>
+
+#include "amqp/AMQPSectionId.h"
+
+/******************************************************************************/
+
+/**
+ * Decompress the body of a Corda blob written with an ENCODING section
+ * into [out_], which is cleared first but keeps its capacity so the same
+ * buffer can be reused from one blob to the next.
+ *
+ *  * DEFLATE is a zlib stream, as written by the JVM's DeflaterOutputStream,
+ *    and is inflated a block at a time straight into [out_]
+ *  * SNAPPY is the Snappy framing format, as written by
+ *    SnappyFramedOutputStream, and is decoded chunk by chunk with each
+ *    chunk's checksum verified as we go
+ *
+ * Throws if the data is corrupt or truncated.
+ */
+void
+decompress (
+    amqp::amqp_encoding_t,
+    const char *,
+    size_t,
+    std::vector<char> & out_);
+
+/******************************************************************************/
+
+void zlibInflate (const char *, size_t, std::vector<char> & out_);
+
+void snappyDecode (const char *, size_t, std::vector<char> & out_);
+
+/******************************************************************************/
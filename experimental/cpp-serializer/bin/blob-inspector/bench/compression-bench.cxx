@@ -0,0 +1,239 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include <zlib.h>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+#include "amqp/AMQPHeader.h"
+
+/******************************************************************************
+ *
+ * Compare loading and inspecting blobs stored uncompressed against the
+ * same blobs DEFLATE and Snappy compressed. Throughput is always reported
+ * against the uncompressed size so the numbers are directly comparable.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    /**
+     * Something with the sort of redundancy a real blob has, repeated
+     * type names and small integers
+     */
+    std::string
+    body (size_t size_) {
+        std::string rtn { static_cast<char>(amqp::DATA_AND_STOP) };
+
+        for (size_t i { 0 } ; rtn.size() < size_ ; ++i) {
+            rtn += "net.corda.core.contracts.Amount<Currency>:" + std::to_string (i % 1000);
+        }
+
+        rtn.resize (size_);
+
+        return rtn;
+    }
+
+    std::string
+    deflated (const std::string & body_) {
+        auto bound = ::compressBound (body_.size());
+        std::string rtn (bound, '\0');
+
+        ::compress (
+            reinterpret_cast<Bytef *>(rtn.data()), &bound,
+            reinterpret_cast<const Bytef *>(body_.data()), body_.size());
+
+        rtn.resize (bound);
+
+        return rtn;
+    }
+
+    /**
+     * A greedy Snappy encoder, nowhere near as good as the real thing
+     * but enough to give the decoder literals and copies to work through
+     */
+    void
+    snappyBlock (const char * in_, size_t size_, std::string & out_) {
+        for (size_t n { size_ } ; ; n >>= 7) {
+            out_.push_back (static_cast<char>((n & 0x7f) | (n >= 0x80 ? 0x80 : 0)));
+            if (n < 0x80) break;
+        }
+
+        auto literal = [&](size_t from_, size_t to_) {
+            while (from_ < to_) {
+                auto len = std::min<size_t> (to_ - from_, 60);
+                out_.push_back (static_cast<char>((len - 1) << 2));
+                out_.append (in_ + from_, len);
+                from_ += len;
+            }
+        };
+
+        std::unordered_map<uint32_t, size_t> table;
+        size_t lit { 0 };
+        size_t i { 0 };
+
+        while (i + 4 <= size_) {
+            uint32_t key;
+            std::memcpy (&key, in_ + i, 4);
+
+            auto [it, inserted] = table.emplace (key, i);
+            auto from = it->second;
+            it->second = i;
+
+            if (inserted || i - from > 0xffff) {
+                ++i;
+                continue;
+            }
+
+            size_t len { 4 };
+
+            while (i + len < size_ && len < 64 && in_[from + len] == in_[i + len]) {
+                ++len;
+            }
+
+            literal (lit, i);
+
+            auto offset = i - from;
+            out_.push_back (static_cast<char>(2 | ((len - 1) << 2)));
+            out_.push_back (static_cast<char>(offset & 0xff));
+            out_.push_back (static_cast<char>(offset >> 8));
+
+            i += len;
+            lit = i;
+        }
+
+        literal (lit, size_);
+    }
+
+    uint32_t
+    crc32c (const char * bytes_, size_t size_) {
+        uint32_t crc { ~0U };
+
+        for (size_t i { 0 } ; i < size_ ; ++i) {
+            crc ^= static_cast<uint8_t>(bytes_[i]);
+
+            for (int j { 0 } ; j < 8 ; ++j) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78U : crc >> 1;
+            }
+        }
+
+        return ~crc;
+    }
+
+    std::string
+    snappied (const std::string & body_) {
+        std::string rtn { "\xff\x06\x00\x00sNaPpY", 10 };
+
+        for (size_t i { 0 } ; i < body_.size() ; i += 65536) {
+            auto len = std::min<size_t> (body_.size() - i, 65536);
+
+            auto crc = crc32c (body_.data() + i, len);
+            crc = ((crc >> 15) | (crc << 17)) + 0xa282ead8U;
+
+            std::string chunk (reinterpret_cast<const char *>(&crc), 4);
+            snappyBlock (body_.data() + i, len, chunk);
+
+            rtn.push_back (0x00);
+            rtn.push_back (static_cast<char>(chunk.size() & 0xff));
+            rtn.push_back (static_cast<char>((chunk.size() >> 8) & 0xff));
+            rtn.push_back (static_cast<char>(chunk.size() >> 16));
+            rtn.append (chunk);
+        }
+
+        return rtn;
+    }
+
+    std::vector<char>
+    blob (const std::string & body_, int encoding_) {
+        std::vector<char> rtn (amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end());
+
+        if (encoding_ < 0) {
+            rtn.insert (rtn.end(), body_.begin(), body_.end());
+        } else {
+            rtn.push_back (amqp::ENCODING);
+            rtn.push_back (static_cast<char>(encoding_));
+
+            auto compressed = encoding_ == amqp::DEFLATE
+                ? deflated (body_)
+                : snappied (body_);
+
+            rtn.insert (rtn.end(), compressed.begin(), compressed.end());
+        }
+
+        return rtn;
+    }
+
+    /**
+     * Just getting the bytes, and so for compressed blobs decompressing them
+     */
+    void
+    load (benchmark::State & state_, int encoding_) {
+        auto bytes = blob (body (state_.range (0)), encoding_);
+
+        for (auto _ : state_) {
+            CordaBytes cb (bytes.data(), bytes.size());
+            benchmark::DoNotOptimize (cb.bytes());
+        }
+
+        state_.SetBytesProcessed (state_.iterations() * state_.range (0));
+        state_.counters["ratio"] = static_cast<double>(state_.range (0)) / bytes.size();
+    }
+
+    /**
+     * End to end, decompressing a real blob and writing it out as JSON
+     */
+    void
+    inspect (benchmark::State & state_, const std::string & suffix_) {
+        std::ifstream file {
+            std::string (TEST_FILES) + "__i_LMis_l__" + suffix_,
+            std::ios::in | std::ios::binary };
+
+        std::vector<char> bytes {
+            std::istreambuf_iterator<char> (file),
+            std::istreambuf_iterator<char>() };
+
+        size_t size { 0 };
+
+        for (auto _ : state_) {
+            CordaBytes cb (bytes.data(), bytes.size());
+            size = cb.size();
+
+            benchmark::DoNotOptimize (BlobInspector (cb).json());
+        }
+
+        state_.SetBytesProcessed (state_.iterations() * size);
+    }
+
+}
+
+/******************************************************************************/
+
+static void loadPlain (benchmark::State & state_) { load (state_, -1); }
+static void loadDeflate (benchmark::State & state_) { load (state_, amqp::DEFLATE); }
+static void loadSnappy (benchmark::State & state_) { load (state_, amqp::SNAPPY); }
+
+static void inspectPlain (benchmark::State & state_) { inspect (state_, ""); }
+static void inspectDeflate (benchmark::State & state_) { inspect (state_, ".deflate"); }
+static void inspectSnappy (benchmark::State & state_) { inspect (state_, ".snappy"); }
+
+/******************************************************************************/
+
+BENCHMARK (loadPlain)->RangeMultiplier (16)->Range (1 << 10, 1 << 24); // NOLINT
+BENCHMARK (loadDeflate)->RangeMultiplier (16)->Range (1 << 10, 1 << 24); // NOLINT
+BENCHMARK (loadSnappy)->RangeMultiplier (16)->Range (1 << 10, 1 << 24); // NOLINT
+
+BENCHMARK (inspectPlain); // NOLINT
+BENCHMARK (inspectDeflate); // NOLINT
+BENCHMARK (inspectSnappy); // NOLINT
+
+BENCHMARK_MAIN(); // NOLINT
+
+/******************************************************************************/
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <numeric>
+#include <fstream>
+#include <cstdio>
+#include <vector>
+
+#include "CordaBytes.h"
+#include "amqp/AMQPHeader.h"
+
+/******************************************************************************
+ *
+ * Compare the cost of getting a blob into memory via mmap against reading
+ * it onto the heap and against handing over a buffer the caller already
+ * owns. Each iteration touches every byte so the mapped pages are actually
+ * faulted in rather than just reserved.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    std::string
+    blob (size_t size_) {
+        std::string path { "corda-bytes-bench-" + std::to_string (size_) };
+        std::ofstream file { path, std::ios::out | std::ios::binary };
+
+        file.write (amqp::AMQP_HEADER.data(), amqp::AMQP_HEADER.size());
+        file.put (amqp::DATA_AND_STOP);
+
+        std::vector<char> body (size_);
+        std::iota (body.begin(), body.end(), 0);
+        file.write (body.data(), body.size());
+
+        return path;
+    }
+
+    uint64_t
+    touch (const CordaBytes & cb_) {
+        return std::accumulate (
+            cb_.begin(), cb_.end(), uint64_t { 0 },
+            [](uint64_t sum_, char c_) { return sum_ + (uint8_t)c_; });
+    }
+
+    void
+    fromFile (benchmark::State & state_, CordaBytes::Mode mode_) {
+        auto path { blob (state_.range (0)) };
+
+        for (auto _ : state_) {
+            CordaBytes cb (path, mode_);
+            benchmark::DoNotOptimize (touch (cb));
+        }
+
+        state_.SetBytesProcessed (state_.iterations() * state_.range (0));
+        std::remove (path.c_str());
+    }
+
+}
+
+/******************************************************************************/
+
+static void
+map (benchmark::State & state_) {
+    fromFile (state_, CordaBytes::Mode::map);
+}
+
+/******************************************************************************/
+
+static void
+read (benchmark::State & state_) {
+    fromFile (state_, CordaBytes::Mode::read);
+}
+
+/******************************************************************************/
+
+static void
+callerOwned (benchmark::State & state_) {
+    auto path { blob (state_.range (0)) };
+
+    std::ifstream file { path, std::ios::in | std::ios::binary };
+    std::vector<char> buffer {
+        std::istreambuf_iterator<char> (file),
+        std::istreambuf_iterator<char>() };
+
+    for (auto _ : state_) {
+        CordaBytes cb (buffer.data(), buffer.size());
+        benchmark::DoNotOptimize (touch (cb));
+    }
+
+    state_.SetBytesProcessed (state_.iterations() * state_.range (0));
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+BENCHMARK (map)->RangeMultiplier (16)->Range (1 << 10, 1 << 26); // NOLINT
+BENCHMARK (read)->RangeMultiplier (16)->Range (1 << 10, 1 << 26); // NOLINT
+BENCHMARK (callerOwned)->RangeMultiplier (16)->Range (1 << 10, 1 << 26); // NOLINT
+
+BENCHMARK_MAIN(); // NOLINT
+
+/******************************************************************************/
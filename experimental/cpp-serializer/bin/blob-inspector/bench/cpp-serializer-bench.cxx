@@ -0,0 +1,413 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+#include "amqp/AMQPHeader.h"
+#include "amqp/CompositeFactory.h"
+#include "amqp/reader/Arena.h"
+#include "amqp/reader/References.h"
+#include "amqp/writer/JsonWriter.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+
+#include "Batch.h"
+#include "CordaBytes.h"
+
+/******************************************************************************
+ *
+ * Time each phase of decoding a blob on its own
+ *
+ *  header    validating the Corda header and finding the body
+ *  decode    pn_data_decode of the body
+ *  envelope  building the envelope, and with it the schema
+ *  process   building the readers for that schema (CompositeFactory::process)
+ *  dump      building the tree of values for the blob
+ *  string    rendering that tree with IValue::dump
+ *  json      streaming the blob as JSON
+ *
+ * over every blob in test-files and over _Li_ with its list scaled up.
+ * Each phase is timed with everything before it already done so the
+ * numbers can be compared, and tracked, phase by phase.
+ *
+ * Results are written as JSON unless another --benchmark_format is asked
+ * for.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal;
+
+    /**
+     * How many bytes the AMQP encoded value at [p_] takes up, including
+     * its constructor
+     */
+    size_t
+    skip (const uint8_t * p_) {
+        auto be32 = [](const uint8_t * b_) {
+            return (size_t)b_[0] << 24 | b_[1] << 16 | b_[2] << 8 | b_[3];
+        };
+
+        if (p_[0] == 0x00) {
+            auto descriptor = skip (p_ + 1);
+            return 1 + descriptor + skip (p_ + 1 + descriptor);
+        }
+
+        switch (p_[0] >> 4) {
+            case 0x4 : return 1;
+            case 0x5 : return 2;
+            case 0x6 : return 3;
+            case 0x7 : return 5;
+            case 0x8 : return 9;
+            case 0x9 : return 17;
+            case 0xa : case 0xc : case 0xe : return 2 + p_[1];
+            case 0xb : case 0xd : case 0xf : return 5 + be32 (p_ + 1);
+            default :
+                throw std::runtime_error ("Unknown constructor");
+        }
+    }
+
+    void
+    be32 (std::vector<char> & out_, uint32_t val_) {
+        for (int shift { 24 } ; shift >= 0 ; shift -= 8) {
+            out_.push_back (static_cast<char>(val_ >> shift));
+        }
+    }
+
+    /**
+     * A list32 holding [count_] elements that take up [size_] bytes
+     */
+    void
+    list32 (std::vector<char> & out_, size_t size_, size_t count_) {
+        out_.push_back (static_cast<char>(0xd0));
+        be32 (out_, static_cast<uint32_t>(size_ + 4));
+        be32 (out_, static_cast<uint32_t>(count_));
+    }
+
+    /**
+     * Where the first element of the list at [p_] starts
+     */
+    const uint8_t *
+    first (const uint8_t * p_) {
+        return p_ + (p_[0] == 0xc0 ? 3 : 9);
+    }
+
+    /**
+     * _Li_ is a class with a single property that's a list of ints. Keep its
+     * schema and the descriptors of the class and the list but give the
+     * list [elements_] ints
+     */
+    std::vector<char>
+    scaled (const std::vector<char> & li_, size_t elements_) {
+        const auto * bytes = reinterpret_cast<const uint8_t *>(li_.data());
+
+        // the envelope, 0x00 then its descriptor then the list of the
+        // blob, schema and whatever else follows them
+        const auto * envelope = bytes + amqp::AMQP_HEADER.size() + 1;
+        const auto * list = envelope + 1 + skip (envelope + 1);
+        const auto * blob = first (list);
+        const auto * rest = blob + skip (blob);
+        const auto * end = envelope + skip (envelope);
+
+        // the blob itself, and the list inside it
+        const auto * outer = blob + 1;
+        const auto * property = first (outer + skip (outer));
+        const auto * inner = property + 1;
+
+        std::vector<char> ints;
+        for (size_t i { 0 } ; i < elements_ ; ++i) {
+            ints.push_back (0x71);
+            be32 (ints, static_cast<uint32_t>(i));
+        }
+
+        std::vector<char> value { 0x00 };
+        value.insert (value.end(), inner, inner + skip (inner));
+        list32 (value, ints.size(), elements_);
+        value.insert (value.end(), ints.begin(), ints.end());
+
+        std::vector<char> newBlob { 0x00 };
+        newBlob.insert (newBlob.end(), outer, outer + skip (outer));
+        list32 (newBlob, value.size(), 1);
+        newBlob.insert (newBlob.end(), value.begin(), value.end());
+
+        std::vector<char> rtn (bytes, envelope + 1);
+        rtn.insert (rtn.end(), envelope + 1, list);
+
+        list32 (rtn, newBlob.size() + (end - rest), list[0] == 0xc0 ? list[2] : list[8]);
+        rtn.insert (rtn.end(), newBlob.begin(), newBlob.end());
+        rtn.insert (rtn.end(), rest, end);
+
+        return rtn;
+    }
+
+    std::vector<char>
+    read (const std::string & file_) {
+        std::ifstream file { file_, std::ios::in | std::ios::binary };
+
+        return {
+            std::istreambuf_iterator<char> (file),
+            std::istreambuf_iterator<char>() };
+    }
+
+    /**
+     * A blob and everything the phases need already done to it
+     */
+    class Input {
+        private :
+            std::vector<char> m_bytes;
+            std::unique_ptr<CordaBytes> m_cb;
+            pn_data_t * m_data;
+            uPtr<schema::Envelope> m_envelope;
+            sPtr<CompositeFactory> m_factory;
+
+        public :
+            explicit Input (std::vector<char> bytes_)
+                : m_bytes (std::move (bytes_))
+                , m_cb (std::make_unique<CordaBytes> (m_bytes.data(), m_bytes.size()))
+                , m_data (pn_data (m_cb->size()))
+            {
+                pn_data_decode (m_data, m_cb->bytes(), m_cb->size());
+                m_envelope = envelope();
+
+                m_factory = std::make_shared<CompositeFactory>();
+                m_factory->process (schema());
+
+                // make sure we can read it at all before timing anything
+                reader::Arena arena;
+                reader::Arena::Scope scope (arena);
+                reader::References references;
+                reader::References::Scope refs (references);
+
+                blob ([this](auto & reader_, auto * data_) {
+                    reader_.dump ("Parsed", data_, schema()).release();
+                });
+            }
+
+            ~Input() {
+                pn_data_free (m_data);
+            }
+
+            Input (const Input &) = delete;
+            Input & operator = (const Input &) = delete;
+
+            const std::vector<char> & bytes() const { return m_bytes; }
+            const CordaBytes & cb() const { return *m_cb; }
+
+            const schema::Schema & schema() const {
+                return dynamic_cast<const schema::Schema &> (m_envelope->schema());
+            }
+
+            uPtr<schema::Envelope>
+            envelope() const {
+                pn_data_rewind (m_data);
+                pn_data_next (m_data);
+
+                proton::auto_enter p (m_data);
+
+                const auto & descriptor = AMQPDescriptorRegistory.at (
+                        pn_data_get_ulong (m_data));
+
+                return uPtr<schema::Envelope> (
+                    dynamic_cast<schema::Envelope *> (
+                        descriptor->build (m_data).release()));
+            }
+
+            /**
+             * Hand [f_] the reader for the blob and the cursor positioned
+             * on the blob
+             */
+            template<class F>
+            void
+            blob (F f_) const {
+                pn_data_rewind (m_data);
+                pn_data_next (m_data);
+
+                proton::auto_enter p (m_data);
+                pn_data_next (m_data);
+                proton::auto_enter p2 (m_data);
+
+                f_ (*m_factory->byDescriptor (m_envelope->descriptor()), m_data);
+            }
+
+            sPtr<const reader::Program> program() const {
+                return m_factory->program();
+            }
+
+            size_t entry() const {
+                return program()->entry (m_envelope->descriptor());
+            }
+    };
+
+    using Phase = void (*)(benchmark::State &, const Input &);
+
+    void
+    header (benchmark::State & state_, const Input & input_) {
+        for (auto _ : state_) {
+            CordaBytes cb (input_.bytes().data(), input_.bytes().size());
+            benchmark::DoNotOptimize (cb.bytes());
+        }
+    }
+
+    void
+    decode (benchmark::State & state_, const Input & input_) {
+        auto data = pn_data (input_.cb().size());
+
+        for (auto _ : state_) {
+            benchmark::DoNotOptimize (
+                pn_data_decode (data, input_.cb().bytes(), input_.cb().size()));
+        }
+
+        pn_data_free (data);
+    }
+
+    void
+    envelope (benchmark::State & state_, const Input & input_) {
+        for (auto _ : state_) {
+            benchmark::DoNotOptimize (input_.envelope());
+        }
+    }
+
+    void
+    process (benchmark::State & state_, const Input & input_) {
+        for (auto _ : state_) {
+            CompositeFactory factory;
+            factory.process (input_.schema());
+            benchmark::DoNotOptimize (factory);
+        }
+    }
+
+    void
+    dump (benchmark::State & state_, const Input & input_) {
+        reader::Arena arena;
+        reader::References references;
+
+        for (auto _ : state_) {
+            reader::Arena::Scope scope (arena);
+            reader::References::Scope refs (references);
+
+            input_.blob ([&](auto & reader_, auto * data_) {
+                benchmark::DoNotOptimize (
+                    reader_.dump ("Parsed", data_, input_.schema()).release());
+            });
+
+            arena.reset();
+            references.clear();
+        }
+    }
+
+    void
+    string (benchmark::State & state_, const Input & input_) {
+        reader::Arena arena;
+        reader::Arena::Scope scope (arena);
+        reader::References references;
+        reader::References::Scope refs (references);
+
+        uPtr<amqp::reader::IValue> value;
+
+        input_.blob ([&](auto & reader_, auto * data_) {
+            value = reader_.dump ("Parsed", data_, input_.schema());
+        });
+
+        for (auto _ : state_) {
+            benchmark::DoNotOptimize (value->dump());
+        }
+
+        value.release();
+    }
+
+    void
+    json (benchmark::State & state_, const Input & input_) {
+        auto entry = input_.entry();
+        auto program = input_.program();
+
+        for (auto _ : state_) {
+            writer::JsonWriter writer;
+
+            input_.blob ([&](auto &, auto * data_) {
+                program->run (entry, data_, writer);
+            });
+
+            benchmark::DoNotOptimize (writer.take());
+        }
+    }
+
+    /**
+     * Every phase over [input_], reporting throughput in terms of the size
+     * of the blob
+     */
+    void
+    phases (const std::string & name_, std::shared_ptr<Input> input_) {
+        static const std::vector<std::pair<const char *, Phase>> all {
+            { "header", header },
+            { "decode", decode },
+            { "envelope", envelope },
+            { "process", process },
+            { "dump", dump },
+            { "string", string },
+            { "json", json }
+        };
+
+        for (const auto & [phase, f] : all) {
+            benchmark::RegisterBenchmark (
+                (std::string (phase) + "/" + name_).c_str(),
+                [input_, f = f](benchmark::State & state_) {
+                    f (state_, *input_);
+
+                    state_.SetBytesProcessed (
+                        state_.iterations() * input_->bytes().size());
+                });
+        }
+    }
+
+}
+
+/******************************************************************************/
+
+int
+main (int argc, char ** argv) {
+    const std::string files { TEST_FILES };
+
+    for (const auto & file : Batch::expand (files)) {
+        try {
+            phases (file.substr (files.size()), std::make_shared<Input> (read (file)));
+        } catch (const std::exception & e) {
+            // some we know we can't read
+            std::cerr << "skipping " << file << " : " << e.what() << std::endl;
+        }
+    }
+
+    auto li = read (files + "_Li_");
+
+    for (size_t n : { 1 << 4, 1 << 8, 1 << 12, 1 << 16 }) {
+        phases ("_Li_x" + std::to_string (n), std::make_shared<Input> (scaled (li, n)));
+    }
+
+    std::string json { "--benchmark_format=json" };
+    std::vector<char *> args (argv, argv + argc);
+
+    if (std::none_of (args.begin(), args.end(), [](const char * arg_) {
+            return std::strncmp (arg_, "--benchmark_format", 18) == 0; }))
+    {
+        args.insert (args.begin() + 1, json.data());
+    }
+
+    int n = static_cast<int>(args.size());
+    benchmark::Initialize (&n, args.data());
+    benchmark::RunSpecifiedBenchmarks();
+
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************/
@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <random>
+
+#include "amqp/writer/Escape.h"
+
+/******************************************************************************
+ *
+ * UTF-8 validation and JSON escaping of string values with each kernel.
+ *
+ * Payloads are 4KB of either ASCII with the occasional quote or newline,
+ * as most names and identifiers are, or mostly two, three and four byte
+ * characters, as a memo in another script would be. Arguments are the
+ * kernel, 0 scalar, 1 SSE4.2, 2 AVX2, and whether the payload's ASCII.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal::writer;
+
+    std::string
+    payload (bool ascii_) {
+        std::mt19937 rng { 1234 };
+        std::string rtn;
+
+        const std::string multibyte[] = { // NOLINT
+            "\xc3\xa9", "\xd0\x96", "\xe2\x82\xac", "\xe4\xb8\xad", "\xf0\x9f\x98\x80", " "
+        };
+
+        while (rtn.size() < 4096) {
+            if (ascii_) {
+                auto r = rng() % 64;
+                rtn += r == 0 ? '"' : r == 1 ? '\n' : static_cast<char> ('a' + r % 26);
+            } else {
+                rtn += multibyte[rng() % std::size (multibyte)];
+            }
+        }
+
+        return rtn;
+    }
+
+    bool
+    kernel (benchmark::State & state_) {
+        auto k = static_cast<Kernel> (state_.range (0));
+
+        if (use (k) != k) {
+            state_.SkipWithError ("kernel not supported by this CPU");
+            return false;
+        }
+
+        return true;
+    }
+
+}
+
+/******************************************************************************/
+
+static void
+validate (benchmark::State & state_) {
+    if (!kernel (state_)) {
+        return;
+    }
+
+    auto str = payload (state_.range (1));
+
+    for (auto _ : state_) {
+        benchmark::DoNotOptimize (validUtf8 (str));
+    }
+
+    state_.SetBytesProcessed (state_.iterations() * str.size());
+}
+
+/******************************************************************************/
+
+/**
+ * Validating and then escaping into a buffer that's reused, as the JSON
+ * writer's is
+ */
+static void
+escape (benchmark::State & state_) {
+    if (!kernel (state_)) {
+        return;
+    }
+
+    auto str = payload (state_.range (1));
+    std::string out;
+    out.reserve (str.size() * 2);
+
+    for (auto _ : state_) {
+        out.clear();
+        escape (out, str);
+        benchmark::DoNotOptimize (out.data());
+    }
+
+    state_.SetBytesProcessed (state_.iterations() * str.size());
+}
+
+/******************************************************************************/
+
+BENCHMARK (validate)->ArgsProduct ({ { 0, 1, 2 }, { 1, 0 } }); // NOLINT
+BENCHMARK (escape)->ArgsProduct ({ { 0, 1, 2 }, { 1, 0 } }); // NOLINT
+
+BENCHMARK_MAIN(); // NOLINT
+
+/******************************************************************************/
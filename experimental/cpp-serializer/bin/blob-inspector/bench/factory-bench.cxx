@@ -0,0 +1,180 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+#include "amqp/CompositeFactory.h"
+#include "amqp/writer/JsonWriter.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+
+#include "CordaBytes.h"
+
+/******************************************************************************
+ *
+ * One CompositeFactory shared by 1 to N threads, N being the number of
+ * cores, for the three things they do with it
+ *
+ *  lookup    the reader and program entry for a blob's descriptor
+ *  process   a schema the factory already has, which is every blob after
+ *            the first with that schema
+ *  json      running the program for __i_LMis_l__, each thread with its
+ *            own cursor and writer
+ *
+ * None of them take a lock so throughput per thread should hold flat as
+ * threads are added.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal;
+
+    /**
+     * __i_LMis_l__ decoded, and a factory that's processed its schema
+     */
+    class Shared {
+        private :
+            std::vector<char> m_bytes;
+            CordaBytes m_cb;
+            pn_data_t * m_data;
+            uPtr<schema::Envelope> m_envelope;
+
+        public :
+            CompositeFactory factory;
+
+            Shared()
+                : m_bytes { read (TEST_FILES "__i_LMis_l__") }
+                , m_cb { m_bytes.data(), m_bytes.size() }
+                , m_data { pn_data (0) }
+            {
+                pn_data_decode (m_data, m_cb.bytes(), m_cb.size());
+                pn_data_rewind (m_data);
+                pn_data_next (m_data);
+
+                proton::auto_enter p (m_data);
+
+                m_envelope.reset (dynamic_cast<schema::Envelope *> (
+                    AMQPDescriptorRegistory[pn_data_get_ulong (m_data)]
+                        ->build (m_data).release()));
+
+                factory.process (schema());
+            }
+
+            ~Shared() {
+                pn_data_free (m_data);
+            }
+
+            static std::vector<char>
+            read (const std::string & file_) {
+                std::ifstream file { file_, std::ios::in | std::ios::binary };
+
+                return {
+                    std::istreambuf_iterator<char> (file),
+                    std::istreambuf_iterator<char>() };
+            }
+
+            const CordaBytes & cb() const { return m_cb; }
+
+            const std::string & descriptor() const {
+                return m_envelope->descriptor();
+            }
+
+            const schema::Schema & schema() const {
+                return dynamic_cast<const schema::Schema &> (m_envelope->schema());
+            }
+    };
+
+    Shared &
+    shared() {
+        static Shared instance;
+
+        return instance;
+    }
+
+}
+
+/******************************************************************************/
+
+static void
+lookup (benchmark::State & state_) {
+    auto & s = shared();
+
+    for (auto _ : state_) {
+        benchmark::DoNotOptimize (s.factory.byDescriptor (s.descriptor()));
+        benchmark::DoNotOptimize (s.factory.program()->entry (s.descriptor()));
+    }
+
+    state_.SetItemsProcessed (state_.iterations());
+}
+
+/******************************************************************************/
+
+static void
+process (benchmark::State & state_) {
+    auto & s = shared();
+
+    for (auto _ : state_) {
+        s.factory.process (s.schema());
+    }
+
+    state_.SetItemsProcessed (state_.iterations());
+}
+
+/******************************************************************************/
+
+static void
+json (benchmark::State & state_) {
+    auto & s = shared();
+
+    auto data = pn_data (0);
+    pn_data_decode (data, s.cb().bytes(), s.cb().size());
+
+    for (auto _ : state_) {
+        pn_data_rewind (data);
+        pn_data_next (data);
+
+        writer::JsonWriter writer;
+
+        {
+            proton::auto_enter p (data);
+            pn_data_next (data);
+            proton::auto_enter p2 (data);
+
+            auto program = s.factory.program();
+            program->run (program->entry (s.descriptor()), data, writer);
+        }
+
+        benchmark::DoNotOptimize (writer.take());
+    }
+
+    pn_data_free (data);
+
+    state_.SetBytesProcessed (state_.iterations() * s.cb().size());
+}
+
+/******************************************************************************/
+
+namespace {
+
+    const int cores = static_cast<int> (
+            std::max (1U, std::thread::hardware_concurrency()));
+
+}
+
+BENCHMARK (lookup)->ThreadRange (1, cores)->UseRealTime(); // NOLINT
+BENCHMARK (process)->ThreadRange (1, cores)->UseRealTime(); // NOLINT
+BENCHMARK (json)->ThreadRange (1, cores)->UseRealTime(); // NOLINT
+
+BENCHMARK_MAIN(); // NOLINT
+
+/******************************************************************************/
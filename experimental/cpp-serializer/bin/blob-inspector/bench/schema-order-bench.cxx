@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <list>
+#include <string>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+#include "types.h"
+
+#include "amqp/schema/OrderedTypeNotations.h"
+#include "amqp/schema/field-types/Field.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/described-types/Descriptor.h"
+
+/******************************************************************************
+ *
+ * How ordering the types of a schema scales with the number of types.
+ *
+ * The schemas are synthetic, each type a class with a couple of primitive
+ * properties and up to four properties whose types are other classes in
+ * the schema, inserted in a random order as nothing about the order of a
+ * real schema can be relied on. Everything is seeded so every run orders
+ * the same schemas.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal;
+
+    std::string
+    typeName (size_t i_) {
+        return "net.corda.bench.Type" + std::to_string (i_);
+    }
+
+    /**
+     * Type [i] only refers to types with a lower index so there are no
+     * cycles, but otherwise anything goes. They're built in the order
+     * they're to be inserted, as they would be decoding a schema.
+     */
+    std::vector<uPtr<schema::AMQPTypeNotation>>
+    types (size_t n_) {
+        std::mt19937 rng { 1234 };
+        std::vector<uPtr<schema::AMQPTypeNotation>> rtn;
+        std::vector<size_t> order (n_);
+
+        std::iota (order.begin(), order.end(), 0);
+        std::shuffle (order.begin(), order.end(), rng);
+
+        for (auto i : order) {
+            std::vector<uPtr<schema::Field>> fields;
+
+            fields.emplace_back (schema::Field::make (
+                "a", "int", { }, "", "", true, false));
+
+            fields.emplace_back (schema::Field::make (
+                "b", "string", { }, "", "", false, false));
+
+            for (size_t f { 0 }, refs = i ? rng() % 5 : 0 ; f < refs ; ++f) {
+                fields.emplace_back (schema::Field::make (
+                    "c" + std::to_string (f), typeName (rng() % i), { }, "", "",
+                    false, false));
+            }
+
+            rtn.emplace_back (std::make_unique<schema::Composite> (
+                typeName (i), "", std::list<std::string> { },
+                std::make_unique<schema::Descriptor> (
+                    "net.corda:bench" + std::to_string (i)),
+                std::move (fields)));
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Inserting every type and then walking the levels, which is when they're
+ * ordered. Building the types is left out of the timing.
+ */
+static void
+order (benchmark::State & state_) {
+    const auto n { static_cast<size_t>(state_.range (0)) };
+
+    for (auto _ : state_) {
+        state_.PauseTiming();
+        auto schema = types (n);
+        state_.ResumeTiming();
+
+        schema::OrderedTypeNotations<schema::AMQPTypeNotation> otn;
+
+        for (auto & type : schema) {
+            otn.insert (std::move (type));
+        }
+
+        size_t levels { 0 };
+        for (auto i { otn.begin() } ; i != otn.end() ; ++i) {
+            ++levels;
+        }
+
+        benchmark::DoNotOptimize (levels);
+
+        state_.PauseTiming();
+        otn = { };
+        state_.ResumeTiming();
+    }
+
+    state_.SetItemsProcessed (state_.iterations() * state_.range (0));
+}
+
+/******************************************************************************/
+
+BENCHMARK (order) // NOLINT
+    ->Arg (10)->Arg (50)->Arg (100)->Arg (500)->Arg (1000)->Arg (5000)
+    ->Unit (benchmark::kMicrosecond);
+
+BENCHMARK_MAIN(); // NOLINT
+
+/******************************************************************************/
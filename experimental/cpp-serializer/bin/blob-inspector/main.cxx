@@ -2,6 +2,9 @@
 #include <iomanip>
 #include <fstream>
 #include <cstddef>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 #include <assert.h>
 #include <string.h>
@@ -19,33 +22,247 @@
 
 #include "amqp/schema/described-types/Envelope.h"
 #include "amqp/CompositeFactory.h"
+#include "amqp/writer/JsonWriter.h"
 #include "CordaBytes.h"
 #include "BlobInspector.h"
+#include "BlobStream.h"
+#include "Batch.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    usage (const char * name_) {
+        std::cerr
+            << "usage: " << name_ << " [--json] [--select paths] <blob>" << std::endl
+            << "       " << name_ << " [--json] [--select paths] [-j workers] "
+            << "[--ordered] <blob|directory|glob|@list> ..." << std::endl
+            << "       " << name_ << " [--json] [--select paths] [-j workers] "
+            << "[--ordered] --stream <file|-> ..." << std::endl
+            << std::endl
+            << "  --select a.b,c[3]  write as JSON only the named properties, "
+            << "elements" << std::endl
+            << "                     and map entries, also as JSON Pointers "
+            << "/a/b,/c/3" << std::endl
+            << "  --evolve-to blob   read every blob as the versions of its "
+            << "types in" << std::endl
+            << "                     this blob's schema, its enums' "
+            << "constants as it names them" << std::endl;
+    }
+
+    /**
+     * Every blob read from now on is read as the versions of its types in
+     * [file_]'s schema
+     */
+    bool
+    target (const char * file_) {
+        try {
+            CordaBytes cb (file_);
+            BlobInspector (cb, false).target();
+        } catch (const std::exception & e) {
+            std::cerr << file_ << ": " << e.what() << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    using amqp::internal::reader::Projection;
+
+    int
+    single (const char * file_, bool json_, const Projection & projection_) {
+        struct stat results { };
+
+        if (stat(file_, &results) != 0) {
+            return EXIT_FAILURE;
+        }
+
+        CordaBytes cb (file_);
+
+        if (cb.encoding() == amqp::DATA_AND_STOP) {
+            BlobInspector blobInspector (cb);
+
+            if (json_) {
+                // straight out to stdout rather than via a string
+                amqp::internal::writer::JsonWriter writer (stdout);
+
+                try {
+                    blobInspector.write (writer, projection_);
+                } catch (const std::exception & e) {
+                    // a projection that doesn't fit the blob
+                    std::cerr << e.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                writer.flush();
+                std::cout << std::endl;
+            } else {
+                auto val = blobInspector.dump();
+                std::cout << val << std::endl;
+            }
+        } else {
+            std::cerr << "BAD ENCODING " << cb.encoding() << " != "
+                << amqp::DATA_AND_STOP << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    /**
+     * Each result is written as "file : output", failures go to stderr
+     * and the aggregate throughput is reported there once we're done
+     */
+    int
+    batch (
+        std::vector<std::string> files_,
+        size_t workers_,
+        bool ordered_,
+        bool json_,
+        const Projection & projection_
+    ) {
+        Batch batch (std::move (files_), workers_, ordered_, json_);
+
+        if (!projection_.all()) {
+            batch.select (projection_);
+        }
+
+        batch.run ([](const Batch::Result & result_) {
+            (result_.ok ? std::cout : std::cerr)
+                << result_.file << " : " << result_.output << "\n";
+        });
+
+        std::cout << std::flush;
+        std::cerr << batch.throughput() << std::endl;
+
+        return batch.failures() ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    /**
+     * As with a batch, but each of [streams_] is a file of blobs written
+     * one after another, "-" being stdin. Each result is written as
+     * "stream#index : output"
+     */
+    int
+    stream (
+        const std::vector<std::string> & streams_,
+        size_t workers_,
+        bool ordered_,
+        bool json_,
+        const Projection & projection_
+    ) {
+        size_t failures { 0 };
+
+        for (const auto & file : streams_) {
+            Batch batch ({ }, workers_, ordered_, json_);
+
+            if (!projection_.all()) {
+                batch.select (projection_);
+            }
+
+            try {
+                BlobStream stream (file);
+
+                batch.run (stream, [](const Batch::Result & result_) {
+                    (result_.ok ? std::cout : std::cerr)
+                        << result_.file << " : " << result_.output << "\n";
+                });
+            } catch (const std::exception & e) {
+                std::cerr << e.what() << std::endl;
+                ++failures;
+                continue;
+            }
+
+            std::cout << std::flush;
+            std::cerr << file << ": " << batch.throughput() << std::endl;
+
+            failures += batch.failures();
+        }
+
+        return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+}
 
 /******************************************************************************/
 
 int
 main (int argc, char **argv) {
-    struct stat results { };
+    size_t workers { std::max (1U, std::thread::hardware_concurrency()) };
+    bool ordered { false };
+    bool json { false };
+    bool isBatch { false };
+    bool isStream { false };
+    Projection projection;
+    std::vector<std::string> args;
+
+    for (int i { 1 } ; i < argc ; ++i) {
+        std::string arg { argv[i] };
+
+        if (arg == "-j" && i + 1 < argc) {
+            workers = std::strtoul (argv[++i], nullptr, 10);
+            isBatch = true;
+        } else if (arg == "--ordered") {
+            ordered = true;
+            isBatch = true;
+        } else if (arg == "--stream") {
+            isStream = true;
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg == "--select" && i + 1 < argc) {
+            try {
+                projection = Projection::parse (argv[++i]);
+            } catch (const std::exception & e) {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            // only JSON can be pruned
+            json = true;
+        } else if (arg == "--evolve-to" && i + 1 < argc) {
+            if (!target (argv[++i])) {
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "-h" || arg == "--help") {
+            usage (argv[0]);
+            return EXIT_SUCCESS;
+        } else {
+            args.push_back (arg);
+        }
+    }
 
-    if (stat(argv[1], &results) != 0) {
+    if (args.empty()) {
+        usage (argv[0]);
         return EXIT_FAILURE;
     }
 
-    CordaBytes cb (argv[1]);
-    
-    if (cb.encoding() == amqp::DATA_AND_STOP) {
-        BlobInspector blobInspector (cb);
-        auto val = blobInspector.dump();
-        std::cout << val << std::endl;
-    } else {
-        std::cerr << "BAD ENCODING " << cb.encoding() << " != "
-            << amqp::DATA_AND_STOP << std::endl;
+    if (isStream) {
+        return stream (args, workers, ordered, json, projection);
+    }
+
+    std::vector<std::string> files;
+
+    try {
+        for (const auto & arg : args) {
+            auto expanded = Batch::expand (arg);
 
+            // anything other than a single named blob means we're batching
+            isBatch |= expanded.size() != 1 || expanded[0] != arg;
+
+            files.insert (files.end(), expanded.begin(), expanded.end());
+        }
+    } catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
     }
 
-    return EXIT_SUCCESS;
+    isBatch |= files.size() != 1;
+
+    return isBatch
+        ? batch (std::move (files), workers, ordered, json, projection)
+        : single (files[0].c_str(), json, projection);
 }
 
 /******************************************************************************/
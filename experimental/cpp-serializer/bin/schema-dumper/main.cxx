@@ -9,6 +9,8 @@
 #include <proton/codec.h>
 #include <sys/stat.h>
 #include <sstream>
+#include <vector>
+#include <stdexcept>
 
 #include "debug.h"
 
@@ -20,6 +22,7 @@
 
 #include "amqp/schema/described-types/Envelope.h"
 #include "amqp/CompositeFactory.h"
+#include "Decompress.h"
 
 /******************************************************************************/
 
@@ -38,11 +41,7 @@ printNode (pn_data_t * d_) {
 /******************************************************************************/
 
 void
-data_and_stop(std::ifstream & f_, ssize_t sz) {
-    char * blob = new char[sz];
-    memset (blob, 0, sz);
-    f_.read(blob, sz);
-
+decode (const char * blob, ssize_t sz) {
     pn_data_t * d = pn_data(sz);
 
     // returns how many bytes we processed which right now we don't care
@@ -57,6 +56,45 @@ data_and_stop(std::ifstream & f_, ssize_t sz) {
 
 /******************************************************************************/
 
+void
+data_and_stop(std::ifstream & f_, ssize_t sz) {
+    char * blob = new char[sz];
+    memset (blob, 0, sz);
+    f_.read(blob, sz);
+
+    decode (blob, sz);
+}
+
+/******************************************************************************/
+
+/**
+ * The byte after an ENCODING section says how everything after it was
+ * compressed, decompressed that should be a DATA_AND_STOP section
+ */
+void
+encoded (std::ifstream & f_, ssize_t sz) {
+    std::vector<char> blob (sz);
+    f_.read (blob.data(), sz);
+
+    if (blob.empty()) {
+        throw std::runtime_error ("Missing encoding");
+    }
+
+    std::vector<char> inflated;
+    decompress (
+        static_cast<amqp::amqp_encoding_t>(blob[0]),
+        blob.data() + 1, blob.size() - 1,
+        inflated);
+
+    if (inflated.empty() || inflated[0] != amqp::DATA_AND_STOP) {
+        throw std::runtime_error ("Compressed blob has no DATA_AND_STOP section");
+    }
+
+    decode (inflated.data() + 1, inflated.size() - 1);
+}
+
+/******************************************************************************/
+
 int
 main (int argc, char **argv) {
     struct stat results { };
@@ -74,11 +112,21 @@ main (int argc, char **argv) {
         return EXIT_FAILURE;
     }
 
-    amqp::amqp_section_id_t encoding;
-    f.read((char *)&encoding, 1);
+    // the section id is a single byte, read it as such rather than into
+    // the (wider) enum directly
+    char section { };
+    f.read (&section, 1);
+    auto encoding = static_cast<amqp::amqp_section_id_t>(section);
 
     if (encoding == amqp::DATA_AND_STOP) {
         data_and_stop(f, results.st_size - 8);
+    } else if (encoding == amqp::ENCODING) {
+        try {
+            encoded (f, results.st_size - 8);
+        } catch (const std::exception & e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
     } else {
         std::cerr << "BAD ENCODING " << encoding << " != "
             << amqp::DATA_AND_STOP << std::endl;
@@ -14,6 +14,16 @@ namespace amqp {
         ENCODING          = 2
     };
 
+    /*
+     * Following an ENCODING section id, how everything after it has been
+     * compressed. Values are the ordinals of the JVM's
+     * CordaSerializationEncoding
+     */
+    enum amqp_encoding_t {
+        DEFLATE = 0,
+        SNAPPY  = 1
+    };
+
 }
 
 /******************************************************************************/
@@ -0,0 +1,128 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <stdexcept>
+
+/******************************************************************************
+ *
+ * Errors as values
+ *
+ ******************************************************************************/
+
+/**
+ * What decoding a blob can run into that's down to the blob rather than
+ * to us. Scanning a corpus of blobs, some of which are bound to be bad,
+ * these are handed back rather than thrown so a bad blob costs about the
+ * same as a good one. Only [Result::value] turns one into an exception,
+ * for callers happy to have one.
+ */
+namespace amqp {
+
+    enum class Errc : uint8_t {
+        Ok = 0,
+        Malformed,          // the bytes aren't an AMQP value
+        TrailingBytes,      // more follow the value than belong to it
+        NotAnEnvelope,      // the value isn't a Corda envelope
+        UnexpectedType,     // the wire doesn't match the schema
+        UnknownReference,   // refers back to an object we haven't met
+        BadSchema,          // the schema or transforms couldn't be read
+        Unsupported,        // the schema has something we can't read
+        BadProjection       // what's selected isn't in the blob's types
+    };
+
+    /**
+     * Where in the blob's AMQP data, after the Corda header, we were when
+     * it went wrong. Only the native codec knows, with qpid-proton it's
+     * always 0.
+     */
+    struct Error {
+        Errc code { Errc::Ok };
+        size_t offset { 0 };
+
+        explicit operator bool() const { return code != Errc::Ok; }
+
+        const char * what() const;
+        std::string str() const;
+    };
+
+    class Failure : public std::runtime_error {
+        private :
+            Error m_error;
+
+        public :
+            explicit Failure (const Error &);
+
+            const Error & error() const { return m_error; }
+    };
+
+    /**
+     * Either a [T] or the [Error] that meant we couldn't have one
+     */
+    template<typename T>
+    class [[nodiscard]] Result {
+        private :
+            std::variant<T, Error> m_value;
+
+        public :
+            Result (T value_) : m_value (std::move (value_)) { } // NOLINT
+            Result (const Error & error_) : m_value (error_) { } // NOLINT
+
+            explicit operator bool() const { return m_value.index() == 0; }
+
+            /**
+             * What went wrong, an [Error] whose code is [Errc::Ok] if nothing did
+             */
+            Error error() const {
+                auto rtn = std::get_if<Error> (&m_value);
+                return rtn ? *rtn : Error { };
+            }
+
+            /**
+             * The value, there being none to dereference an error throws
+             * it as a [Failure]
+             */
+            T & operator * () { return *get(); }
+            T * operator -> () { return get(); }
+
+            T value() && { return std::move (*get()); }
+
+        private :
+            T * get() {
+                auto rtn = std::get_if<T> (&m_value);
+
+                if (!rtn) {
+                    throw Failure (error());
+                }
+
+                return rtn;
+            }
+    };
+
+    template<>
+    class [[nodiscard]] Result<void> {
+        private :
+            Error m_error;
+
+        public :
+            Result() = default;
+            Result (const Error & error_) : m_error (error_) { } // NOLINT
+
+            explicit operator bool() const { return !m_error; }
+
+            const Error & error() const { return m_error; }
+
+            void value() const {
+                if (m_error) {
+                    throw Failure (m_error);
+                }
+            }
+    };
+
+}
+
+/******************************************************************************/
@@ -5,6 +5,7 @@
 #include <any>
 
 #include "amqp/AMQPDescribed.h"
+#include "amqp/writer/IWriter.h"
 
 #include "amqp/schema/described-types/Schema.h"
 
@@ -68,6 +69,15 @@ namespace amqp::reader {
                     pn_data_t *,
                     const SchemaType &) const = 0;
 
+            /**
+             * Stream the value straight into [writer] rather than
+             * building an [IValue] to be dumped later
+             */
+            virtual void write (
+                    pn_data_t *,
+                    const SchemaType &,
+                    writer::IWriter &) const = 0;
+
     };
 
 }
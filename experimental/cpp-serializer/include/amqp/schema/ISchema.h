@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include "types.h"
 
 #include "amqp/AMQPDescribed.h"
@@ -11,6 +13,13 @@ namespace amqp::schema {
         public :
             virtual Iterator fromType (const std::string &) const = 0;
             virtual Iterator fromDescriptor (const std::string &) const = 0;
+
+            /**
+             * By the interned id of the descriptor, for use while reading
+             * values where we don't want to build a string for every one.
+             * Throws if the schema doesn't have the type.
+             */
+            virtual Iterator fromDescriptor (uint32_t) const = 0;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string_view>
+#include <cstdint>
+
+/******************************************************************************
+ *
+ * class amqp::writer::IWriter
+ *
+ ******************************************************************************/
+
+/**
+ * Streaming alternative to building an [IValue] tree and dumping it.
+ * Readers push the values they read straight into a writer as they walk
+ * the blob, the writer is responsible for any separators and for
+ * formatting each value for whatever it's producing.
+ *
+ * Within an object a [key] is expected before every value, a scalar
+ * written in its place is treated as the key. Maps use this since their
+ * keys come from a reader rather than the schema.
+ *
+ * Views passed to a writer are only good for the call. Most point into
+ * the blob, which outlives everything reading it, so a writer that holds
+ * on to them only has to copy what's passed to [formatted].
+ */
+namespace amqp::writer {
+
+    class IWriter {
+        public :
+            virtual ~IWriter() = default;
+
+            virtual void beginObject() = 0;
+            virtual void endObject() = 0;
+
+            virtual void beginArray() = 0;
+            virtual void endArray() = 0;
+
+            virtual void key (std::string_view) = 0;
+
+            virtual void string (std::string_view) = 0;
+            virtual void integer (int64_t) = 0;
+            virtual void unsignedInteger (uint64_t) = 0;
+            virtual void floating (double) = 0;
+            virtual void boolean (bool) = 0;
+            virtual void null() = 0;
+
+            /**
+             * A string built by the reader, in a buffer of its own, rather
+             * than viewed in the blob
+             */
+            virtual void formatted (std::string_view value_) {
+                string (value_);
+            }
+    };
+
+}
+
+/******************************************************************************/
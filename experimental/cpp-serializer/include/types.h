@@ -6,6 +6,8 @@
 #include <list>
 #include <vector>
 #include <memory>
+#include <string>
+#include <memory_resource>
 
 /******************************************************************************/
 
@@ -21,6 +23,17 @@ using sVec = std::vector<T>;
 template<typename T>
 using sList = std::list<T>;
 
+/**
+ * As above but allocating from whichever memory_resource they're given
+ */
+using pmrString = std::pmr::string;
+
+template<typename T>
+using pmrVec = std::pmr::vector<T>;
+
+template<typename T>
+using pmrList = std::pmr::list<T>;
+
 template<typename T>
 using upStrMap_t = std::map<std::string, uPtr<T>>;
 
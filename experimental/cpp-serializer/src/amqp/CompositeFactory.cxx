@@ -4,6 +4,7 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 #include <functional>
 
 #include <assert.h>
@@ -30,39 +31,53 @@
 
 namespace {
 
-/**
- *
- */
-    template<typename T>
-    std::shared_ptr<T> &
+    using Index = amqp::internal::reader::ReaderTable::Index;
+
+    /**
+     * Where in [table_] the reader for [k_] is, [f_] building it there if
+     * we've not got one yet
+     */
+    Index
     computeIfAbsent(
-            spStrMap_t<T> &map_,
+            const amqp::internal::reader::ReaderTable &table_,
+            std::map<std::string, Index> &map_,
             const std::string &k_,
-            std::function<std::shared_ptr<T>(void)> f_
+            const std::function<Index(void)> &f_
     ) {
         auto it = map_.find(k_);
 
         if (it == map_.end()) {
             DBG ("ComputeIfAbsent \"" << k_ << "\" - missing" << std::endl); // NOLINT
-            map_[k_] = std::move (f_());
-            DBG ("                \"" << k_ << "\" - RTN: " << map_[k_]->name() << " : " << map_[k_]->type()
+            auto index = f_();
+            DBG ("                \"" << k_ << "\" - RTN: " << table_[index].name() << " : " << table_[index].type()
                                       << std::endl); // NOLINT
-            assert (map_[k_]);
-            assert (map_[k_] != nullptr);
-            DBG (k_ << " =?= " << map_[k_]->type() << std::endl);
-            assert (k_ == map_[k_]->type());
+            DBG (k_ << " =?= " << table_[index].type() << std::endl);
+            assert (k_ == table_[index].type());
 
-            return map_[k_];
+            return map_[k_] = index;
         } else {
             DBG ("ComputeIfAbsent \"" << k_ << "\" - found it" << std::endl); // NOLINT
-            DBG ("                \"" << k_ << "\" - RTN: " << map_[k_]->name() << std::endl); // NOLINT
-
-            assert (it->second != nullptr);
+            DBG ("                \"" << k_ << "\" - RTN: " << table_[it->second].name() << std::endl); // NOLINT
 
             return it->second;
         }
     }
 
+    /**
+     * Readers for non primitive types are always built before anything that
+     * depends on them
+     */
+    Index
+    find (const std::map<std::string, Index> &map_, const std::string &k_) {
+        auto it = map_.find (k_);
+
+        if (it == map_.end()) {
+            throw std::runtime_error ("Missing type in map");
+        }
+
+        return it->second;
+    }
+
 }
 
 /******************************************************************************
@@ -71,6 +86,47 @@ namespace {
  *
  ******************************************************************************/
 
+amqp::internal::
+CompositeFactory::CompositeFactory()
+    : CompositeFactory (std::make_shared<reader::EnumMappings>())
+{ }
+
+/******************************************************************************/
+
+amqp::internal::
+CompositeFactory::CompositeFactory (
+    std::shared_ptr<reader::EnumMappings> enums_,
+    std::shared_ptr<reader::Evolution> evolution_
+) : m_readers { std::make_shared<reader::ReaderTable>() }
+  , m_enums { std::move (enums_) }
+  , m_evolution { std::move (evolution_) }
+  , m_tables { std::make_shared<const Tables>() }
+  , m_projections { std::make_shared<const Projections>() }
+{ }
+
+/******************************************************************************/
+
+/**
+ * Whether we already have readers for every type in [schema_]
+ */
+bool
+amqp::internal::
+CompositeFactory::known (const SchemaType & schema_) const {
+    auto tables = std::atomic_load (&m_tables);
+
+    for (const auto & i : dynamic_cast<const schema::Schema &>(schema_)) {
+        for (const auto & j : i) {
+            if (tables->readersByDescriptor.count (j->descriptor()) == 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+
 /**
  *
  * Walk through the types in a Schema and produce readers for them.
@@ -80,39 +136,121 @@ namespace {
  * as we go without needing to provide look ahead for types
  * we haven't built yet.
  *
+ * Nobody sees any of it until it's all built, a schema we fail to
+ * process leaves us as we were bar whatever readers it managed to add to
+ * the table, which nothing will ever refer to.
+ *
  */
 void
 amqp::internal::
 CompositeFactory::process (const SchemaType & schema_) {
     DBG ("process schema" << std::endl);
 
+    if (known (schema_)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock (m_write);
+
+    auto tables = std::make_shared<Tables> (*m_tables);
+
     for (const auto & i : dynamic_cast<const schema::Schema &>(schema_)) {
         for (const auto & j : i) {
-            process (*j);
-            m_readersByDescriptor[j->descriptor()] = m_readersByType[j->name()];
+            if (tables->readersByDescriptor.count (j->descriptor())) {
+                continue;
+            }
+
+            tables->readersByDescriptor[j->descriptor()] = process (*tables, *j);
+            tables->program.compile (*j, m_enums.get(), m_evolution.get());
         }
     }
+
+    std::atomic_store (&m_tables, sPtr<const Tables> (std::move (tables)));
+
+    // compiled against the program we've just replaced
+    std::atomic_store (&m_projections, std::make_shared<const Projections>());
+}
+
+/******************************************************************************/
+
+sPtr<const amqp::internal::reader::Program>
+amqp::internal::
+CompositeFactory::program() const {
+    auto tables = std::atomic_load (&m_tables);
+
+    // sharing ownership of the tables the program is part of
+    return sPtr<const reader::Program> (tables, &tables->program);
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+std::pair<sPtr<const amqp::internal::reader::Program>, uint32_t>
+amqp::internal::
+CompositeFactory::program (
+    const std::string & descriptor_,
+    const reader::Projection & projection_
+) {
+    if (projection_.all()) {
+        auto rtn = program();
+        return { rtn, rtn->entry (descriptor_) };
+    }
+
+    auto key = std::make_pair (descriptor_, projection_.str());
+    auto projections = std::atomic_load (&m_projections);
+    auto it = projections->entries.find (key);
+
+    if (it == projections->entries.end()) {
+        std::lock_guard<std::mutex> lock (m_write);
+
+        // someone else may have compiled it while we waited
+        projections = m_projections;
+        it = projections->entries.find (key);
+
+        if (it == projections->entries.end()) {
+            // the first since the tables were published starts from
+            // their program, the rest add to what's been projected
+            auto copy = projections->entries.empty()
+                ? std::make_shared<Projections> (Projections { m_tables->program, { } })
+                : std::make_shared<Projections> (*projections);
+
+            auto entry = copy->program.project (descriptor_, projection_);
+            copy->entries.emplace (key, entry);
+
+            projections = std::move (copy);
+            std::atomic_store (&m_projections, projections);
+
+            it = projections->entries.find (key);
+        }
+    }
+
+    return { sPtr<const reader::Program> (projections, &projections->program), it->second };
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::process (
+    Tables & tables_,
     const amqp::internal::schema::AMQPTypeNotation & schema_)
 {
     DBG ("process::" << schema_.name() << std::endl);
 
-    return computeIfAbsent<reader::Reader> (
-        m_readersByType,
+    return computeIfAbsent (
+        *m_readers,
+        tables_.readersByType,
         schema_.name(),
-        [& schema_, this] () -> std::shared_ptr<reader::Reader> {
+        [& tables_, & schema_, this] () -> Index {
             switch (schema_.type()) {
                 case schema::AMQPTypeNotation::composite_t : {
-                    return processComposite (schema_);
+                    return processComposite (tables_, schema_);
                 }
                 case schema::AMQPTypeNotation::restricted_t : {
-                    return processRestricted (schema_);
+                    return processRestricted (tables_, schema_);
+                }
+                default : {
+                    throw std::runtime_error (
+                            "Unknown type notation for " + schema_.name());
                 }
             }
         });
@@ -120,16 +258,17 @@ CompositeFactory::process (
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::processComposite (
+        Tables & tables_,
         const amqp::internal::schema::AMQPTypeNotation & type_
 ) {
     DBG ("processComposite - " << type_.name() << std::endl);
-    std::vector<std::weak_ptr<reader::Reader>> readers;
+    std::vector<Index> readers;
 
-    const auto & fields = dynamic_cast<const schema::Composite &> (
-            type_).fields();
+    const auto & composite = dynamic_cast<const schema::Composite &> (type_);
+    const auto & fields = composite.fields();
 
     readers.reserve (fields.size());
 
@@ -138,78 +277,74 @@ CompositeFactory::processComposite (
             << "\" {" << field->resolvedType() << "} "
             << field->fieldType() << std::endl); // NOLINT
 
-       decltype (m_readersByType)::mapped_type reader;
-
         if (field->primitive()) {
-            reader = computeIfAbsent<reader::Reader> (
-                    m_readersByType,
+            readers.push_back (computeIfAbsent (
+                    *m_readers,
+                    tables_.readersByType,
                     field->resolvedType(),
-                    [&field]() -> std::shared_ptr<reader::PropertyReader> {
-                        return reader::PropertyReader::make (field);
-                    });
+                    [&field, this]() -> Index {
+                        return reader::PropertyReader::make (*m_readers, field);
+                    }));
         }
         else {
             // Insertion sorting ensures any type we depend on will have
             // already been created and thus exist in the map
-            reader = m_readersByType[field->resolvedType()];
+            readers.push_back (find (tables_.readersByType, field->resolvedType()));
         }
-
-
-        assert (reader);
-        readers.emplace_back (reader);
-        assert (readers.back().lock());
     }
 
-    return std::make_shared<reader::CompositeReader> (type_.name(), readers);
+    return m_readers->emplace<reader::CompositeReader> (
+            type_.name(),
+            *m_readers,
+            std::move (readers),
+            m_evolution ? m_evolution->plan (composite) : nullptr);
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::processEnum (
     const amqp::internal::schema::Enum & enum_
 ) {
     DBG ("Processing Enum - " << enum_.name() << std::endl); // NOLINT
 
-    return std::make_shared<reader::EnumReader> (
+    return m_readers->emplace<reader::EnumReader> (
         enum_.name(),
-        enum_.makeChoices());
+        enum_.makeChoices(),
+        (*m_enums)[enum_.name()]);
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
-CompositeFactory::fetchReaderForRestricted (const std::string & type_) {
-    decltype(m_readersByType)::mapped_type rtn;
-
+CompositeFactory::fetchReaderForRestricted (
+    Tables & tables_,
+    const std::string & type_
+) {
     DBG ("fetchReaderForRestricted - " << type_ << std::endl);
 
     if (schema::Field::typeIsPrimitive(type_)) {
         DBG ("It's primitive" << std::endl);
-        rtn = computeIfAbsent<reader::Reader>(
-                m_readersByType,
+        return computeIfAbsent (
+                *m_readers,
+                tables_.readersByType,
                 type_,
-                [& type_]() -> std::shared_ptr<reader::PropertyReader> {
-                    return reader::PropertyReader::make (type_);
+                [& type_, this]() -> Index {
+                    return reader::PropertyReader::make (*m_readers, type_);
                 });
-    } else {
-        rtn = m_readersByType[type_];
     }
 
-    if (!rtn) {
-        throw std::runtime_error ("Missing type in map");
-    }
-
-    return rtn;
+    return find (tables_.readersByType, type_);
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::processMap (
+    Tables & tables_,
     const amqp::internal::schema::Map & map_
 ) {
     DBG ("Processing Map - "
@@ -218,45 +353,51 @@ CompositeFactory::processMap (
 
     const auto types = map_.mapOf();
 
-    return std::make_shared<reader::MapReader> (
+    auto key = fetchReaderForRestricted (tables_, types.first);
+    auto value = fetchReaderForRestricted (tables_, types.second);
+
+    return m_readers->emplace<reader::MapReader> (
             map_.name(),
-            fetchReaderForRestricted (types.first),
-            fetchReaderForRestricted (types.second));
+            m_readers->ref (key),
+            m_readers->ref (value));
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::processList (
+    Tables & tables_,
     const amqp::internal::schema::List & list_
 ) {
     DBG ("Processing List - " << list_.listOf() << std::endl); // NOLINT
 
-    return std::make_shared<reader::ListReader> (
+    return m_readers->emplace<reader::ListReader> (
             list_.name(),
-            fetchReaderForRestricted (list_.listOf()));
+            m_readers->ref (fetchReaderForRestricted (tables_, list_.listOf())));
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::processArray (
+        Tables & tables_,
         const amqp::internal::schema::Array & array_
 ) {
     DBG ("Processing Array - " << array_.name() << " " << array_.arrayOf() << std::endl); // NOLINT
 
-    return std::make_shared<reader::ArrayReader> (
+    return m_readers->emplace<reader::ArrayReader> (
             array_.name(),
-            fetchReaderForRestricted (array_.arrayOf()));
+            m_readers->ref (fetchReaderForRestricted (tables_, array_.arrayOf())));
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::Reader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::
 CompositeFactory::processRestricted (
+        Tables & tables_,
         const amqp::internal::schema::AMQPTypeNotation & type_)
 {
     DBG ("processRestricted - " << type_.name() << std::endl); // NOLINT
@@ -266,6 +407,7 @@ CompositeFactory::processRestricted (
     switch (restricted.restrictedType()) {
         case schema::Restricted::RestrictedTypes::list_t : {
             return processList (
+                tables_,
                 dynamic_cast<const schema::List &> (restricted));
         }
         case schema::Restricted::RestrictedTypes::enum_t : {
@@ -274,17 +416,18 @@ CompositeFactory::processRestricted (
         }
         case schema::Restricted::RestrictedTypes::map_t : {
             return processMap (
+                tables_,
                 dynamic_cast<const schema::Map &> (restricted));
         }
         case schema::Restricted::RestrictedTypes::array_t : {
             DBG ("  array_t" << std::endl);
             return processArray (
+                tables_,
                 dynamic_cast<const schema::Array &> (restricted));
         }
     }
 
-    DBG ("  ProcessRestricted: Returning nullptr"); // NOLINT
-    return nullptr;
+    throw std::runtime_error ("Unknown restricted type " + type_.name());
 }
 
 /******************************************************************************/
@@ -292,9 +435,18 @@ CompositeFactory::processRestricted (
 const std::shared_ptr<amqp::internal::reader::IReader>
 amqp::internal::
 CompositeFactory::byType (const std::string & type_) {
-    auto it = m_readersByType.find (type_);
+    auto tables = std::atomic_load (&m_tables);
+    const auto & readers = tables->readersByType;
+    auto it = readers.find (type_);
 
-    return (it == m_readersByType.end()) ? nullptr : it->second;
+    if (it == readers.end()) {
+        return nullptr;
+    }
+
+    // sharing ownership of the table, every method of a reader is const
+    return std::shared_ptr<ReaderType> (
+            m_readers,
+            const_cast<reader::Reader *> (&(*m_readers)[it->second]));
 }
 
 /******************************************************************************/
@@ -302,9 +454,18 @@ CompositeFactory::byType (const std::string & type_) {
 const std::shared_ptr<amqp::internal::reader::IReader>
 amqp::internal::
 CompositeFactory::byDescriptor (const std::string & descriptor_) {
-    auto it = m_readersByDescriptor.find (descriptor_);
+    auto tables = std::atomic_load (&m_tables);
+    const auto & readers = tables->readersByDescriptor;
+    auto it = readers.find (descriptor_);
+
+    if (it == readers.end()) {
+        return nullptr;
+    }
 
-    return (it == m_readersByDescriptor.end()) ? nullptr : it->second;
+    // sharing ownership of the table, every method of a reader is const
+    return std::shared_ptr<ReaderType> (
+            m_readers,
+            const_cast<reader::Reader *> (&(*m_readers)[it->second]));
 }
 
 /******************************************************************************/
@@ -4,7 +4,9 @@
 
 #include <map>
 #include <set>
+#include <mutex>
 #include <memory>
+#include <utility>
 
 #include "types.h"
 
@@ -13,6 +15,11 @@
 #include "amqp/schema/described-types/Envelope.h"
 #include "amqp/schema/described-types/Composite.h"
 #include "amqp/reader/CompositeReader.h"
+#include "amqp/reader/Program.h"
+#include "amqp/reader/ReaderTable.h"
+#include "amqp/reader/EnumMapping.h"
+#include "amqp/reader/Evolution.h"
+#include "amqp/reader/Projection.h"
 #include "amqp/schema/restricted-types/Map.h"
 #include "amqp/schema/restricted-types/Array.h"
 #include "amqp/schema/restricted-types/List.h"
@@ -22,6 +29,29 @@
 
 namespace amqp::internal {
 
+    /**
+     * Builds, and owns, the readers for the types of a schema and the
+     * program they compile down to.
+     *
+     * Safe to share between threads. Lookups never wait on a writer,
+     * everything they need being in a set of [Tables] that's never
+     * changed once published. Processing a schema with types we've not
+     * seen before takes the one writer lock, copies the latest tables,
+     * adds to the copy and publishes it by swapping the shared pointer
+     * to them. Tables that have been replaced go as soon as the last
+     * lookup that had them lets go, which is why programs are handed
+     * out shared.
+     *
+     * Programs pruned to a projection are published the same way but
+     * apart from the tables, all of them compiled into one copy of the
+     * program, so adding one never copies the tables. Tables with new
+     * types drop them, they're compiled again as they're next asked for.
+     *
+     * The readers themselves live in a single [ReaderTable], the tables
+     * only mapping types and descriptors to where in it they are. A
+     * reader handed out keeps the whole table alive rather than just
+     * itself, it being no use without the readers it refers to anyway.
+     */
     class CompositeFactory
         : public ICompositeFactory<schema::SchemaMap::const_iterator>
     {
@@ -29,12 +59,55 @@ namespace amqp::internal {
             using CompositePtr = uPtr<schema::Composite>;
             using EnvelopePtr  = uPtr<schema::Envelope>;
 
-            spStrMap_t<reader::Reader> m_readersByType;
-            spStrMap_t<reader::Reader> m_readersByDescriptor;
+            using Index = reader::ReaderTable::Index;
 
-        public :
-            CompositeFactory() = default;
+            struct Tables {
+                std::map<std::string, Index> readersByType;
+                std::map<std::string, Index> readersByDescriptor;
+
+                reader::Program program;
+            };
+
+            /**
+             * The program of the current tables with every projection
+             * asked of it added, where each starts keyed on the descriptor
+             * of the type it starts from and the projection's canonical form
+             */
+            struct Projections {
+                reader::Program program;
+
+                std::map<std::pair<std::string, std::string>, uint32_t> entries;
+            };
+
+            std::shared_ptr<reader::ReaderTable> m_readers;
+            std::shared_ptr<reader::EnumMappings> m_enums;
+            std::shared_ptr<reader::Evolution> m_evolution;
 
+            // only ever loaded and stored by std::atomic_load / atomic_store
+            sPtr<const Tables> m_tables;
+            sPtr<const Projections> m_projections;
+
+            std::mutex m_write;
+
+        public :
+            CompositeFactory();
+
+            /**
+             * Sharing [enums_] with other factories, see [EnumMappings],
+             * and reading composites as the versions [evolution_] has of
+             * them, if there is one
+             */
+            explicit CompositeFactory (
+                std::shared_ptr<reader::EnumMappings> enums_,
+                std::shared_ptr<reader::Evolution> evolution_ = nullptr);
+
+            CompositeFactory (const CompositeFactory &) = delete;
+            CompositeFactory & operator = (const CompositeFactory &) = delete;
+
+            /**
+             * Types we already have readers for are left as they are, a
+             * schema that's nothing but those never takes the lock
+             */
             void process (const SchemaType &) override;
 
             const std::shared_ptr<ReaderType> byType (
@@ -43,30 +116,47 @@ namespace amqp::internal {
             const std::shared_ptr<ReaderType> byDescriptor (
                     const std::string &) override;
 
+            /**
+             * The same readers compiled down to a flat program
+             */
+            sPtr<const reader::Program> program() const;
+
+            /**
+             * The program pruned to [projection_] for the type with
+             * [descriptor_], and where in it to start. It's compiled, under
+             * the writer lock, the first time it's asked for and published
+             * with the rest of the projections, so from then on it's a
+             * lookup for anyone else asking.
+             */
+            std::pair<sPtr<const reader::Program>, uint32_t> program (
+                    const std::string & descriptor_,
+                    const reader::Projection & projection_);
+
         private :
-            std::shared_ptr<reader::Reader> process (
-                    const schema::AMQPTypeNotation &);
+            bool known (const SchemaType &) const;
+
+            Index process (
+                    Tables &, const schema::AMQPTypeNotation &);
 
-            std::shared_ptr<reader::Reader> processComposite (
-                    const schema::AMQPTypeNotation &);
+            Index processComposite (
+                    Tables &, const schema::AMQPTypeNotation &);
 
-            std::shared_ptr<reader::Reader> processRestricted (
-                    const schema::AMQPTypeNotation &);
+            Index processRestricted (
+                    Tables &, const schema::AMQPTypeNotation &);
 
-            std::shared_ptr<reader::Reader> processList (
-                    const schema::List &);
+            Index processList (
+                    Tables &, const schema::List &);
 
-            std::shared_ptr<reader::Reader> processEnum (
+            Index processEnum (
                     const schema::Enum &);
 
-            std::shared_ptr<reader::Reader> processMap (
-                    const schema::Map &);
+            Index processMap (
+                    Tables &, const schema::Map &);
 
-            std::shared_ptr<reader::Reader> processArray (
-                    const schema::Array &);
+            Index processArray (
+                    Tables &, const schema::Array &);
 
-            decltype(m_readersByType)::mapped_type
-            fetchReaderForRestricted (const std::string &);
+            Index fetchReaderForRestricted (Tables &, const std::string &);
     };
 
 }
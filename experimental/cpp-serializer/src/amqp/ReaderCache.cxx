@@ -0,0 +1,398 @@
+#include "ReaderCache.h"
+
+#include <set>
+#include <algorithm>
+
+#include "debug.h"
+
+#include "proton/codec.h"
+#include "proton/proton_wrapper.h"
+
+#include "amqp/schema/descriptors/AMQPDescriptors.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::ReaderCache
+ *
+ ******************************************************************************/
+
+amqp::internal::
+ReaderCache::ReaderCache()
+    : m_capacity { 1024 }
+    , m_enums { std::make_shared<reader::EnumMappings>() }
+    , m_evolution { std::make_shared<reader::Evolution>() }
+    , m_hits { 0 }
+    , m_misses { 0 }
+{ }
+
+/******************************************************************************/
+
+amqp::internal::ReaderCache &
+amqp::internal::
+ReaderCache::instance() {
+    static ReaderCache cache;
+
+    return cache;
+}
+
+/******************************************************************************/
+
+/**
+ * The descriptors of every type in [schema_], sorted so the same set of
+ * types produces the same key however the schema happens to order them.
+ */
+std::string
+amqp::internal::
+ReaderCache::key (const schema::Schema & schema_) {
+    std::set<std::string> descriptors;
+
+    for (const auto & i : schema_) {
+        for (const auto & j : i) {
+            descriptors.insert (j->descriptor());
+        }
+    }
+
+    std::string rtn;
+
+    for (const auto & descriptor : descriptors) {
+        rtn.append (descriptor).push_back ('\n');
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+namespace {
+
+    amqp::Error
+    badSchema (pn_data_t * data_) {
+        return { amqp::Errc::BadSchema, proton::offset (data_) };
+    }
+
+    /**
+     * The descriptor of the composite or restricted type notation the
+     * cursor is on, without building any of the rest of it.
+     *
+     * Both lay their elements out as name, label, provides (and for a
+     * restricted type its source) before their [Descriptor], which is the
+     * first element that's itself a described type. The fields or choices
+     * after it we never enter, the cursor steps over them whole.
+     */
+    amqp::Result<std::string>
+    typeDescriptor (pn_data_t * data_) {
+        if (!pn_data_is_described (data_)) {
+            return badSchema (data_);
+        }
+
+        proton::auto_enter p (data_, true);
+        pn_data_next (data_);
+
+        proton::auto_list_enter ale (data_);
+
+        while (pn_data_next (data_)) {
+            if (pn_data_is_described (data_)) {
+                proton::auto_enter p2 (data_, true);
+                pn_data_next (data_);
+
+                proton::auto_list_enter ale2 (data_, true);
+
+                if (pn_data_type (data_) != PN_SYMBOL) {
+                    return badSchema (data_);
+                }
+
+                auto symbol = pn_data_get_symbol (data_);
+
+                return std::string (symbol.start, symbol.size);
+            }
+        }
+
+        // a type notation without a descriptor
+        return badSchema (data_);
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * As [key] for a [Schema] but read straight from the encoded schema
+ * section the cursor is on. The same set of types gives the same key
+ * either way so blobs read lazily and those read in full share entries.
+ */
+std::string
+amqp::internal::
+ReaderCache::key (pn_data_t * data_) {
+    return tryKey (data_).value();
+}
+
+/******************************************************************************/
+
+/**
+ * Read for every blob, so a schema section that isn't as it should be
+ * is an error rather than an exception
+ */
+amqp::Result<std::string>
+amqp::internal::
+ReaderCache::tryKey (pn_data_t * data_) {
+    std::set<std::string> descriptors;
+
+    if (!pn_data_is_described (data_)) {
+        return badSchema (data_);
+    }
+
+    {
+        proton::auto_enter p (data_, true);
+        pn_data_next (data_);
+
+        /*
+         * As with the SchemaDescriptor, a list of lists of described types
+         */
+        proton::auto_list_enter ale (data_);
+
+        while (pn_data_next (data_)) {
+            proton::auto_list_enter ale2 (data_);
+
+            while (pn_data_next (data_)) {
+                auto descriptor = typeDescriptor (data_);
+
+                if (!descriptor) {
+                    return descriptor.error();
+                }
+
+                descriptors.insert (std::move (*descriptor));
+            }
+        }
+    }
+
+    std::string rtn;
+
+    for (const auto & descriptor : descriptors) {
+        rtn.append (descriptor).push_back ('\n');
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+amqp::internal::ReaderCache::FactoryPtr
+amqp::internal::
+ReaderCache::factory (const schema::Schema & schema_) {
+    auto key { ReaderCache::key (schema_) };
+
+    {
+        std::lock_guard<std::mutex> lock (m_lock);
+
+        auto it = m_factories.find (key);
+
+        if (it != m_factories.end()) {
+            ++m_hits;
+            return it->second.factory;
+        }
+    }
+
+    DBG ("ReaderCache: miss" << std::endl); // NOLINT
+    ++m_misses;
+
+    // build outside the lock, if two threads race on the same schema we
+    // just keep whichever lands first
+    auto factory = std::make_shared<CompositeFactory> (m_enums, m_evolution);
+    factory->process (schema_);
+
+    // we don't own the schema so can't keep it
+    return insert (std::move (key), { nullptr, std::move (factory) }).factory;
+}
+
+/******************************************************************************/
+
+/**
+ * The lazy counterpart to [factory]. With the cursor on the schema
+ * section of an envelope only its type descriptors are read to form
+ * the key, the [Schema] itself is only built when we've not seen that
+ * set of types before (or only saw it through [factory]).
+ */
+amqp::internal::ReaderCache::Entry
+amqp::internal::
+ReaderCache::entry (pn_data_t * data_) {
+    auto key { ReaderCache::key (data_) };
+
+    Entry rtn;
+
+    if (cached (key, rtn)) {
+        return rtn;
+    }
+
+    return build (std::move (key), data_);
+}
+
+/******************************************************************************/
+
+/**
+ * A blob whose schema we've seen is read without anything being thrown.
+ * Building the readers for a new one is left to the schema descriptors,
+ * which throw, but that only happens once for each schema.
+ */
+amqp::Result<amqp::internal::ReaderCache::Entry>
+amqp::internal::
+ReaderCache::tryEntry (pn_data_t * data_) {
+    auto key = tryKey (data_);
+
+    if (!key) {
+        return key.error();
+    }
+
+    Entry rtn;
+
+    if (cached (*key, rtn)) {
+        return rtn;
+    }
+
+    auto offset = proton::offset (data_);
+
+    try {
+        return build (std::move (*key), data_);
+    } catch (const std::exception & e) {
+        DBG ("ReaderCache: " << e.what() << std::endl); // NOLINT
+        return amqp::Error { amqp::Errc::BadSchema, offset };
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Only an entry with its schema will do for a blob read lazily
+ */
+bool
+amqp::internal::
+ReaderCache::cached (const std::string & key_, Entry & entry_) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    auto it = m_factories.find (key_);
+
+    if (it != m_factories.end() && it->second.schema) {
+        ++m_hits;
+        entry_ = it->second;
+        return true;
+    }
+
+    return false;
+}
+
+/******************************************************************************/
+
+amqp::internal::ReaderCache::Entry
+amqp::internal::
+ReaderCache::build (std::string key_, pn_data_t * data_) {
+    DBG ("ReaderCache: miss" << std::endl); // NOLINT
+    ++m_misses;
+
+    SchemaPtr schema (schema::descriptors::dispatchDescribed<schema::Schema> (data_));
+
+    auto factory = std::make_shared<CompositeFactory> (m_enums, m_evolution);
+    factory->process (*schema);
+
+    return insert (std::move (key_), { std::move (schema), std::move (factory) });
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::
+ReaderCache::evolveTo (
+    const schema::Schema & schema_,
+    const schema::Transforms & transforms_
+) {
+    m_evolution->target (schema_);
+
+    for (const auto & i : schema_) {
+        for (const auto & j : i) {
+            if (auto e = dynamic_cast<const schema::Enum *> (j.get())) {
+                m_enums->evolve (e->name(), e->makeChoices(), transforms_[e->name()]);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    m_factories.clear();
+    m_age.clear();
+}
+
+/******************************************************************************/
+
+/**
+ * Keeps whatever is already cached under [key_], though if that came
+ * without a schema it takes the one from [entry_]
+ */
+amqp::internal::ReaderCache::Entry
+amqp::internal::
+ReaderCache::insert (std::string key_, Entry entry_) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    auto [it, inserted] = m_factories.emplace (key_, entry_);
+
+    if (inserted) {
+        m_age.push_back (std::move (key_));
+
+        while (m_factories.size() > m_capacity) {
+            m_factories.erase (m_age.front());
+            m_age.pop_front();
+        }
+    } else if (!it->second.schema) {
+        it->second.schema = std::move (entry_.schema);
+    }
+
+    // copy out under the lock, eviction may drop it at any point after
+    return it->second;
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::
+ReaderCache::size() const {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    return m_factories.size();
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::
+ReaderCache::capacity() const {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    return m_capacity;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::
+ReaderCache::capacity (size_t capacity_) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    m_capacity = std::max<size_t> (capacity_, 1);
+
+    while (m_factories.size() > m_capacity) {
+        m_factories.erase (m_age.front());
+        m_age.pop_front();
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::
+ReaderCache::clear() {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    m_factories.clear();
+    m_age.clear();
+    m_hits = 0;
+    m_misses = 0;
+}
+
+/******************************************************************************/
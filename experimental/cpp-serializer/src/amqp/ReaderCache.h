@@ -0,0 +1,119 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+#include "types.h"
+
+#include "CompositeFactory.h"
+#include "amqp/Result.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Transforms.h"
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+/******************************************************************************/
+
+namespace amqp::internal {
+
+    /**
+     * Process wide cache of reader graphs. Building the readers for a
+     * schema means walking every type in it, for a stream of blobs that
+     * all share the same schema that's wasted effort, so we key the
+     * processed [CompositeFactory] on the set of type descriptors
+     * (fingerprints) the schema contains and hand back the one we built
+     * last time.
+     *
+     * The factory owns the readers (they only refer to one another by
+     * where they are in its table) so callers keep the returned pointer
+     * alive for as long as they're using any reader taken from it.
+     *
+     * Every factory we build shares one set of [EnumMappings] and one
+     * [Evolution], both only changed by [evolveTo].
+     *
+     * The schema itself can be cached alongside its readers, see [entry],
+     * in which case a blob whose schema we've seen before needn't have
+     * its schema section parsed at all.
+     *
+     * Once [capacity] schemas are cached the oldest is dropped.
+     */
+    class ReaderCache {
+        public :
+            using FactoryPtr = sPtr<CompositeFactory>;
+            using SchemaPtr = sPtr<const schema::Schema>;
+
+            struct Entry {
+                SchemaPtr schema;
+                FactoryPtr factory;
+            };
+
+        private :
+            mutable std::mutex m_lock;
+
+            std::unordered_map<std::string, Entry> m_factories;
+            std::list<std::string> m_age;
+            size_t m_capacity;
+
+            const sPtr<reader::EnumMappings> m_enums;
+            const sPtr<reader::Evolution> m_evolution;
+
+            std::atomic<size_t> m_hits;
+            std::atomic<size_t> m_misses;
+
+            ReaderCache();
+
+            Entry insert (std::string, Entry);
+
+            bool cached (const std::string &, Entry &);
+            Entry build (std::string, pn_data_t *);
+
+        public :
+            static ReaderCache & instance();
+
+            static std::string key (const schema::Schema &);
+            static std::string key (pn_data_t *);
+            static amqp::Result<std::string> tryKey (pn_data_t *);
+
+            ReaderCache (const ReaderCache &) = delete;
+            ReaderCache & operator = (const ReaderCache &) = delete;
+
+            FactoryPtr factory (const schema::Schema &);
+
+            Entry entry (pn_data_t *);
+
+            /**
+             * As [entry] but a schema section we can't read is an error
+             * rather than an exception, see [amqp::Result]
+             */
+            amqp::Result<Entry> tryEntry (pn_data_t *);
+
+            /**
+             * Read every composite in a blob as the version of its type in
+             * [schema_], if it has one there, and every enum's constants as
+             * [transforms_] say that version names them. Anything already
+             * cached is dropped, its readers having been built without it.
+             */
+            void evolveTo (
+                const schema::Schema & schema_,
+                const schema::Transforms & transforms_);
+
+            size_t hits() const { return m_hits; }
+            size_t misses() const { return m_misses; }
+
+            size_t size() const;
+            size_t capacity() const;
+            void capacity (size_t);
+
+            void clear();
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,47 @@
+#include "amqp/Result.h"
+
+/******************************************************************************
+ *
+ * amqp::Error
+ *
+ ******************************************************************************/
+
+const char *
+amqp::
+Error::what() const {
+    switch (code) {
+        case Errc::Ok               : return "No error";
+        case Errc::Malformed        : return "Failed to decode blob";
+        case Errc::TrailingBytes    : return "Bytes follow the blob, more than one should be streamed";
+        case Errc::NotAnEnvelope    : return "Blob is not a Corda envelope";
+        case Errc::UnexpectedType   : return "Unexpected type";
+        case Errc::UnknownReference : return "Reference to unknown object";
+        case Errc::BadSchema        : return "Can't read the blob's schema";
+        case Errc::Unsupported      : return "Can't read the blob's types";
+        case Errc::BadProjection    : return "Selection doesn't fit the blob's types";
+    }
+
+    return "Unknown error";
+}
+
+/******************************************************************************/
+
+std::string
+amqp::
+Error::str() const {
+    return std::string (what()) + " at byte " + std::to_string (offset);
+}
+
+/******************************************************************************
+ *
+ * amqp::Failure
+ *
+ ******************************************************************************/
+
+amqp::
+Failure::Failure (const Error & error_)
+    : std::runtime_error (error_.str())
+    , m_error (error_)
+{ }
+
+/******************************************************************************/
@@ -0,0 +1,156 @@
+#include "Symbols.h"
+
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <shared_mutex>
+#include <unordered_map>
+
+/******************************************************************************/
+
+namespace {
+
+    using amqp::internal::Symbols;
+
+    /**
+     * The names live in a deque so they never move, which lets the index
+     * be keyed on views of them and looked up with a view of whatever
+     * bytes we've been handed
+     */
+    class Table {
+        private :
+            mutable std::shared_mutex m_lock;
+
+            std::deque<std::string> m_names;
+            std::unordered_map<std::string_view, Symbols::id_t> m_index;
+
+        public :
+            static Table & instance() {
+                static Table table;
+                return table;
+            }
+
+            /**
+             * The name and id of [symbol_] if we have it
+             */
+            std::pair<std::string_view, Symbols::id_t>
+            find (std::string_view symbol_) const {
+                std::shared_lock lock { m_lock };
+
+                auto it = m_index.find (symbol_);
+
+                if (it == m_index.end()) {
+                    return { { }, Symbols::unknown };
+                }
+
+                return *it;
+            }
+
+            std::pair<std::string_view, Symbols::id_t>
+            intern (std::string_view symbol_) {
+                std::unique_lock lock { m_lock };
+
+                auto it = m_index.find (symbol_);
+
+                if (it != m_index.end()) {
+                    return *it;
+                }
+
+                if (m_names.size() == Symbols::unknown) {
+                    throw std::runtime_error ("Symbol table full");
+                }
+
+                auto id = static_cast<Symbols::id_t>(m_names.size());
+                const auto & name = m_names.emplace_back (symbol_);
+
+                m_index.emplace (name, id);
+
+                return { name, id };
+            }
+
+            const std::string &
+            name (Symbols::id_t id_) const {
+                std::shared_lock lock { m_lock };
+
+                if (id_ >= m_names.size()) {
+                    throw std::runtime_error (
+                        "Unknown symbol " + std::to_string (id_));
+                }
+
+                return m_names[id_];
+            }
+
+            size_t size() const {
+                std::shared_lock lock { m_lock };
+                return m_names.size();
+            }
+    };
+
+    /**
+     * What this thread has already found in the table. Its keys are views
+     * of the table's names so filling it doesn't copy them, and since
+     * ids never change it can't go stale.
+     */
+    std::unordered_map<std::string_view, Symbols::id_t> &
+    cache() {
+        static thread_local std::unordered_map<std::string_view, Symbols::id_t> cache;
+        return cache;
+    }
+
+}
+
+/******************************************************************************/
+
+amqp::internal::Symbols::id_t
+amqp::internal::
+Symbols::intern (std::string_view symbol_) {
+    auto & local = cache();
+
+    if (auto it = local.find (symbol_) ; it != local.end()) {
+        return it->second;
+    }
+
+    auto found = Table::instance().intern (symbol_);
+    local.insert (found);
+
+    return found.second;
+}
+
+/******************************************************************************/
+
+amqp::internal::Symbols::id_t
+amqp::internal::
+Symbols::find (std::string_view symbol_) {
+    auto & local = cache();
+
+    if (auto it = local.find (symbol_) ; it != local.end()) {
+        return it->second;
+    }
+
+    auto found = Table::instance().find (symbol_);
+
+    // not caching misses since something may intern it later
+    if (found.second != unknown) {
+        local.insert (found);
+    }
+
+    return found.second;
+}
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::
+Symbols::name (id_t id_) {
+    return Table::instance().name (id_);
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::
+Symbols::size() {
+    return Table::instance().size();
+}
+
+/******************************************************************************/
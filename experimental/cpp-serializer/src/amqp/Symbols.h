@@ -0,0 +1,53 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <limits>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+#include <proton/types.h>
+
+/******************************************************************************/
+
+namespace amqp::internal {
+
+    /**
+     * Process wide table of interned symbols, type names and descriptors,
+     * each given a 32 bit id the first time it's seen. Ids are never
+     * reused or released so they can be compared, and used as keys, in
+     * place of the strings themselves.
+     *
+     * Looking a symbol up is a hash of the bytes with no allocation, and
+     * each thread keeps its own cache of what it's already found so once
+     * warm finding a symbol takes no lock either.
+     */
+    class Symbols {
+        public :
+            using id_t = uint32_t;
+
+            /**
+             * What [find] returns for a symbol that's never been interned
+             */
+            static constexpr id_t unknown { std::numeric_limits<id_t>::max() };
+
+            static id_t intern (std::string_view);
+
+            static id_t find (std::string_view);
+
+            static id_t find (pn_bytes_t bytes_) {
+                return find (std::string_view (bytes_.start, bytes_.size));
+            }
+
+            static const std::string & name (id_t);
+
+            /**
+             * How many symbols have been interned
+             */
+            static size_t size();
+    };
+
+}
+
+/******************************************************************************/
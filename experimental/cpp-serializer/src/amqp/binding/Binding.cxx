@@ -0,0 +1,255 @@
+#include "Binding.h"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "proton/proton_wrapper.h"
+
+#include "amqp/ReaderCache.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Restricted.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+#include "amqp/schema/descriptors/corda-descriptors/EnvelopeDescriptor.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::binding::Context
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::binding::
+Context::badReference (uint32_t index_) {
+    throw std::runtime_error (
+            "Reference to an object we don't have of that type: "
+                + std::to_string (index_));
+}
+
+/******************************************************************************
+ *
+ *
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::binding::
+expect (pn_data_t * data_, pn_type_t type_) {
+    if (pn_data_type (data_) != type_) {
+        std::stringstream ss;
+        ss << "Expected " << pn_type_name (type_)
+           << " but found [" << data_ << "]";
+
+        throw std::runtime_error (ss.str());
+    }
+}
+
+/******************************************************************************/
+
+amqp::internal::Symbols::id_t
+amqp::internal::binding::
+enter (pn_data_t * data_) {
+    expect (data_, PN_DESCRIBED);
+
+    pn_data_enter (data_);
+    pn_data_next (data_);
+
+    auto descriptor = Symbols::find (proton::get_symbol<pn_bytes_t> (data_));
+
+    pn_data_next (data_);
+
+    return descriptor;
+}
+
+/******************************************************************************/
+
+/**
+ * The JVM numbers every object it writes that isn't a primitive so even
+ * for what we're skipping we have to count them, see [References]. Since
+ * any value that's described carries its own descriptor the schema can
+ * tell us what it is, primitives we can just step over.
+ */
+void
+amqp::internal::binding::
+skip (pn_data_t * data_, Context & context_, bool element_) {
+    auto type = pn_data_type (data_);
+
+    if (type != PN_DESCRIBED) {
+        if (element_ && type == PN_STRING) {
+            context_.skipped();
+        }
+
+        proton::skip (data_);
+        return;
+    }
+
+    pn_data_enter (data_);
+    pn_data_next (data_);
+
+    if (reader::References::index (data_)) {
+        pn_data_exit (data_);
+        pn_data_next (data_);
+        return;
+    }
+
+    const auto & notation = *(context_.schema().fromDescriptor (
+            Symbols::find (proton::get_symbol<pn_bytes_t> (data_)))->second.get());
+
+    pn_data_next (data_);
+
+    auto restricted = dynamic_cast<const schema::Restricted *> (&notation);
+
+    if (!restricted || restricted->restrictedType()
+            != schema::Restricted::RestrictedTypes::enum_t)
+    {
+        // the properties of a class, the elements of a list or array, or
+        // the keys and values of a map
+        auto n = pn_data_type (data_) == PN_MAP
+            ? pn_data_get_map (data_)
+            : pn_data_get_list (data_);
+
+        pn_data_enter (data_);
+        pn_data_next (data_);
+
+        for (size_t i { 0 } ; i < n ; ++i) {
+            skip (data_, context_, restricted != nullptr);
+        }
+
+        pn_data_exit (data_);
+    }
+
+    pn_data_exit (data_);
+    pn_data_next (data_);
+
+    context_.skipped();
+}
+
+/******************************************************************************/
+
+sVec<int>
+amqp::internal::binding::
+resolve (
+    const schema::Schema & schema_,
+    Symbols::id_t descriptor_,
+    const std::string_view * names_,
+    const std::string_view * primitives_,
+    size_t size_
+) {
+    auto composite = dynamic_cast<const schema::Composite *> (
+            schema_.fromDescriptor (descriptor_)->second.get().get());
+
+    if (!composite) {
+        throw std::runtime_error (
+                "Can only bind a struct to a class, not "
+                    + Symbols::name (descriptor_));
+    }
+
+    sVec<int> rtn;
+    rtn.reserve (composite->fields().size());
+
+    for (const auto & field : composite->fields()) {
+        int member { -1 };
+
+        for (size_t i { 0 } ; i < size_ ; ++i) {
+            if (names_[i] == field->name()) {
+                member = static_cast<int> (i);
+                break;
+            }
+        }
+
+        if (   member >= 0
+            && !primitives_[member].empty()
+            && field->primitive()
+            && field->type() != primitives_[member])
+        {
+            throw std::runtime_error (
+                    composite->name() + "." + field->name() + " is a "
+                        + field->type() + " not a "
+                        + std::string (primitives_[member]));
+        }
+
+        rtn.push_back (member);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * As the blob inspector does it, if we've seen the schema before we reuse
+ * it rather than parse it again
+ */
+void
+amqp::internal::binding::
+blob (
+    pn_data_t * data_,
+    const std::function<void (const schema::Schema &)> & f_
+) {
+    using schema::descriptors::EnvelopeDescriptor;
+
+    uPtr<schema::Envelope> envelope;
+
+    if (pn_data_is_described (data_)) {
+        proton::auto_enter p (data_);
+
+        auto it = AMQPDescriptorRegistory.find (pn_data_get_ulong (data_));
+
+        if (it != AMQPDescriptorRegistory.end()) {
+            if (auto descriptor = dynamic_cast<const EnvelopeDescriptor *> (
+                    it->second.get()))
+            {
+                envelope = descriptor->build (data_, [](pn_data_t * schema_) {
+                    return ReaderCache::instance().entry (schema_).schema;
+                });
+            }
+        }
+    }
+
+    if (!envelope) {
+        throw std::runtime_error ("Blob is not a Corda envelope");
+    }
+
+    proton::auto_enter p (data_);
+    pn_data_next (data_);
+    proton::is_list (data_);
+
+    proton::auto_enter p2 (data_);
+
+    f_ (dynamic_cast<const schema::Schema &> (envelope->schema()));
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::binding::
+readString (pn_data_t * data_) {
+    return proton::readAndNext<std::string_view> (data_);
+}
+
+/******************************************************************************/
+
+/**
+ * An enum is described by its fingerprint and is a list of its name and
+ * its ordinal
+ */
+std::string_view
+amqp::internal::binding::
+readEnum (pn_data_t * data_) {
+    enter (data_);
+    expect (data_, PN_LIST);
+
+    pn_data_enter (data_);
+    pn_data_next (data_);
+
+    auto rtn = readString (data_);
+
+    pn_data_exit (data_);
+    pn_data_exit (data_);
+    pn_data_next (data_);
+
+    return rtn;
+}
+
+/******************************************************************************/
@@ -0,0 +1,494 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <array>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <typeindex>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include <proton/codec.h>
+
+#include "types.h"
+
+#include "amqp/Symbols.h"
+#include "amqp/reader/References.h"
+#include "amqp/schema/described-types/Schema.h"
+
+/******************************************************************************
+ *
+ * Binding Corda types straight to C++ structs
+ *
+ * Rather than a tree of values or a string we can have a blob decoded
+ * into a struct of our own by telling the decoder which of its members
+ * are which properties. For a class
+ *
+ *      data class Foo (val a : Int, val b : List<String>, val c : Bar)
+ *
+ * that'd be
+ *
+ *      struct Foo {
+ *          int32_t a;
+ *          std::vector<std::string> b;
+ *          Bar c;
+ *      };
+ *
+ *      template<>
+ *      struct amqp::internal::binding::Binding<Foo> {
+ *          static constexpr auto fields = std::make_tuple (
+ *              field ("a", &Foo::a),
+ *              field ("b", &Foo::b),
+ *              field ("c", &Foo::c));
+ *      };
+ *
+ * with Bar bound the same way, after which [read<Foo>] hands back a Foo.
+ *
+ * Members can be int32_t, int64_t, bool, double, std::string (which will
+ * also take the name of an enum), std::vector and std::map of those, or
+ * another bound struct. Properties the struct doesn't bind are skipped and
+ * members the blob doesn't have are left as they were constructed.
+ *
+ * Which property is which member is worked out against the schema the
+ * first time each thread sees a class with a given fingerprint, after that
+ * reading an instance is a walk over the blob with a call per property.
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::binding {
+
+    template<class C, class M>
+    struct Field {
+        std::string_view name;
+        M C::* member;
+    };
+
+    template<class C, class M>
+    constexpr Field<C, M>
+    field (std::string_view name_, M C::* member_) {
+        return { name_, member_ };
+    }
+
+    /**
+     * Specialise for each struct to be bound, [fields] being a tuple of
+     * [field]s
+     */
+    template<class T>
+    struct Binding;
+
+    template<class T, class = void>
+    struct isBound : std::false_type { };
+
+    template<class T>
+    struct isBound<T, std::void_t<decltype (Binding<T>::fields)>>
+        : std::true_type { };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::binding::Context
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::binding {
+
+    /**
+     * What a single decode needs to hand around, the schema of the blob
+     * and everything decoded so far that could be referred to, see
+     * [reader::References] for what can be. Since values are decoded in
+     * place where they're going to live, vectors being sized before any
+     * element is read, the addresses we keep stay good for the whole of
+     * the decode.
+     */
+    class Context {
+        private :
+            const schema::Schema & m_schema;
+            sVec<std::pair<const void *, std::type_index>> m_history;
+
+            [[noreturn]] static void badReference (uint32_t);
+
+        public :
+            explicit Context (const schema::Schema & schema_)
+                : m_schema (schema_)
+            { }
+
+            const schema::Schema & schema() const { return m_schema; }
+
+            template<class M>
+            void record (const M & value_) {
+                m_history.emplace_back (&value_, typeid (M));
+            }
+
+            /**
+             * Something that could be referred to but which we skipped
+             * over rather than decode
+             */
+            void skipped() {
+                m_history.emplace_back (nullptr, typeid (void));
+            }
+
+            template<class M>
+            const M &
+            resolve (uint32_t index_) const {
+                if (index_ >= m_history.size()
+                    || m_history[index_].second != typeid (M))
+                {
+                    badReference (index_);
+                }
+
+                return *static_cast<const M *> (m_history[index_].first);
+            }
+    };
+
+}
+
+/******************************************************************************
+ *
+ * The non template parts, see Binding.cxx
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::binding {
+
+    void expect (pn_data_t *, pn_type_t);
+
+    /**
+     * With [data_] on a described value enter it, returning the interned
+     * descriptor, and move onto its body
+     */
+    Symbols::id_t enter (pn_data_t * data_);
+
+    /**
+     * Move past the value [data_] is on, noting anything in it that could
+     * later be referred to
+     */
+    void skip (pn_data_t * data_, Context &, bool element_);
+
+    /**
+     * Where each property of the class described by [descriptor_] goes,
+     * the index into [names_] of the member it's bound to or -1 if it
+     * isn't. Anything bound to a primitive property has to be the right
+     * primitive, [primitives_] has the type each member expects, empty if
+     * it's not a primitive.
+     */
+    sVec<int> resolve (
+        const schema::Schema &,
+        Symbols::id_t descriptor_,
+        const std::string_view * names_,
+        const std::string_view * primitives_,
+        size_t);
+
+    /**
+     * Find the schema and the blob in the envelope [data_] is sitting on
+     * and hand both to [f_]
+     */
+    void blob (
+        pn_data_t * data_,
+        const std::function<void (const schema::Schema &)> & f_);
+
+    std::string_view readString (pn_data_t *);
+    std::string_view readEnum (pn_data_t *);
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::binding::Extract
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::binding {
+
+    template<class M, class = void>
+    struct Extract;
+
+    /**
+     * Decode into [value_] whatever [data_] is on and move past it,
+     * returning whether it's something that could be referred to later.
+     * Anything described can be, and be a reference back to something
+     * already decoded, as can a string that's an element of a collection.
+     * A null leaves [value_] as it was.
+     */
+    template<class M>
+    bool
+    decode (M & value_, pn_data_t * data_, Context & context_, bool element_) {
+        switch (pn_data_type (data_)) {
+            case PN_NULL : {
+                pn_data_next (data_);
+                return false;
+            }
+            case PN_DESCRIBED : {
+                pn_data_enter (data_);
+                pn_data_next (data_);
+
+                auto index = reader::References::index (data_);
+
+                pn_data_exit (data_);
+
+                if (index) {
+                    pn_data_next (data_);
+                    value_ = context_.template resolve<M> (*index);
+                    return false;
+                }
+
+                Extract<M>::read (value_, data_, context_);
+                return true;
+            }
+            default : {
+                Extract<M>::read (value_, data_, context_);
+                return element_ && std::is_same_v<M, std::string>;
+            }
+        }
+    }
+
+    template<class M>
+    void
+    value (M & value_, pn_data_t * data_, Context & context_, bool element_) {
+        if (decode (value_, data_, context_, element_)) {
+            context_.record (value_);
+        }
+    }
+
+    template<class M, pn_type_t type_, auto get_>
+    struct Primitive {
+        static void read (M & value_, pn_data_t * data_, Context &) {
+            expect (data_, type_);
+            value_ = get_ (data_);
+            pn_data_next (data_);
+        }
+    };
+
+    template<>
+    struct Extract<int32_t>
+        : Primitive<int32_t, PN_INT, &pn_data_get_int>
+    {
+        static constexpr std::string_view primitive { "int" };
+    };
+
+    template<>
+    struct Extract<int64_t>
+        : Primitive<int64_t, PN_LONG, &pn_data_get_long>
+    {
+        static constexpr std::string_view primitive { "long" };
+    };
+
+    template<>
+    struct Extract<bool>
+        : Primitive<bool, PN_BOOL, &pn_data_get_bool>
+    {
+        static constexpr std::string_view primitive { "boolean" };
+    };
+
+    template<>
+    struct Extract<double>
+        : Primitive<double, PN_DOUBLE, &pn_data_get_double>
+    {
+        static constexpr std::string_view primitive { "double" };
+    };
+
+    /**
+     * A string, or the name of an enum
+     */
+    template<>
+    struct Extract<std::string> {
+        static constexpr std::string_view primitive { "string" };
+
+        static void read (std::string & value_, pn_data_t * data_, Context &) {
+            value_ = pn_data_type (data_) == PN_DESCRIBED
+                ? readEnum (data_)
+                : readString (data_);
+        }
+    };
+
+    template<class E>
+    struct Extract<std::vector<E>> {
+        static constexpr std::string_view primitive { };
+
+        static void read (std::vector<E> & value_, pn_data_t * data_, Context & context_) {
+            enter (data_);
+            expect (data_, PN_LIST);
+
+            auto elements = pn_data_get_list (data_);
+
+            value_.clear();
+            value_.resize (elements);
+
+            pn_data_enter (data_);
+            pn_data_next (data_);
+
+            for (auto & element : value_) {
+                binding::value (element, data_, context_, true);
+            }
+
+            pn_data_exit (data_);
+            pn_data_exit (data_);
+            pn_data_next (data_);
+        }
+    };
+
+    template<class K, class V>
+    struct Extract<std::map<K, V>> {
+        static constexpr std::string_view primitive { };
+
+        static void read (std::map<K, V> & value_, pn_data_t * data_, Context & context_) {
+            enter (data_);
+            expect (data_, PN_MAP);
+
+            auto entries = pn_data_get_map (data_) / 2;
+
+            value_.clear();
+
+            pn_data_enter (data_);
+            pn_data_next (data_);
+
+            for (size_t i { 0 } ; i < entries ; ++i) {
+                // the key's recorded once it's found its home in the map
+                K key { };
+                auto referable = decode (key, data_, context_, true);
+
+                auto it = value_.try_emplace (std::move (key)).first;
+
+                if (referable) {
+                    context_.record (it->first);
+                }
+
+                binding::value (it->second, data_, context_, true);
+            }
+
+            pn_data_exit (data_);
+            pn_data_exit (data_);
+            pn_data_next (data_);
+        }
+    };
+
+    /**
+     * A struct bound with [Binding]
+     */
+    template<class T>
+    struct Extract<T, std::enable_if_t<isBound<T>::value>> {
+        private :
+            using Setter = void (*)(T &, pn_data_t *, Context &);
+
+            static constexpr size_t size {
+                std::tuple_size_v<std::decay_t<decltype (Binding<T>::fields)>> };
+
+            template<size_t I>
+            static void
+            set (T & value_, pn_data_t * data_, Context & context_) {
+                auto member = std::get<I> (Binding<T>::fields).member;
+                binding::value (value_.*member, data_, context_, false);
+            }
+
+            template<size_t... I>
+            static constexpr auto
+            names (std::index_sequence<I...>) {
+                return std::array<std::string_view, size> {
+                    std::get<I> (Binding<T>::fields).name... };
+            }
+
+            template<size_t... I>
+            static constexpr auto
+            primitives (std::index_sequence<I...>) {
+                return std::array<std::string_view, size> {
+                    Extract<std::decay_t<decltype (
+                        std::declval<T &>().*(std::get<I> (Binding<T>::fields).member))>
+                    >::primitive... };
+            }
+
+            template<size_t... I>
+            static constexpr auto
+            setters (std::index_sequence<I...>) {
+                return std::array<Setter, size> { &set<I>... };
+            }
+
+            /**
+             * Which member each property of the class with this descriptor
+             * is bound to, in the order they appear
+             */
+            static const sVec<int> &
+            plan (Symbols::id_t descriptor_, const Context & context_) {
+                static thread_local std::unordered_map<Symbols::id_t, sVec<int>> plans;
+
+                auto it = plans.find (descriptor_);
+
+                if (it == plans.end()) {
+                    static constexpr auto n = names (std::make_index_sequence<size>());
+                    static constexpr auto p = primitives (std::make_index_sequence<size>());
+
+                    it = plans.emplace (
+                        descriptor_,
+                        resolve (context_.schema(), descriptor_, n.data(), p.data(), size)).first;
+                }
+
+                return it->second;
+            }
+
+        public :
+            static constexpr std::string_view primitive { };
+
+            static void
+            read (T & value_, pn_data_t * data_, Context & context_) {
+                static constexpr auto s = setters (std::make_index_sequence<size>());
+
+                const auto & members = plan (enter (data_), context_);
+
+                expect (data_, PN_LIST);
+
+                if (pn_data_get_list (data_) != members.size()) {
+                    throw std::runtime_error (
+                            "Wrong number of properties for the class");
+                }
+
+                pn_data_enter (data_);
+                pn_data_next (data_);
+
+                for (auto member : members) {
+                    if (member < 0) {
+                        skip (data_, context_, false);
+                    } else {
+                        s[member] (value_, data_, context_);
+                    }
+                }
+
+                pn_data_exit (data_);
+                pn_data_exit (data_);
+                pn_data_next (data_);
+            }
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::binding {
+
+    /**
+     * Decode the blob in the envelope [data_] is sitting on, as it would
+     * be after decoding the body of a Corda blob, into a [T]
+     */
+    template<class T>
+    T
+    read (pn_data_t * data_) {
+        static_assert (isBound<T>::value, "Blobs can only be read into bound types");
+
+        T rtn { };
+
+        blob (data_, [&](const schema::Schema & schema_) {
+            Context context (schema_);
+            Extract<T>::read (rtn, data_, context);
+        });
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
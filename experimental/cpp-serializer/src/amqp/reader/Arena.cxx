@@ -0,0 +1,64 @@
+#include "Arena.h"
+
+/******************************************************************************/
+
+namespace {
+
+    thread_local std::pmr::memory_resource * current { nullptr };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Arena
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+Arena::Arena (size_t size_)
+    : m_initial { new std::byte[size_] }
+    , m_resource { m_initial.get(), size_ }
+{ }
+
+/******************************************************************************/
+
+/**
+ * Release everything allocated since the last reset, anything that grew
+ * beyond the initial buffer goes back to the heap and we start again at
+ * the front of it
+ */
+void
+amqp::internal::reader::
+Arena::reset() {
+    m_resource.release();
+}
+
+/******************************************************************************/
+
+std::pmr::memory_resource *
+amqp::internal::reader::
+Arena::current() {
+    return ::current ? ::current : std::pmr::new_delete_resource();
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Arena::Scope
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+Arena::Scope::Scope (Arena & arena_)
+    : m_previous { ::current }
+{
+    ::current = arena_.resource();
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::
+Arena::Scope::~Scope() {
+    ::current = m_previous;
+}
+
+/******************************************************************************/
@@ -0,0 +1,111 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <memory>
+#include <utility>
+#include <string_view>
+#include <memory_resource>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * Everything a reader allocates while dumping a blob, the value nodes
+     * along with their strings and child containers, comes from the arena
+     * active on the calling thread. The arena is a monotonic buffer so
+     * allocating is a pointer bump, freeing does nothing and the lot is
+     * handed back at once when the arena is reset or destroyed.
+     *
+     * With no arena active allocations go to the heap as normal.
+     *
+     * Keep an arena per thread and reset it between blobs, that way a
+     * steady stream of decodes never goes near the global allocator.
+     */
+    class Arena {
+        private :
+            uPtr<std::byte[]> m_initial;
+            std::pmr::monotonic_buffer_resource m_resource;
+
+        public :
+            static constexpr size_t defaultSize { 64 * 1024 };
+
+            explicit Arena (size_t = defaultSize);
+
+            Arena (const Arena &) = delete;
+            Arena & operator = (const Arena &) = delete;
+
+            std::pmr::memory_resource * resource() { return & m_resource; }
+
+            void reset();
+
+            /**
+             * The arena active on this thread, or the heap if there isn't one
+             */
+            static std::pmr::memory_resource * current();
+
+            /**
+             * Make an arena the current one for as long as this is in scope
+             */
+            class Scope {
+                private :
+                    std::pmr::memory_resource * m_previous;
+
+                public :
+                    explicit Scope (Arena &);
+                    ~Scope();
+
+                    Scope (const Scope &) = delete;
+                    Scope & operator = (const Scope &) = delete;
+            };
+    };
+
+    /**
+     * A string allocated from the current arena
+     */
+    inline pmrString
+    arenaString (std::string_view str_) {
+        return pmrString (str_.begin(), str_.end(), Arena::current());
+    }
+
+    /**
+     * A value tree along with the arena it was built in. Since every part
+     * of the tree lives in the arena dropping it doesn't walk the tree, the
+     * nodes are never individually destroyed and the arena is released in
+     * one go.
+     */
+    template<class T>
+    class ArenaPtr {
+        private :
+            uPtr<Arena> m_arena;
+            T * m_value;
+
+        public :
+            ArenaPtr (uPtr<Arena> arena_, uPtr<T> value_)
+                : m_arena (std::move (arena_))
+                , m_value (value_.release())
+            { }
+
+            ArenaPtr (ArenaPtr && other_) noexcept
+                : m_arena (std::move (other_.m_arena))
+                , m_value (std::exchange (other_.m_value, nullptr))
+            { }
+
+            ArenaPtr & operator = (ArenaPtr && other_) noexcept {
+                m_arena = std::move (other_.m_arena);
+                m_value = std::exchange (other_.m_value, nullptr);
+
+                return *this;
+            }
+
+            const T & operator * () const { return *m_value; }
+            const T * operator -> () const { return m_value; }
+            const T * get() const { return m_value; }
+    };
+
+}
+
+/******************************************************************************/
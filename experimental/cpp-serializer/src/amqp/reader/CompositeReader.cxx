@@ -8,8 +8,11 @@
 #include <sstream>
 #include "debug.h"
 #include "Reader.h"
+#include "amqp/Symbols.h"
 #include "amqp/reader/IReader.h"
 #include "proton/proton_wrapper.h"
+#include "amqp/reader/References.h"
+#include "amqp/writer/JsonWriter.h"
 
 /******************************************************************************/
 
@@ -19,6 +22,30 @@ CompositeReader::m_name { // NOLINT
     "Composite Reader"
 };
 
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Where the properties an evolution drops are written
+     */
+    class Discard : public amqp::writer::IWriter {
+        public :
+            void beginObject() override { }
+            void endObject() override { }
+            void beginArray() override { }
+            void endArray() override { }
+            void key (std::string_view) override { }
+            void string (std::string_view) override { }
+            void integer (int64_t) override { }
+            void unsignedInteger (uint64_t) override { }
+            void floating (double) override { }
+            void boolean (bool) override { }
+            void null() override { }
+    };
+
+}
+
 /******************************************************************************
  *
  *
@@ -27,17 +54,15 @@ CompositeReader::m_name { // NOLINT
 amqp::internal::reader::
 CompositeReader::CompositeReader (
         std::string type_,
-        sVec<std::weak_ptr<Reader>> & readers_
-) : m_readers (readers_)
+        const ReaderTable & table_,
+        sVec<ReaderTable::Index> readers_,
+        sPtr<const Plan> plan_
+) : m_table (table_)
+  , m_readers (std::move (readers_))
+  , m_plan (std::move (plan_))
   , m_type (std::move (type_))
 {
     DBG ("MAKE CompositeReader: " << m_type << ": " << m_readers.size() << std::endl); // NOLINT
-    for (auto const reader : m_readers) {
-        assert (reader.lock());
-        if (auto r = reader.lock()) {
-            DBG ("  prop: " << r->name() << " " << r->type() << std::endl); // NOLINT
-        }
-    }
 }
 
 /******************************************************************************/
@@ -78,7 +103,7 @@ CompositeReader::readString (pn_data_t * data_) const {
 /******************************************************************************/
 
 
-sVec<uPtr<amqp::reader::IValue>>
+pmrVec<uPtr<amqp::reader::IValue>>
 amqp::internal::reader::
 CompositeReader::_dump (
         pn_data_t * data_,
@@ -94,7 +119,7 @@ CompositeReader::_dump (
     proton::auto_enter ae (data_);
 
     const auto & it = schema_.fromDescriptor (
-            proton::get_symbol<std::string>(data_));
+            Symbols::find (proton::get_symbol<pn_bytes_t>(data_)));
 
     auto & fields = dynamic_cast<schema::Composite &> (
             *(it->second.get())).fields();
@@ -103,27 +128,38 @@ CompositeReader::_dump (
 
     pn_data_next (data_);
 
-    sVec<uPtr<amqp::reader::IValue>> read;
-    read.reserve (fields.size());
+    pmrVec<uPtr<amqp::reader::IValue>> read { Arena::current() };
+    read.reserve (fields.size() + (m_plan ? m_plan->missing.size() : 0));
 
     proton::is_list (data_);
     {
         proton::auto_enter ae (data_);
 
-        for (int i (0) ; i < m_readers.size() ; ++i) {
-            if (auto l =  m_readers[i].lock()) {
-                DBG (fields[i]->name() << " "
-                    << (l ? "true" : "false") << std::endl); // NOLINT
+        for (size_t i (0) ; i < m_readers.size() ; ++i) {
+            DBG (fields[i]->name() << std::endl); // NOLINT
 
-                read.emplace_back (l->dump (fields[i]->name(), data_, schema_));
+            auto value = m_table[m_readers[i]].dump (
+                    fields[i]->name(), data_, schema_);
+
+            if (m_plan && !m_plan->keep[i]) {
+                References::drop (std::move (value));
             } else {
-                std::stringstream s;
-                s << "null field reader: " << fields[i]->name();
-                throw std::runtime_error (s.str());
+                read.emplace_back (std::move (value));
             }
         }
     }
 
+    if (m_plan) {
+        for (const auto & missing : m_plan->missing) {
+            // written as it would be were it on the wire
+            writer::JsonWriter writer;
+            missing.write (writer);
+
+            read.emplace_back (std::make_unique<TypedPair<pmrString>> (
+                    missing.name, arenaString (writer.take())));
+        }
+    }
+
     return read;
 }
 
@@ -136,11 +172,15 @@ CompositeReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    if (auto ref = References::resolve (name_, data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+    return References::record (std::make_unique<TypedPair<pmrVec<uPtr<amqp::reader::IValue>>>> (
         name_,
-        _dump(data_, schema_));
+        _dump(data_, schema_)));
 }
 
 /******************************************************************************/
@@ -154,11 +194,67 @@ CompositeReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    if (auto ref = References::resolve (data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>> (
-        _dump (data_, schema_));
+    return References::record (std::make_unique<TypedSingle<pmrVec<uPtr<amqp::reader::IValue>>>> (
+        _dump (data_, schema_)));
 }
 
 /******************************************************************************/
 
+
+void
+amqp::internal::reader::
+CompositeReader::write (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::writer::IWriter & writer_) const
+{
+    proton::auto_next an (data_);
+
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    const auto & it = schema_.fromDescriptor (
+            Symbols::find (proton::get_symbol<pn_bytes_t>(data_)));
+
+    auto & fields = dynamic_cast<schema::Composite &> (
+            *(it->second.get())).fields();
+
+    assert (fields.size() == m_readers.size());
+
+    pn_data_next (data_);
+
+    proton::is_list (data_);
+    {
+        proton::auto_enter ae (data_);
+
+        writer_.beginObject();
+
+        for (size_t i (0) ; i < m_readers.size() ; ++i) {
+            if (m_plan && !m_plan->keep[i]) {
+                Discard discard;
+                m_table[m_readers[i]].write (data_, schema_, discard);
+                continue;
+            }
+
+            writer_.key (fields[i]->name());
+            m_table[m_readers[i]].write (data_, schema_, writer_);
+        }
+
+        if (m_plan) {
+            for (const auto & missing : m_plan->missing) {
+                writer_.key (missing.name);
+                missing.write (writer_);
+            }
+        }
+
+        writer_.endObject();
+    }
+}
+
+/******************************************************************************/
@@ -3,6 +3,8 @@
 /******************************************************************************/
 
 #include "Reader.h"
+#include "Evolution.h"
+#include "ReaderTable.h"
 
 #include <any>
 #include <vector>
@@ -15,7 +17,13 @@ namespace amqp::internal::reader {
 
     class CompositeReader : public Reader {
         private :
-            std::vector<std::weak_ptr<Reader>> m_readers;
+            // the readers of our fields, in order
+            const ReaderTable & m_table;
+            std::vector<ReaderTable::Index> m_readers;
+
+            // how to read us as the version of our type we're evolving
+            // to, if we are
+            sPtr<const Plan> m_plan;
 
             static const std::string m_name;
 
@@ -24,7 +32,9 @@ namespace amqp::internal::reader {
         public :
             CompositeReader (
                 std::string,
-                std::vector<std::weak_ptr<Reader>> &);
+                const ReaderTable &,
+                std::vector<ReaderTable::Index>,
+                sPtr<const Plan> = nullptr);
 
             ~CompositeReader() override = default;
 
@@ -41,11 +51,16 @@ namespace amqp::internal::reader {
                 pn_data_t *,
                 const SchemaType &) const override;
 
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &) const override;
+
             const std::string & name() const override;
             const std::string & type() const override;
 
         private :
-            std::vector<std::unique_ptr<amqp::reader::IValue>> _dump (
+            pmrVec<uPtr<amqp::reader::IValue>> _dump (
                 pn_data_t *,
                 const SchemaType &) const;
     };
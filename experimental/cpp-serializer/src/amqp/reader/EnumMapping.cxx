@@ -0,0 +1,134 @@
+#include "EnumMapping.h"
+
+#include "debug.h"
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::EnumMapping
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+EnumMapping::EnumMapping()
+    : m_table { nullptr }
+{
+    m_tables.push_back (std::make_unique<Table>());
+    m_table.store (m_tables.back().get(), std::memory_order_release);
+}
+
+/******************************************************************************/
+
+/**
+ * A constant is renamed for as long as there's a rename from it, then
+ * if it's not one of [constants_] defaults for as long as there's a
+ * default from it. Bounded by how many of each there are so a cycle,
+ * which Corda wouldn't let anyone write, can't loop forever.
+ */
+void
+amqp::internal::reader::
+EnumMapping::evolve (
+    const std::vector<std::string> & constants_,
+    const std::vector<schema::Transform> & transforms_
+) {
+    std::map<std::string, std::string> renames;
+    std::map<std::string, std::string> defaults;
+
+    for (const auto & transform : transforms_) {
+        switch (transform.kind()) {
+            case schema::Transform::Kind::Rename :
+                renames[transform.from()] = transform.to();
+                break;
+            case schema::Transform::Kind::EnumDefault :
+                defaults[transform.from()] = transform.to();
+                break;
+            default :
+                break;
+        }
+    }
+
+    std::set<std::string_view> known (constants_.begin(), constants_.end());
+
+    /*
+     * Where following [links_] from [constant_] gets us, stopping early
+     * at anything in [stop_]
+     */
+    auto follow = [](
+        const std::map<std::string, std::string> & links_,
+        std::string_view constant_,
+        const std::set<std::string_view> & stop_
+    ) {
+        for (size_t i { 0 } ; i < links_.size() && !stop_.count (constant_) ; ++i) {
+            auto it = links_.find (std::string (constant_));
+
+            if (it == links_.end()) {
+                break;
+            }
+
+            constant_ = it->second;
+        }
+
+        return constant_;
+    };
+
+    auto table = std::make_unique<Table>();
+
+    auto name = [&table](std::string_view constant_) -> std::string_view {
+        return *table->names.emplace (constant_).first;
+    };
+
+    for (const auto * links : { &renames, &defaults }) {
+        for (const auto & link : *links) {
+            auto as = follow (defaults, follow (renames, link.first, { }), known);
+
+            if (as != link.first) {
+                DBG ("EnumMapping: " << link.first << " -> " << as << std::endl); // NOLINT
+                table->as[name (link.first)] = name (as);
+            }
+        }
+    }
+
+    m_tables.push_back (std::move (table));
+    m_table.store (m_tables.back().get(), std::memory_order_release);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::EnumMappings
+ *
+ ******************************************************************************/
+
+sPtr<const amqp::internal::reader::EnumMapping>
+amqp::internal::reader::
+EnumMappings::operator[] (const std::string & type_) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    auto & mapping = m_mappings[type_];
+
+    if (!mapping) {
+        mapping = std::make_shared<EnumMapping>();
+    }
+
+    return mapping;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+EnumMappings::evolve (
+    const std::string & type_,
+    const std::vector<std::string> & constants_,
+    const std::vector<schema::Transform> & transforms_
+) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    auto & mapping = m_mappings[type_];
+
+    if (!mapping) {
+        mapping = std::make_shared<EnumMapping>();
+    }
+
+    mapping->evolve (constants_, transforms_);
+}
+
+/******************************************************************************/
@@ -0,0 +1,102 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <string_view>
+#include <unordered_map>
+
+#include "types.h"
+
+#include "amqp/schema/described-types/Transforms.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * What each constant of an enum should be read as given how the enum
+     * has evolved, so blobs written by older versions of a CorDapp read
+     * with their constants as they're named now.
+     *
+     * Corda records every rename, and a default for every constant added,
+     * in the transforms section of anything written with the enum, see
+     * [schema::Transforms]. We compile the transforms of the version we've
+     * been told to read it as, see [ReaderCache::evolveTo], into a table
+     * of every constant that reads as something else. Only ever from that
+     * and never from the blobs we happen to read, so a blob reads the same
+     * whatever was read before it. Until we've been told of one the table
+     * is empty and mapping a constant costs nothing, after that it's a
+     * single hash lookup.
+     *
+     * Lookups are lock free. Another version publishes a new table, the
+     * old being kept for as long as the mapping is.
+     */
+    class EnumMapping {
+        private :
+            struct Table {
+                std::set<std::string, std::less<>> names;
+                std::unordered_map<std::string_view, std::string_view> as;
+            };
+
+            std::atomic<const Table *> m_table;
+            std::vector<uPtr<const Table>> m_tables;
+
+        public :
+            EnumMapping();
+
+            EnumMapping (const EnumMapping &) = delete;
+            EnumMapping & operator = (const EnumMapping &) = delete;
+
+            /**
+             * Compile [transforms_] for the version of the enum with
+             * [constants_], replacing whatever we had. Only one thread at
+             * a time, see [EnumMappings::evolve]
+             */
+            void evolve (
+                const std::vector<std::string> & constants_,
+                const std::vector<schema::Transform> & transforms_);
+
+            std::string_view operator() (std::string_view constant_) const {
+                const auto & as = m_table.load (std::memory_order_acquire)->as;
+
+                if (as.empty()) {
+                    return constant_;
+                }
+
+                auto it = as.find (constant_);
+
+                return it == as.end() ? constant_ : it->second;
+            }
+    };
+
+    /**
+     * Every enum's mapping by its type name. Shared between factories, see
+     * [ReaderCache], so a target given once applies to every blob we read
+     * the enum from.
+     */
+    class EnumMappings {
+        private :
+            std::mutex m_lock;
+            std::map<std::string, sPtr<EnumMapping>> m_mappings;
+
+        public :
+            /**
+             * The mapping for the enum named [type_]
+             */
+            sPtr<const EnumMapping> operator[] (const std::string & type_);
+
+            void evolve (
+                const std::string & type_,
+                const std::vector<std::string> & constants_,
+                const std::vector<schema::Transform> & transforms_);
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,259 @@
+#include "Evolution.h"
+
+#include <cerrno>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+
+#include <proton/codec.h>
+
+#include "debug.h"
+#include "Primitives.h"
+
+#include "amqp/schema/field-types/Field.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string &
+    typeOf (const amqp::internal::schema::Field & field_) {
+        return field_.primitive() ? field_.type() : field_.resolvedType();
+    }
+
+    /**
+     * The whole of [value_] as a number, strto* skipping leading space
+     * and stopping at whatever doesn't parse
+     */
+    template<typename T, typename F>
+    bool
+    number (const std::string & value_, T & number_, F f_) {
+        if (value_.empty() || std::isspace (static_cast<unsigned char> (value_[0]))) {
+            return false;
+        }
+
+        char * end;
+        errno = 0;
+        number_ = f_ (value_.c_str(), &end);
+
+        return errno == 0 && *end == '\0';
+    }
+
+    /**
+     * The default [value_] of a property of [type_] as what a value of
+     * that type is written as, see [Primitives]. False if it isn't a
+     * value of that type at all.
+     */
+    bool
+    defaultOf (
+        const std::string & type_,
+        const std::string & value_,
+        amqp::internal::reader::Plan::Missing::Value & rtn_
+    ) {
+        switch (amqp::internal::reader::Primitives::code (type_)) {
+            case PN_BOOL : {
+                rtn_ = value_ == "true";
+                return value_ == "true" || value_ == "false";
+            }
+            case PN_BYTE  :
+            case PN_SHORT :
+            case PN_INT   :
+            case PN_LONG  :
+            case PN_TIMESTAMP : {
+                int64_t value;
+                auto rtn = number (value_, value, [](auto s_, auto e_) {
+                    return std::strtoll (s_, e_, 10); });
+                rtn_ = value;
+                return rtn;
+            }
+            case PN_UBYTE  :
+            case PN_USHORT :
+            case PN_UINT   :
+            case PN_ULONG  : {
+                // strtoull takes a minus sign, negating what follows it
+                uint64_t value;
+                auto rtn = value_[0] != '-'
+                    && number (value_, value, [](auto s_, auto e_) {
+                        return std::strtoull (s_, e_, 10); });
+                rtn_ = value;
+                return rtn;
+            }
+            case PN_FLOAT  :
+            case PN_DOUBLE : {
+                double value;
+                auto rtn = number (value_, value, [](auto s_, auto e_) {
+                    return std::strtod (s_, e_); });
+                rtn_ = value;
+                return rtn;
+            }
+            default : {
+                rtn_ = value_;
+                return true;
+            }
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Plan::Missing
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::reader::
+Plan::Missing::write (amqp::writer::IWriter & writer_) const {
+    std::visit ([&writer_](const auto & value_) {
+        using T = std::decay_t<decltype (value_)>;
+
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            writer_.null();
+        } else if constexpr (std::is_same_v<T, bool>) {
+            writer_.boolean (value_);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            writer_.integer (value_);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            writer_.unsignedInteger (value_);
+        } else if constexpr (std::is_same_v<T, double>) {
+            writer_.floating (value_);
+        } else {
+            writer_.string (value_);
+        }
+    }, value);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Evolution
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::reader::
+Evolution::target (const schema::Schema & schema_) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    for (const auto & i : schema_) {
+        for (const auto & j : i) {
+            auto composite = dynamic_cast<const schema::Composite *> (j.get());
+
+            if (!composite) {
+                continue;
+            }
+
+            Target target { composite->descriptor(), { } };
+
+            for (const auto & field : composite->fields()) {
+                target.properties.push_back ({
+                    field->name(),
+                    typeOf (*field),
+                    field->defaultValue(),
+                    field->mandatory() });
+            }
+
+            DBG ("Evolution: target " << composite->name() << std::endl); // NOLINT
+
+            m_targets[composite->name()] = std::move (target);
+        }
+    }
+}
+
+/******************************************************************************/
+
+sPtr<const amqp::internal::reader::Plan>
+amqp::internal::reader::
+Evolution::plan (const schema::Composite & composite_) {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    auto target = m_targets.find (composite_.name());
+
+    if (target == m_targets.end()
+        || target->second.descriptor == composite_.descriptor())
+    {
+        return nullptr;
+    }
+
+    auto key = std::make_pair (composite_.descriptor(), target->second.descriptor);
+    auto planned = m_plans.find (key);
+
+    if (planned != m_plans.end()) {
+        return planned->second;
+    }
+
+    const auto & fields = composite_.fields();
+    const auto & properties = target->second.properties;
+
+    auto rtn = std::make_shared<Plan>();
+    rtn->keep.reserve (fields.size());
+
+    sVec<bool> written (properties.size(), false);
+    bool same { fields.size() == properties.size() };
+
+    for (size_t i { 0 } ; i < fields.size() ; ++i) {
+        size_t j { 0 };
+
+        while (j < properties.size() && properties[j].name != fields[i]->name()) {
+            ++j;
+        }
+
+        if (j == properties.size()) {
+            DBG ("Evolution: drop " << fields[i]->name() << std::endl); // NOLINT
+            rtn->keep.push_back (false);
+            same = false;
+            continue;
+        }
+
+        if (properties[j].type != typeOf (*fields[i])) {
+            throw std::runtime_error (
+                    "Can't evolve " + composite_.name() + ", "
+                    + fields[i]->name() + " was a " + typeOf (*fields[i])
+                    + " and is now a " + properties[j].type);
+        }
+
+        rtn->keep.push_back (true);
+        written[j] = true;
+    }
+
+    for (size_t j { 0 } ; j < properties.size() ; ++j) {
+        if (written[j]) {
+            continue;
+        }
+
+        const auto & property = properties[j];
+
+        if (property.mandatory && property.value.empty()) {
+            throw std::runtime_error (
+                    "Can't evolve " + composite_.name() + ", "
+                    + property.name + " is mandatory and has no default");
+        }
+
+        DBG ("Evolution: fill " << property.name << std::endl); // NOLINT
+
+        Plan::Missing missing { property.name, property.type, nullptr };
+
+        if (!property.value.empty()
+            && !defaultOf (property.type, property.value, missing.value))
+        {
+            throw std::runtime_error (
+                    "Can't evolve " + composite_.name() + ", "
+                    + property.name + "'s default " + property.value
+                    + " isn't a " + property.type);
+        }
+
+        rtn->missing.push_back (std::move (missing));
+    }
+
+    // a version whose fingerprint changed for anything other than what
+    // its properties are, their order included, reads as it is
+    if (same) {
+        rtn.reset();
+    }
+
+    return m_plans[key] = std::move (rtn);
+}
+
+/******************************************************************************/
@@ -0,0 +1,122 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <variant>
+
+#include "types.h"
+
+#include "amqp/writer/IWriter.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    class Schema;
+    class Composite;
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * How to read a composite written by one version of its type as
+     * another, the version of it we're told of by [Evolution::target].
+     * One bool per property on the wire and the target's properties that
+     * aren't, so reading an instance is a walk down a table rather than
+     * anything to do with names.
+     *
+     * Properties are written in the order they're on the wire, those the
+     * target doesn't have being dropped, with those it has that the wire
+     * doesn't after them. Never in the target's order, so a target that
+     * does no more than reorder its properties reads exactly as the wire
+     * and needs no plan at all.
+     */
+    struct Plan {
+        /**
+         * A property of the target that isn't on the wire and what it's
+         * read as, its default or if it doesn't have one null. A default
+         * is held as what a value of the property's type is written as,
+         * a number or boolean for the primitives written as one and a
+         * string for anything else.
+         */
+        struct Missing {
+            using Value = std::variant<
+                std::nullptr_t, bool, int64_t, uint64_t, double, std::string>;
+
+            std::string name;
+            std::string type;
+            Value value;
+
+            bool null() const {
+                return std::holds_alternative<std::nullptr_t> (value);
+            }
+
+            void write (amqp::writer::IWriter &) const;
+        };
+
+        // for each property on the wire whether the target has it
+        sVec<bool> keep;
+        sVec<Missing> missing;
+    };
+
+    /**
+     * Reads composites written by older, or newer, versions of their
+     * types as the version we have, that is the one in a schema we've
+     * been given as a [target]. Anything written by a version with more
+     * properties has those dropped and anything by one with fewer has
+     * them filled in from their defaults. Which is which is worked out
+     * once for each pair of versions, by fingerprint, and the [Plan]
+     * shared by every factory that reads that version.
+     *
+     * A property that's changed type, a mandatory one without a default
+     * missing, or one whose default isn't a value of its type, can't be
+     * evolved and is an error as soon as we try to plan for it.
+     *
+     * Targets have to be given before the readers of anything they're
+     * to apply to are built. Everything is behind a lock, planning only
+     * happening as a factory processes a schema.
+     */
+    class Evolution {
+        private :
+            struct Property {
+                std::string name;
+                std::string type;
+                std::string value;
+                bool mandatory;
+            };
+
+            struct Target {
+                std::string descriptor;
+                sVec<Property> properties;
+            };
+
+            std::mutex m_lock;
+
+            std::map<std::string, Target> m_targets;
+            std::map<std::pair<std::string, std::string>, sPtr<const Plan>> m_plans;
+
+        public :
+            /**
+             * Every composite in [schema_] is the version of its type we
+             * want to read, replacing any target we had for it
+             */
+            void target (const schema::Schema & schema_);
+
+            /**
+             * How to read [composite_] as its target, null if we haven't
+             * one or it's the version written
+             */
+            sPtr<const Plan> plan (const schema::Composite & composite_);
+    };
+
+}
+
+/******************************************************************************/
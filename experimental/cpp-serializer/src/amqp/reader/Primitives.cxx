@@ -0,0 +1,362 @@
+#include "Primitives.h"
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+/******************************************************************************/
+
+namespace {
+
+    using amqp::writer::IWriter;
+
+    struct Primitive {
+        std::string_view name;
+        std::any (*read) (pn_data_t *);
+        void (*write) (pn_data_t *, IWriter &);
+    };
+
+    /**
+     * Type codes run from PN_NULL to PN_MAP with PN_INVALID, -1, masked
+     * down to the last entry, so any type the codec gives us indexes the
+     * table without a bounds check
+     */
+    constexpr size_t size { 32 };
+
+    constexpr size_t
+    index (pn_type_t type_) {
+        return static_cast<size_t> (type_) & (size - 1);
+    }
+
+    [[noreturn]] void
+    notPrimitive (pn_data_t * data_) {
+        throw std::runtime_error (
+                std::string ("Expected a primitive but found ")
+                + pn_type_name (pn_data_type (data_)));
+    }
+
+    constexpr char hex[] = "0123456789abcdef";
+
+    /**
+     * The [n_] bytes from [bytes_] as hex digits into [out_]
+     */
+    char *
+    toHex (const unsigned char * bytes_, size_t n_, char * out_) {
+        for (size_t i { 0 } ; i < n_ ; ++i) {
+            *out_++ = hex[bytes_[i] >> 4U];
+            *out_++ = hex[bytes_[i] & 0xfU];
+        }
+
+        return out_;
+    }
+
+    template<typename T>
+    void
+    writeHex (T value_, IWriter & writer_) {
+        unsigned char bytes[sizeof (T)];
+
+        for (size_t i { 0 } ; i < sizeof (T) ; ++i) {
+            bytes[i] = static_cast<unsigned char> (value_ >> (8U * (sizeof (T) - i - 1)));
+        }
+
+        char buffer[2 * sizeof (T)];
+        writer_.formatted ({ buffer, static_cast<size_t> (toHex (bytes, sizeof (T), buffer) - buffer) });
+    }
+
+    void
+    writeChar (pn_char_t char_, IWriter & writer_) {
+        char buffer[4];
+        size_t n;
+
+        if (char_ < 0x80) {
+            buffer[0] = static_cast<char> (char_);
+            n = 1;
+        } else if (char_ < 0x800) {
+            buffer[0] = static_cast<char> (0xc0 | (char_ >> 6U));
+            buffer[1] = static_cast<char> (0x80 | (char_ & 0x3fU));
+            n = 2;
+        } else if (char_ < 0x10000) {
+            buffer[0] = static_cast<char> (0xe0 | (char_ >> 12U));
+            buffer[1] = static_cast<char> (0x80 | ((char_ >> 6U) & 0x3fU));
+            buffer[2] = static_cast<char> (0x80 | (char_ & 0x3fU));
+            n = 3;
+        } else {
+            buffer[0] = static_cast<char> (0xf0 | ((char_ >> 18U) & 0x07U));
+            buffer[1] = static_cast<char> (0x80 | ((char_ >> 12U) & 0x3fU));
+            buffer[2] = static_cast<char> (0x80 | ((char_ >> 6U) & 0x3fU));
+            buffer[3] = static_cast<char> (0x80 | (char_ & 0x3fU));
+            n = 4;
+        }
+
+        writer_.formatted ({ buffer, n });
+    }
+
+    void
+    writeUuid (const pn_uuid_t & uuid_, IWriter & writer_) {
+        auto bytes = reinterpret_cast<const unsigned char *> (uuid_.bytes);
+
+        char buffer[36];
+        char * out { buffer };
+
+        // the byte each group of the canonical form ends at
+        size_t i { 0 };
+
+        for (size_t end : { 4, 6, 8, 10, 16 }) {
+            if (i) {
+                *out++ = '-';
+            }
+
+            out = toHex (bytes + i, end - i, out);
+            i = end;
+        }
+
+        writer_.formatted ({ buffer, sizeof (buffer) });
+    }
+
+    void
+    writeBase64 (pn_bytes_t bytes_, IWriter & writer_) {
+        static constexpr char alphabet[] =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        static thread_local std::string buffer;
+
+        auto bytes = reinterpret_cast<const unsigned char *> (bytes_.start);
+
+        buffer.clear();
+        buffer.reserve ((bytes_.size + 2) / 3 * 4);
+
+        size_t i { 0 };
+
+        for ( ; i + 2 < bytes_.size ; i += 3) {
+            uint32_t n = (bytes[i] << 16U) | (bytes[i + 1] << 8U) | bytes[i + 2];
+
+            buffer.push_back (alphabet[(n >> 18U) & 0x3fU]);
+            buffer.push_back (alphabet[(n >> 12U) & 0x3fU]);
+            buffer.push_back (alphabet[(n >> 6U) & 0x3fU]);
+            buffer.push_back (alphabet[n & 0x3fU]);
+        }
+
+        if (i < bytes_.size) {
+            uint32_t n = bytes[i] << 16U;
+
+            if (i + 1 < bytes_.size) {
+                n |= bytes[i + 1] << 8U;
+            }
+
+            buffer.push_back (alphabet[(n >> 18U) & 0x3fU]);
+            buffer.push_back (alphabet[(n >> 12U) & 0x3fU]);
+            buffer.push_back (i + 1 < bytes_.size ? alphabet[(n >> 6U) & 0x3fU] : '=');
+            buffer.push_back ('=');
+        }
+
+        writer_.formatted (buffer);
+    }
+
+    std::string_view
+    view (pn_bytes_t bytes_) {
+        return { bytes_.start, bytes_.size };
+    }
+
+    /**
+     * Every entry reads the value and then moves past it
+     */
+    template<class F>
+    auto
+    next (pn_data_t * data_, F f_) {
+        auto rtn = f_ (data_);
+        pn_data_next (data_);
+        return rtn;
+    }
+
+    constexpr std::array<Primitive, size>
+    makeTable() {
+        // anything that isn't a primitive has neither a name nor a way
+        // to read it
+        std::array<Primitive, size> rtn { };
+
+        rtn[index (PN_NULL)] = {
+            "null",
+            [](pn_data_t * data_) { pn_data_next (data_); return std::any { }; },
+            [](pn_data_t * data_, IWriter & w_) { pn_data_next (data_); w_.null(); } };
+
+        rtn[index (PN_BOOL)] = {
+            "boolean",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_bool) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.boolean (next (data_, pn_data_get_bool)); } };
+
+        rtn[index (PN_UBYTE)] = {
+            "ubyte",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_ubyte) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.unsignedInteger (next (data_, pn_data_get_ubyte)); } };
+
+        rtn[index (PN_BYTE)] = {
+            "byte",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_byte) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.integer (next (data_, pn_data_get_byte)); } };
+
+        rtn[index (PN_USHORT)] = {
+            "ushort",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_ushort) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.unsignedInteger (next (data_, pn_data_get_ushort)); } };
+
+        rtn[index (PN_SHORT)] = {
+            "short",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_short) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.integer (next (data_, pn_data_get_short)); } };
+
+        rtn[index (PN_UINT)] = {
+            "uint",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_uint) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.unsignedInteger (next (data_, pn_data_get_uint)); } };
+
+        rtn[index (PN_INT)] = {
+            "int",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_int) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.integer (next (data_, pn_data_get_int)); } };
+
+        rtn[index (PN_CHAR)] = {
+            "char",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_char) }; },
+            [](pn_data_t * data_, IWriter & w_) { writeChar (next (data_, pn_data_get_char), w_); } };
+
+        rtn[index (PN_ULONG)] = {
+            "ulong",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_ulong) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.unsignedInteger (next (data_, pn_data_get_ulong)); } };
+
+        rtn[index (PN_LONG)] = {
+            "long",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_long) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.integer (next (data_, pn_data_get_long)); } };
+
+        rtn[index (PN_TIMESTAMP)] = {
+            "timestamp",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_timestamp) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.integer (next (data_, pn_data_get_timestamp)); } };
+
+        rtn[index (PN_FLOAT)] = {
+            "float",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_float) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.floating (next (data_, pn_data_get_float)); } };
+
+        rtn[index (PN_DOUBLE)] = {
+            "double",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_double) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.floating (next (data_, pn_data_get_double)); } };
+
+        rtn[index (PN_DECIMAL32)] = {
+            "decimal32",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_decimal32) }; },
+            [](pn_data_t * data_, IWriter & w_) { writeHex (next (data_, pn_data_get_decimal32), w_); } };
+
+        rtn[index (PN_DECIMAL64)] = {
+            "decimal64",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_decimal64) }; },
+            [](pn_data_t * data_, IWriter & w_) { writeHex (next (data_, pn_data_get_decimal64), w_); } };
+
+        rtn[index (PN_DECIMAL128)] = {
+            "decimal128",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_decimal128) }; },
+            [](pn_data_t * data_, IWriter & w_) {
+                auto value = next (data_, pn_data_get_decimal128);
+
+                char buffer[2 * sizeof (value.bytes)];
+                toHex (reinterpret_cast<const unsigned char *> (value.bytes), sizeof (value.bytes), buffer);
+
+                w_.formatted ({ buffer, sizeof (buffer) });
+            } };
+
+        rtn[index (PN_UUID)] = {
+            "uuid",
+            [](pn_data_t * data_) { return std::any { next (data_, pn_data_get_uuid) }; },
+            [](pn_data_t * data_, IWriter & w_) { writeUuid (next (data_, pn_data_get_uuid), w_); } };
+
+        rtn[index (PN_BINARY)] = {
+            "binary",
+            [](pn_data_t * data_) {
+                auto bytes = next (data_, pn_data_get_binary);
+                return std::any { std::string (bytes.start, bytes.size) };
+            },
+            [](pn_data_t * data_, IWriter & w_) { writeBase64 (next (data_, pn_data_get_binary), w_); } };
+
+        rtn[index (PN_STRING)] = {
+            "string",
+            [](pn_data_t * data_) { return std::any { std::string (view (next (data_, pn_data_get_string))) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.string (view (next (data_, pn_data_get_string))); } };
+
+        rtn[index (PN_SYMBOL)] = {
+            "symbol",
+            [](pn_data_t * data_) { return std::any { std::string (view (next (data_, pn_data_get_symbol))) }; },
+            [](pn_data_t * data_, IWriter & w_) { w_.string (view (next (data_, pn_data_get_symbol))); } };
+
+        return rtn;
+    }
+
+    constexpr std::array<Primitive, size> primitives = makeTable(); // NOLINT
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Primitives
+ *
+ ******************************************************************************/
+
+/**
+ * Only ever asked as readers are built, the table's small enough that a
+ * scan of it does
+ */
+pn_type_t
+amqp::internal::reader::
+Primitives::code (std::string_view type_) {
+    for (size_t i { 0 } ; i < primitives.size() ; ++i) {
+        if (!primitives[i].name.empty() && primitives[i].name == type_) {
+            return static_cast<pn_type_t> (i);
+        }
+    }
+
+    return PN_INVALID;
+}
+
+/******************************************************************************/
+
+std::any
+amqp::internal::reader::
+Primitives::read (pn_data_t * data_) {
+    auto read = primitives[index (pn_data_type (data_))].read;
+
+    if (!read) {
+        notPrimitive (data_);
+    }
+
+    return read (data_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+Primitives::write (pn_data_t * data_, amqp::writer::IWriter & writer_) {
+    if (!tryWrite (data_, writer_)) {
+        notPrimitive (data_);
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::reader::
+Primitives::tryWrite (pn_data_t * data_, amqp::writer::IWriter & writer_) {
+    auto write = primitives[index (pn_data_type (data_))].write;
+
+    if (!write) {
+        return false;
+    }
+
+    write (data_, writer_);
+
+    return true;
+}
+
+/******************************************************************************/
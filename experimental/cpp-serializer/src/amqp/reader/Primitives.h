@@ -0,0 +1,64 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <any>
+#include <string_view>
+
+#include <proton/codec.h>
+
+#include "amqp/writer/IWriter.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * How to read each of AMQP's primitives, from a table indexed by the
+     * type code the codec gives the value we're on. Picking the way to
+     * read a value is an array lookup whatever it is and, since it goes
+     * by what's on the wire rather than what the schema says, a boxed
+     * primitive that's null reads as null.
+     *
+     * Those that JSON has nothing for are written as strings
+     *
+     *  char                 the character, UTF-8 encoded
+     *  uuid                 in its canonical 8-4-4-4-12 hex form
+     *  binary               base64
+     *  decimal32/64/128     the hex digits of their IEEE 754 encoding
+     *
+     * with a timestamp written as the milliseconds since the epoch.
+     */
+    class Primitives {
+        public :
+            /**
+             * The type code of the primitive named [type_] in a schema,
+             * PN_INVALID if it isn't one
+             */
+            static pn_type_t code (std::string_view type_);
+
+            static bool isPrimitive (std::string_view type_) {
+                return code (type_) != PN_INVALID;
+            }
+
+            /**
+             * The value [data_] is on, as the C++ type the codec reads it
+             * as, and move past it
+             */
+            static std::any read (pn_data_t * data_);
+
+            /**
+             * Write the value [data_] is on and move past it
+             */
+            static void write (pn_data_t * data_, amqp::writer::IWriter &);
+
+            /**
+             * As [write] but false, without moving, rather than throwing
+             * if [data_] isn't on a primitive
+             */
+            static bool tryWrite (pn_data_t * data_, amqp::writer::IWriter &);
+    };
+
+}
+
+/******************************************************************************/
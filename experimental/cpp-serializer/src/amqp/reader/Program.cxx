@@ -0,0 +1,1329 @@
+#include "Program.h"
+
+#include <cctype>
+#include <charconv>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "debug.h"
+
+#include "proton/proton_wrapper.h"
+
+#include "Evolution.h"
+#include "Primitives.h"
+#include "References.h"
+#include "EnumMapping.h"
+#include "amqp/writer/Tape.h"
+
+#include "amqp/schema/Descriptors.h"
+#include "amqp/schema/field-types/Field.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Map.h"
+#include "amqp/schema/restricted-types/List.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Array.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using Op = amqp::internal::reader::Program::Op;
+
+    /**
+     * Those read often enough to have an op of their own, any other
+     * primitive is a [Op::ReadPrimitive]
+     */
+    const std::map<std::string, Op> primitives { // NOLINT
+        { "int",     Op::ReadInt },
+        { "long",    Op::ReadLong },
+        { "boolean", Op::ReadBool },
+        { "double",  Op::ReadDouble },
+        { "string",  Op::ReadString }
+    };
+
+    /**
+     * Lists and arrays of these can be read in one go
+     */
+    const std::map<std::string, Op> bulk { // NOLINT
+        { "int",     Op::ReadInts },
+        { "long",    Op::ReadLongs },
+        { "double",  Op::ReadDoubles }
+    };
+
+    bool
+    is (pn_data_t * data_, pn_type_t type_) {
+        return pn_data_type (data_) == type_;
+    }
+
+    /**
+     * False, without moving, if [data_] isn't on a string or a symbol
+     */
+    bool
+    readString (pn_data_t * data_, std::string_view & str_) {
+        pn_bytes_t bytes;
+
+        switch (pn_data_type (data_)) {
+            case PN_STRING : bytes = pn_data_get_string (data_); break;
+            case PN_SYMBOL : bytes = pn_data_get_symbol (data_); break;
+            default        : return false;
+        }
+
+        str_ = std::string_view (bytes.start, bytes.size);
+        pn_data_next (data_);
+
+        return true;
+    }
+
+    /**
+     * See EnumReader, the value is described by the enum's fingerprint
+     * and is a list of its name and ordinal, the name being read as
+     * [mapping_] says it reads now. False if it isn't.
+     */
+    bool
+    readEnum (
+        pn_data_t * data_,
+        const amqp::internal::reader::EnumMapping * mapping_,
+        std::string_view & name_
+    ) {
+        pn_data_next (data_);
+
+        if (!is (data_, PN_LIST)) {
+            return false;
+        }
+
+        pn_data_enter (data_);
+        pn_data_next (data_);
+
+        auto rtn = readString (data_, name_);
+
+        pn_data_exit (data_);
+
+        if (!rtn) {
+            return false;
+        }
+
+        if (mapping_) {
+            name_ = (*mapping_) (name_);
+        }
+
+        return true;
+    }
+
+    struct Frame {
+        uint32_t pc;
+        size_t mark;
+    };
+
+    /**
+     * How many elements or entries of the collection we're in are left
+     * and which we're on
+     */
+    struct Count {
+        size_t left;
+        size_t at;
+    };
+
+    bool
+    isPrimitive (const std::string & type_) {
+        return amqp::internal::reader::Primitives::isPrimitive (type_);
+    }
+
+    /**
+     * Whether [plan_] fills in the property [name_]
+     */
+    bool
+    filled (const amqp::internal::reader::Plan & plan_, std::string_view name_) {
+        return std::any_of (plan_.missing.begin(), plan_.missing.end(),
+            [name_](const auto & missing_) { return missing_.name == name_; });
+    }
+
+    /**
+     * With [data_] on a list, every element of it at once if they're all
+     * [T]s
+     */
+    template<typename T>
+    bool
+    readAll (pn_data_t * data_, amqp::internal::writer::Tape & tape_) {
+        static thread_local sVec<T> values;
+
+        if (!proton::readPrimitives (data_, values)) {
+            return false;
+        }
+
+        tape_.beginArray();
+
+        for (auto value : values) {
+            if constexpr (std::is_floating_point_v<T>) {
+                tape_.floating (value);
+            } else {
+                tape_.integer (value);
+            }
+        }
+
+        tape_.endArray();
+
+        return true;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Where in the tape a value that can be referred to was written or, for
+ * something skipped or only partly read by a pruned subroutine, that it
+ * wasn't read in full. A skipped string we can still write later.
+ */
+struct amqp::internal::reader::Program::Span {
+    enum class Kind : uint8_t { Written, String, Skipped };
+
+    Kind kind;
+    size_t begin;
+    size_t end;
+    std::string_view string;
+};
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * How a map's key, or a property name, was written
+     */
+    std::string
+    name (const amqp::internal::writer::Tape::Event & event_) {
+        using Kind = amqp::internal::writer::Tape::Kind;
+
+        switch (event_.kind) {
+            case Kind::Key :
+            case Kind::String : return std::string (event_.str);
+            case Kind::Integer : return std::to_string (event_.i);
+            case Kind::UnsignedInteger : return std::to_string (event_.u);
+            default : return { };
+        }
+    }
+
+    /**
+     * Write again the value recorded at [i_] in [tape_], only the parts of
+     * it [projection_] selects, returning where what follows it starts.
+     * With no projection nothing is written.
+     */
+    size_t
+    filter (
+        amqp::internal::writer::Tape & tape_,
+        size_t i_,
+        const amqp::internal::reader::Projection * projection_
+    ) {
+        using Kind = amqp::internal::writer::Tape::Kind;
+
+        auto kind = tape_.event (i_).kind;
+
+        if (projection_) {
+            tape_.replay (i_, i_ + 1);
+        }
+
+        ++i_;
+
+        if (kind != Kind::BeginObject && kind != Kind::BeginArray) {
+            return i_;
+        }
+
+        auto end = kind == Kind::BeginObject ? Kind::EndObject : Kind::EndArray;
+
+        for (size_t n { 0 } ; tape_.event (i_).kind != end ; ++n) {
+            const amqp::internal::reader::Projection * child { nullptr };
+
+            if (projection_) {
+                child = projection_->all()
+                    ? projection_
+                    : projection_->child (kind == Kind::BeginObject
+                        ? name (tape_.event (i_))
+                        : std::to_string (n));
+            }
+
+            // a property an evolution dropped is never written
+            if (kind == Kind::BeginObject && tape_.event (i_).hidden) {
+                child = nullptr;
+            }
+
+            // an object's key and then its value
+            if (kind == Kind::BeginObject) {
+                if (child) {
+                    tape_.replay (i_, i_ + 1);
+                }
+
+                ++i_;
+            }
+
+            i_ = filter (tape_, i_, child);
+        }
+
+        if (projection_) {
+            tape_.replay (i_, i_ + 1);
+        }
+
+        return i_ + 1;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Program
+ *
+ ******************************************************************************/
+
+void
+amqp::internal::reader::
+Program::emit (Op op_, uint32_t arg_) {
+    m_code.push_back ({ op_, arg_ });
+}
+
+/******************************************************************************/
+
+/**
+ * Read a value of [type_], inline if it's primitive otherwise by calling
+ * the subroutine we compiled for that type earlier
+ */
+void
+amqp::internal::reader::
+Program::value (const std::string & type_) {
+    auto primitive = primitives.find (type_);
+
+    if (primitive != primitives.end()) {
+        emit (primitive->second);
+        return;
+    }
+
+    if (Primitives::isPrimitive (type_)) {
+        emit (Op::ReadPrimitive);
+        return;
+    }
+
+    auto it = m_byType.find (type_);
+
+    if (it == m_byType.end()) {
+        throw std::runtime_error ("Missing type in program: " + type_);
+    }
+
+    emit (Op::Call, it->second);
+}
+
+/******************************************************************************/
+
+/**
+ * The [i_]th property [plan_] fills in, its key and its default or null
+ */
+void
+amqp::internal::reader::
+Program::missing (const Plan & plan_, size_t i_) {
+    const auto & missing = plan_.missing[i_];
+
+    emit (Op::Key, m_names.size());
+    m_names.push_back (missing.name);
+
+    if (missing.null()) {
+        emit (Op::Null);
+    } else {
+        emit (Op::Default, m_defaults.size());
+        m_defaults.push_back (missing);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Lists, arrays and maps all look alike, a described container whose
+ * contents are written between [begin_] and [end_]. Each time round the
+ * loop we read one of each of [types_], an element or a key and value.
+ * Lists of ints, longs and doubles first try reading them all at once,
+ * which if it works takes us straight to leaving the container.
+ */
+void
+amqp::internal::reader::
+Program::elements (
+    const sVec<std::string> & types_,
+    Op enter_,
+    Op begin_,
+    Op end_
+) {
+    emit (Op::EnterDescribed);
+    emit (Op::Next);
+
+    auto all = enter_ == Op::EnterList ? bulk.find (types_.front()) : bulk.end();
+    auto whole = m_code.size();
+
+    if (all != bulk.end()) {
+        emit (all->second);
+    }
+
+    emit (enter_);
+    emit (begin_);
+
+    auto loop = m_code.size();
+    emit (Op::Loop);
+
+    for (const auto & type : types_) {
+        if (type == "string") {
+            emit (Op::ReadStringElement);
+        } else {
+            value (type);
+        }
+    }
+
+    emit (Op::Jump, loop);
+    m_code[loop].arg = m_code.size();
+
+    emit (end_);
+    emit (Op::Exit);
+
+    if (all != bulk.end()) {
+        m_code[whole].arg = m_code.size();
+    }
+
+    emit (Op::Exit);
+    emit (Op::Next);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+Program::compile (
+    const schema::AMQPTypeNotation & type_,
+    EnumMappings * enums_,
+    Evolution * evolution_
+) {
+    DBG ("Program::compile " << type_.name() << std::endl); // NOLINT
+
+    auto start = static_cast<uint32_t> (m_code.size());
+
+    Shape shape;
+
+    if (type_.type() == schema::AMQPTypeNotation::composite_t) {
+        const auto & composite = dynamic_cast<const schema::Composite &> (
+                type_);
+
+        const auto & fields = composite.fields();
+
+        shape.kind = Shape::Kind::Composite;
+        shape.plan = evolution_ ? evolution_->plan (composite) : nullptr;
+
+        for (const auto & field : fields) {
+            shape.members.emplace_back (
+                field->name(),
+                field->primitive() ? field->type() : field->resolvedType());
+        }
+
+        emit (Op::EnterDescribed);
+        emit (Op::Next);
+        emit (Op::EnterFields);
+        emit (Op::BeginObject);
+
+        for (size_t i { 0 } ; i < fields.size() ; ++i) {
+            const auto & field = fields[i];
+
+            // a dropped property is still read, anything after it can
+            // refer to it
+            auto dropped = shape.plan && !shape.plan->keep[i];
+
+            if (dropped) {
+                emit (Op::Hide);
+            }
+
+            emit (Op::Key, m_names.size());
+            m_names.push_back (field->name());
+
+            value (field->primitive() ? field->type() : field->resolvedType());
+
+            if (dropped) {
+                emit (Op::Show);
+            }
+        }
+
+        if (shape.plan) {
+            for (size_t i { 0 } ; i < shape.plan->missing.size() ; ++i) {
+                missing (*shape.plan, i);
+            }
+        }
+
+        emit (Op::EndObject);
+        emit (Op::Exit);
+        emit (Op::Exit);
+        emit (Op::Next);
+    } else {
+        const auto & restricted = dynamic_cast<const schema::Restricted &> (
+                type_);
+
+        switch (restricted.restrictedType()) {
+            case schema::Restricted::RestrictedTypes::list_t : {
+                const auto & of = dynamic_cast<const schema::List &> (
+                        restricted).listOf();
+
+                shape = { Shape::Kind::List, { { "", of } } };
+
+                elements (
+                    { of },
+                    Op::EnterList, Op::BeginArray, Op::EndArray);
+                break;
+            }
+            case schema::Restricted::RestrictedTypes::array_t : {
+                const auto & of = dynamic_cast<const schema::Array &> (
+                        restricted).arrayOf();
+
+                shape = { Shape::Kind::List, { { "", of } } };
+
+                elements (
+                    { of },
+                    Op::EnterList, Op::BeginArray, Op::EndArray);
+                break;
+            }
+            case schema::Restricted::RestrictedTypes::map_t : {
+                auto types = dynamic_cast<const schema::Map &> (
+                        restricted).mapOf();
+
+                shape = {
+                    Shape::Kind::Map,
+                    { { "", types.first }, { "", types.second } } };
+
+                elements (
+                    { types.first, types.second },
+                    Op::EnterMap, Op::BeginObject, Op::EndObject);
+                break;
+            }
+            case schema::Restricted::RestrictedTypes::enum_t : {
+                shape = { Shape::Kind::Enum, { } };
+
+                emit (Op::EnterDescribed);
+                emit (Op::ReadEnum, static_cast<uint32_t> (m_enums.size()));
+
+                m_enums.push_back (enums_ ? (*enums_)[type_.name()] : nullptr);
+                emit (Op::Exit);
+                emit (Op::Next);
+                break;
+            }
+        }
+    }
+
+    emit (Op::Return);
+
+    m_byType[type_.name()] = start;
+    m_byDescriptor[type_.descriptor()] = start;
+    m_typeByDescriptor[type_.descriptor()] = type_.name();
+    m_kinds[Symbols::intern (type_.descriptor())] = shape.kind;
+    m_shapes[type_.name()] = std::move (shape);
+}
+
+/******************************************************************************/
+
+/**
+ * Compile a subroutine reading the parts of a [type_] [projection_]
+ * selects. Any pruned subroutines it calls are compiled first, each
+ * being specific to where it is in the projection.
+ */
+uint32_t
+amqp::internal::reader::
+Program::prune (const std::string & type_, const Projection & projection_) {
+    auto shape = m_shapes.find (type_);
+
+    if (shape == m_shapes.end()) {
+        throw std::runtime_error ("Missing type in program: " + type_);
+    }
+
+    const auto & members = shape->second.members;
+
+    // what each selected property, element or entry is, checking as we
+    // go that it exists
+    std::map<std::string_view, const std::string *> types;
+
+    for (const auto & child : projection_.children()) {
+        const std::string * type { nullptr };
+
+        switch (shape->second.kind) {
+            case Shape::Kind::Composite : {
+                const auto & plan = shape->second.plan;
+
+                for (size_t i { 0 } ; i < members.size() ; ++i) {
+                    if (members[i].first == child.first
+                        && (!plan || plan->keep[i]))
+                    {
+                        type = &members[i].second;
+                    }
+                }
+
+                if (!type && plan && filled (*plan, child.first)) {
+                    if (!child.second.all()) {
+                        throw std::runtime_error (
+                                child.first + " is filled in by default, "
+                                "there's nothing in it to select");
+                    }
+
+                    continue;
+                }
+
+                if (!type) {
+                    throw std::runtime_error (
+                            type_ + " has no property " + child.first);
+                }
+                break;
+            }
+            case Shape::Kind::List : {
+                if (!std::all_of (child.first.begin(), child.first.end(),
+                        [](unsigned char c_) { return std::isdigit (c_); }))
+                {
+                    throw std::runtime_error (
+                            type_ + " is a list, its elements are selected "
+                            "by index not " + child.first);
+                }
+
+                type = &members[0].second;
+                break;
+            }
+            case Shape::Kind::Map : {
+                type = &members[1].second;
+                break;
+            }
+            case Shape::Kind::Enum : {
+                throw std::runtime_error (
+                        type_ + " is an enum, there's nothing in it to select");
+            }
+        }
+
+        if (!child.second.all() && isPrimitive (*type)) {
+            throw std::runtime_error (
+                    child.first + " is a " + *type
+                        + ", there's nothing in it to select");
+        }
+
+        types[child.first] = type;
+    }
+
+    // the subroutines for the parts selected in part, which have to
+    // exist before we can call them
+    std::map<std::string_view, uint32_t> entries;
+
+    for (const auto & child : projection_.children()) {
+        if (!child.second.all()) {
+            entries[child.first] = prune (*types[child.first], child.second);
+        }
+    }
+
+    auto read = [&](const std::string & name_, bool element_) {
+        auto entry = entries.find (name_);
+
+        if (entry != entries.end()) {
+            emit (Op::Call, entry->second);
+        } else if (element_ && *types[name_] == "string") {
+            emit (Op::ReadStringElement);
+        } else {
+            value (*types[name_]);
+        }
+    };
+
+    auto start = static_cast<uint32_t> (m_code.size());
+
+    emit (Op::EnterDescribed, 1);
+    emit (Op::Next);
+
+    if (shape->second.kind == Shape::Kind::Composite) {
+        emit (Op::EnterFields);
+        emit (Op::BeginObject);
+
+        const auto & plan = shape->second.plan;
+
+        for (size_t i { 0 } ; i < members.size() ; ++i) {
+            const auto & member = members[i];
+
+            if (projection_.child (member.first) && (!plan || plan->keep[i])) {
+                emit (Op::Key, m_names.size());
+                m_names.push_back (member.first);
+
+                read (member.first, false);
+            } else {
+                emit (Op::Skip);
+            }
+        }
+
+        if (plan) {
+            for (size_t i { 0 } ; i < plan->missing.size() ; ++i) {
+                if (projection_.child (plan->missing[i].name)) {
+                    missing (*plan, i);
+                }
+            }
+        }
+
+        emit (Op::EndObject);
+    } else {
+        auto isMap = shape->second.kind == Shape::Kind::Map;
+
+        emit (isMap ? Op::EnterMap : Op::EnterList);
+        emit (isMap ? Op::BeginObject : Op::BeginArray);
+
+        auto loop = m_code.size();
+        emit (Op::Loop);
+
+        auto choice = m_choices.size();
+        m_choices.emplace_back();
+
+        emit (isMap ? Op::ChooseKey : Op::ChooseIndex, choice);
+
+        for (size_t i { 0 } ; i < members.size() ; ++i) {
+            emit (Op::SkipElement);
+        }
+
+        emit (Op::Jump, loop);
+
+        for (const auto & child : projection_.children()) {
+            if (isMap) {
+                m_choices[choice].keys[child.first] = m_code.size();
+
+                if (members[0].second == "string") {
+                    emit (Op::ReadStringElement);
+                } else {
+                    value (members[0].second);
+                }
+            } else {
+                m_choices[choice].indices[std::stoul (child.first)] = m_code.size();
+            }
+
+            read (child.first, true);
+            emit (Op::Jump, loop);
+        }
+
+        m_code[loop].arg = m_code.size();
+
+        emit (isMap ? Op::EndObject : Op::EndArray);
+    }
+
+    emit (Op::Exit);
+    emit (Op::Exit);
+    emit (Op::Next);
+    emit (Op::Return, 1);
+
+    return start;
+}
+
+/******************************************************************************/
+
+uint32_t
+amqp::internal::reader::
+Program::project (const std::string & descriptor_, const Projection & projection_) {
+    if (projection_.all()) {
+        return entry (descriptor_);
+    }
+
+    auto type = m_typeByDescriptor.find (descriptor_);
+
+    if (type == m_typeByDescriptor.end()) {
+        throw std::runtime_error ("No program for " + descriptor_);
+    }
+
+    m_pruned = true;
+
+    auto start = prune (type->second, projection_);
+    m_projections.emplace (start, std::make_pair (entry (descriptor_), projection_));
+
+    return start;
+}
+
+/******************************************************************************/
+
+uint32_t
+amqp::internal::reader::
+Program::entry (const std::string & descriptor_) const {
+    auto it = m_byDescriptor.find (descriptor_);
+
+    if (it == m_byDescriptor.end()) {
+        throw std::runtime_error ("No program for " + descriptor_);
+    }
+
+    return it->second;
+}
+
+/******************************************************************************/
+
+/**
+ * Move past the value [data_] is sitting on without reading it, just
+ * numbering anything in it that can be referred to. Which strings are
+ * elements of a collection depends on what contains them so for anything
+ * described we have to know what kind of type it is. Anything else we
+ * can step straight over.
+ */
+void
+amqp::internal::reader::
+Program::skip (pn_data_t * data_, bool element_, sVec<Span> & spans_) const {
+    auto type = pn_data_type (data_);
+
+    if (type != PN_DESCRIBED) {
+        if (element_ && type == PN_STRING) {
+            std::string_view str;
+            readString (data_, str);
+
+            spans_.push_back ({ Span::Kind::String, 0, 0, str });
+        } else {
+            proton::skip (data_);
+        }
+
+        return;
+    }
+
+    pn_data_enter (data_);
+    pn_data_next (data_);
+
+    // a reference, or something posing as one that whatever selected
+    // it will trip over when it's read
+    auto reference = References::tryIndex (data_);
+
+    if (!reference || *reference) {
+        pn_data_exit (data_);
+        pn_data_next (data_);
+        return;
+    }
+
+    auto kind { Shape::Kind::Composite };
+
+    if (pn_data_type (data_) == PN_SYMBOL) {
+        auto it = m_kinds.find (Symbols::find (pn_data_get_symbol (data_)));
+
+        if (it != m_kinds.end()) {
+            kind = it->second;
+        }
+    }
+
+    pn_data_next (data_);
+
+    auto body = pn_data_type (data_);
+
+    if (kind != Shape::Kind::Enum && (body == PN_LIST || body == PN_MAP)) {
+        auto n = body == PN_LIST
+            ? pn_data_get_list (data_)
+            : pn_data_get_map (data_);
+
+        auto elements = kind != Shape::Kind::Composite;
+
+        pn_data_enter (data_);
+        pn_data_next (data_);
+
+        for (size_t i { 0 } ; i < n ; ++i) {
+            skip (data_, elements, spans_);
+        }
+
+        pn_data_exit (data_);
+    } else {
+        proton::skip (data_);
+    }
+
+    pn_data_exit (data_);
+    pn_data_next (data_);
+
+    spans_.push_back ({ Span::Kind::Skipped, 0, 0, { } });
+}
+
+/******************************************************************************/
+
+/**
+ * Write the value [data_] is sitting on, of the type whose subroutine
+ * starts at [entry_], and move past it.
+ *
+ * A pruned program is run with the writer muted until we know nothing
+ * selected refers to anything we haven't read in full. First everything
+ * not selected is stepped straight over, which is as cheap as skipping
+ * gets but leaves us not knowing how many objects went past, so should
+ * anything selected be a reference we go again, this time numbering
+ * what we skip. If something selected still refers to what we skipped
+ * we read the whole of the value and write just what the projection
+ * selects of it.
+ */
+amqp::Result<void>
+amqp::internal::reader::
+Program::tryRun (
+    uint32_t entry_,
+    pn_data_t * data_,
+    amqp::writer::IWriter & writer_
+) const {
+    static thread_local sVec<writer::Tape::Event> events;
+
+    amqp::Error error;
+
+    if (!m_pruned) {
+        writer::Tape tape (writer_, events);
+        execute (entry_, data_, tape, true, error);
+        return error;
+    }
+
+    writer::Tape tape (writer_, events);
+    tape.mute();
+
+    if (execute (entry_, data_, tape, false, error)) {
+        tape.forward (0, tape.mark());
+        return { };
+    }
+
+    if (error) {
+        return error;
+    }
+
+    writer::Tape counted (writer_, events);
+    counted.mute();
+
+    if (execute (entry_, data_, counted, true, error)) {
+        counted.forward (0, counted.mark());
+        return { };
+    }
+
+    if (error) {
+        return error;
+    }
+
+    auto projected = m_projections.find (entry_);
+
+    if (projected == m_projections.end()) {
+        throw std::runtime_error ("No projection starts at " + std::to_string (entry_));
+    }
+
+    writer::Tape whole (writer_, events);
+    whole.mute();
+
+    if (!execute (projected->second.first, data_, whole, true, error)) {
+        return error;
+    }
+
+    whole.unmute();
+    filter (whole, 0, &projected->second.second);
+
+    return { };
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+Program::run (
+    uint32_t entry_,
+    pn_data_t * data_,
+    amqp::writer::IWriter & writer_
+) const {
+    tryRun (entry_, data_, writer_).value();
+}
+
+/******************************************************************************/
+
+/**
+ * Each subroutine records where in the tape its value was written as it
+ * returns, which is the order the JVM numbers objects in, as does each
+ * string in a collection. A reference in place of either is written by
+ * replaying that part of the tape and, for a subroutine, returning early.
+ *
+ * Should something refer to what was skipped, or anything refer to what
+ * a pruned subroutine is reading, we back out to where we started and
+ * return false. Unless [count_] skipping doesn't number anything, so once
+ * something's been skipped any reference at all means backing out.
+ *
+ * A blob that isn't what the program expects backs out the same way,
+ * leaving [error_] saying what was wrong and where.
+ */
+bool
+amqp::internal::reader::
+Program::execute (
+    uint32_t entry_,
+    pn_data_t * data_,
+    writer::Tape & tape_,
+    bool count_,
+    amqp::Error & error_
+) const {
+    sVec<Frame> returns;
+    sVec<Count> counts;
+    sVec<Span> spans;
+
+    returns.reserve (16);
+    counts.reserve (16);
+
+    // how many levels down we are from where we started
+    size_t depth { 0 };
+
+    // whether [spans] still lines up with the JVM's numbering
+    bool numbered { true };
+
+    auto backOut = [&]() {
+        for ( ; depth > 0 ; --depth) {
+            pn_data_exit (data_);
+        }
+
+        return false;
+    };
+
+    auto fail = [&](amqp::Errc code_) {
+        error_ = { code_, proton::offset (data_) };
+        return backOut();
+    };
+
+    auto replay = [&](uint32_t index_) {
+        if (!numbered) {
+            return false;
+        }
+
+        if (index_ >= spans.size()) {
+            error_ = { amqp::Errc::UnknownReference, proton::offset (data_) };
+            return false;
+        }
+
+        const auto & span = spans[index_];
+
+        switch (span.kind) {
+            case Span::Kind::Written : {
+                tape_.replay (span.begin, span.end);
+                return true;
+            }
+            case Span::Kind::String : {
+                tape_.string (span.string);
+                return true;
+            }
+            default : {
+                return false;
+            }
+        }
+    };
+
+    auto pc = entry_;
+
+    for (;;) {
+        const auto & i = m_code[pc++];
+
+        switch (i.op) {
+            case Op::Call : {
+                returns.push_back ({ pc, tape_.mark() });
+                pc = i.arg;
+                break;
+            }
+            case Op::Return : {
+                if (returns.empty()) {
+                    return true;
+                }
+
+                // what a pruned subroutine wrote isn't the whole value
+                spans.push_back ({
+                    i.arg ? Span::Kind::Skipped : Span::Kind::Written,
+                    returns.back().mark,
+                    tape_.mark(),
+                    { } });
+
+                pc = returns.back().pc;
+                returns.pop_back();
+                break;
+            }
+            case Op::Jump : {
+                pc = i.arg;
+                break;
+            }
+            case Op::Loop : {
+                if (counts.back().left == 0) {
+                    counts.pop_back();
+                    pc = i.arg;
+                } else {
+                    --counts.back().left;
+                    ++counts.back().at;
+                }
+                break;
+            }
+            case Op::EnterDescribed : {
+                if (!is (data_, PN_DESCRIBED)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+
+                pn_data_enter (data_);
+                pn_data_next (data_);
+
+                auto reference = References::tryIndex (data_);
+
+                if (!reference) {
+                    error_ = reference.error();
+                    pn_data_exit (data_);
+                    return backOut();
+                }
+
+                // only ever the first instruction of a subroutine so on
+                // a reference the rest of it can be skipped
+                if (auto index = *reference) {
+                    pn_data_exit (data_);
+                    pn_data_next (data_);
+
+                    // what a pruned subroutine would read of it may not be
+                    // what was read of it before
+                    if (i.arg || !replay (*index)) {
+                        return backOut();
+                    }
+
+                    if (returns.empty()) {
+                        return true;
+                    }
+
+                    pc = returns.back().pc;
+                    returns.pop_back();
+                } else {
+                    ++depth;
+                }
+                break;
+            }
+            case Op::EnterFields : {
+                if (!is (data_, PN_LIST)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+
+                pn_data_enter (data_);
+                pn_data_next (data_);
+                ++depth;
+                break;
+            }
+            case Op::EnterList : {
+                if (!is (data_, PN_LIST)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+
+                counts.push_back ({ pn_data_get_list (data_), 0 });
+                pn_data_enter (data_);
+                pn_data_next (data_);
+                ++depth;
+                break;
+            }
+            case Op::EnterMap : {
+                if (!is (data_, PN_MAP)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+
+                counts.push_back ({ pn_data_get_map (data_) / 2, 0 });
+                pn_data_enter (data_);
+                pn_data_next (data_);
+                ++depth;
+                break;
+            }
+            case Op::Exit : {
+                pn_data_exit (data_);
+                --depth;
+                break;
+            }
+            case Op::Next : {
+                pn_data_next (data_);
+                break;
+            }
+            case Op::BeginObject : tape_.beginObject(); break;
+            case Op::EndObject : tape_.endObject(); break;
+            case Op::BeginArray : tape_.beginArray(); break;
+            case Op::EndArray : tape_.endArray(); break;
+            case Op::Key : {
+                tape_.key (m_names[i.arg]);
+                break;
+            }
+            case Op::ReadInt : {
+                tape_.integer (pn_data_get_int (data_));
+                pn_data_next (data_);
+                break;
+            }
+            case Op::ReadLong : {
+                tape_.integer (pn_data_get_long (data_));
+                pn_data_next (data_);
+                break;
+            }
+            case Op::ReadBool : {
+                tape_.boolean (pn_data_get_bool (data_));
+                pn_data_next (data_);
+                break;
+            }
+            case Op::ReadDouble : {
+                tape_.floating (pn_data_get_double (data_));
+                pn_data_next (data_);
+                break;
+            }
+            case Op::ReadInts : {
+                if (readAll<int32_t> (data_, tape_)) {
+                    pc = i.arg;
+                }
+                break;
+            }
+            case Op::ReadLongs : {
+                if (readAll<int64_t> (data_, tape_)) {
+                    pc = i.arg;
+                }
+                break;
+            }
+            case Op::ReadDoubles : {
+                if (readAll<double> (data_, tape_)) {
+                    pc = i.arg;
+                }
+                break;
+            }
+            case Op::ReadString : {
+                std::string_view str;
+
+                if (!readString (data_, str)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+
+                tape_.string (str);
+                break;
+            }
+            case Op::ReadStringElement : {
+                if (pn_data_type (data_) != PN_DESCRIBED) {
+                    std::string_view str;
+
+                    if (!readString (data_, str)) {
+                        return fail (amqp::Errc::UnexpectedType);
+                    }
+
+                    auto mark = tape_.mark();
+                    tape_.string (str);
+                    spans.push_back ({ Span::Kind::Written, mark, tape_.mark(), { } });
+                    break;
+                }
+
+                pn_data_enter (data_);
+                pn_data_next (data_);
+
+                auto reference = References::tryIndex (data_);
+
+                if (!reference || !*reference) {
+                    error_ = reference
+                        ? amqp::Error { amqp::Errc::UnexpectedType, proton::offset (data_) }
+                        : reference.error();
+                    pn_data_exit (data_);
+                    return backOut();
+                }
+
+                auto index = *reference;
+
+                pn_data_exit (data_);
+                pn_data_next (data_);
+
+                if (!replay (*index)) {
+                    return backOut();
+                }
+                break;
+            }
+            case Op::ReadPrimitive : {
+                if (!Primitives::tryWrite (data_, tape_)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+                break;
+            }
+            case Op::ReadEnum : {
+                std::string_view name;
+
+                if (!readEnum (data_, m_enums[i.arg].get(), name)) {
+                    return fail (amqp::Errc::UnexpectedType);
+                }
+
+                tape_.string (name);
+                break;
+            }
+            case Op::Null : tape_.null(); break;
+            case Op::Default : m_defaults[i.arg].write (tape_); break;
+            case Op::Hide : tape_.hide(); break;
+            case Op::Show : tape_.show(); break;
+            case Op::Skip :
+            case Op::SkipElement : {
+                auto element = i.op == Op::SkipElement;
+
+                if (count_) {
+                    skip (data_, element, spans);
+                    break;
+                }
+
+                auto type = pn_data_type (data_);
+
+                numbered &= type != PN_DESCRIBED
+                    && !(element && type == PN_STRING);
+
+                proton::skip (data_);
+                break;
+            }
+            case Op::ChooseIndex : {
+                const auto & indices = m_choices[i.arg].indices;
+                auto it = indices.find (counts.back().at - 1);
+
+                if (it != indices.end()) {
+                    pc = it->second;
+                }
+                break;
+            }
+            case Op::ChooseKey : {
+                const auto & keys = m_choices[i.arg].keys;
+
+                std::string_view key;
+                char buffer[24];
+
+                switch (pn_data_type (data_)) {
+                    case PN_STRING : {
+                        auto bytes = pn_data_get_string (data_);
+                        key = std::string_view (bytes.start, bytes.size);
+                        break;
+                    }
+                    case PN_INT :
+                    case PN_LONG : {
+                        auto value = pn_data_type (data_) == PN_INT
+                            ? pn_data_get_int (data_)
+                            : pn_data_get_long (data_);
+
+                        auto end = std::to_chars (
+                                buffer, buffer + sizeof (buffer), value).ptr;
+
+                        key = std::string_view (buffer, end - buffer);
+                        break;
+                    }
+                    case PN_DESCRIBED : {
+                        // a string key can be a reference to one we've
+                        // already met
+                        if (!numbered) {
+                            return backOut();
+                        }
+
+                        pn_data_enter (data_);
+                        pn_data_next (data_);
+
+                        auto reference = References::tryIndex (data_);
+
+                        pn_data_exit (data_);
+
+                        if (!reference) {
+                            error_ = reference.error();
+                            return backOut();
+                        }
+
+                        auto index = *reference;
+
+                        if (!index || *index >= spans.size()) {
+                            break;
+                        }
+
+                        const auto & span = spans[*index];
+
+                        if (span.kind == Span::Kind::String) {
+                            key = span.string;
+                        } else if (span.kind == Span::Kind::Written
+                            && span.end - span.begin == 1
+                            && tape_.event (span.begin).kind
+                                == writer::Tape::Kind::String)
+                        {
+                            key = tape_.event (span.begin).str;
+                        }
+                        break;
+                    }
+                    default : {
+                        break;
+                    }
+                }
+
+                auto it = keys.find (key);
+
+                if (it != keys.end()) {
+                    pc = it->second;
+                }
+                break;
+            }
+        }
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,228 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "types.h"
+
+#include "amqp/Result.h"
+#include "amqp/Symbols.h"
+#include "amqp/writer/IWriter.h"
+#include "amqp/schema/AMQPTypeNotation.h"
+
+#include "Evolution.h"
+#include "Projection.h"
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+namespace amqp::internal::writer {
+
+    class Tape;
+
+}
+
+namespace amqp::internal::reader {
+
+    class EnumMapping;
+    class EnumMappings;
+
+}
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * The reader graph for a schema flattened into one contiguous block of
+     * instructions. Each type gets a subroutine, primitive values are read
+     * inline and anything else is a call to the subroutine for its type.
+     * Field names, and the defaults of any filled in by an [Evolution],
+     * live in a table the instructions index into.
+     *
+     * Running a program streams a blob into an [IWriter] exactly as
+     * [Reader::write] would, but without a virtual call, weak pointer lock
+     * or schema lookup per value.
+     *
+     * Types have to be compiled in dependency order, which is the order
+     * the schema gives them to us.
+     *
+     * Everything written is written through a [writer::Tape] so a
+     * reference back to a value written earlier, see [References], is
+     * written by replaying what was written for that value.
+     *
+     * A program can also be pruned to a [Projection], see [project], in
+     * which case only the selected parts of a blob are read and anything
+     * else is skipped. Skipping something still has to number what's in
+     * it that could be referred to, but it needn't be read. Should
+     * something selected then refer to something that wasn't read in
+     * full we fall back to reading the whole blob and writing only what's
+     * selected of that.
+     */
+    class Program {
+        public :
+            enum class Op : uint8_t {
+                Call,           // push the return address, jump to arg
+                Return,         // pop the return address, stop if there isn't one,
+                                // arg is 1 if the subroutine is pruned
+                Jump,           // unconditionally to arg
+                Loop,           // if the count on top is spent pop it and jump
+                                // to arg, otherwise decrement it and carry on
+                EnterDescribed, // enter a described type, onto its descriptor,
+                                // arg is 1 if the subroutine is pruned
+                EnterFields,    // enter a list without counting its elements
+                EnterList,      // enter a list, push its element count
+                EnterMap,       // enter a map, push its entry count
+                Exit,           // back out to the parent node
+                Next,           // onto the next sibling
+                BeginObject,
+                EndObject,
+                BeginArray,
+                EndArray,
+                Key,            // field name arg
+                ReadInt,
+                ReadLong,
+                ReadBool,
+                ReadDouble,
+                ReadInts,       // with a list of nothing but ints on top
+                ReadLongs,      // the lot read as an array and on to arg,
+                ReadDoubles,    // otherwise it's read an element at a time
+                ReadString,
+                ReadStringElement,  // a string in a collection, which unlike
+                                    // a property can be a reference
+                ReadPrimitive,  // any other primitive, by [Primitives]
+                ReadEnum,       // on an enum's descriptor, its name as
+                                // mapped by the enum mapping arg
+                Null,           // for a property the wire doesn't have
+                Default,        // as Null but the property's default, the
+                                // default arg
+                Hide,           // what's written until Show is only for
+                Show,           // anything that might refer to it, see
+                                // [writer::Tape::hide]
+                Skip,           // past the value without reading it
+                SkipElement,    // as Skip for an element of a collection
+                ChooseIndex,    // to the target in choice arg for the
+                                // element we're on, if it has one
+                ChooseKey       // to the target in choice arg for the key
+                                // of the entry we're on, if it has one
+            };
+
+            struct Instruction {
+                Op op;
+                uint32_t arg;
+            };
+
+        private :
+            /**
+             * What we need of a type to prune it, its kind and, as type
+             * names, its properties, its elements or its keys and values.
+             * The properties are those on the wire, for a composite we're
+             * evolving its [Plan] says what's read of them.
+             */
+            struct Shape {
+                enum class Kind : uint8_t { Composite, List, Map, Enum };
+
+                Kind kind;
+                sVec<std::pair<std::string, std::string>> members;
+                sPtr<const Plan> plan;
+            };
+
+            /**
+             * Where an element or entry goes, by index for lists and
+             * arrays and by key for maps. Anything not here is skipped.
+             */
+            struct Choice {
+                std::map<size_t, uint32_t> indices;
+                std::map<std::string, uint32_t, std::less<>> keys;
+            };
+
+            sVec<Instruction> m_code;
+            sVec<std::string> m_names;
+            sVec<Plan::Missing> m_defaults;
+            sVec<Choice> m_choices;
+            sVec<sPtr<const EnumMapping>> m_enums;
+
+            std::map<std::string, uint32_t> m_byType;
+            std::map<std::string, uint32_t> m_byDescriptor;
+
+            std::map<std::string, Shape> m_shapes;
+            std::unordered_map<Symbols::id_t, Shape::Kind> m_kinds;
+
+            std::map<std::string, std::string> m_typeByDescriptor;
+
+            /**
+             * For the start of each pruned subroutine [project] returns
+             * the start of the whole type's and what it selects of it
+             */
+            std::map<uint32_t, std::pair<uint32_t, Projection>> m_projections;
+
+            bool m_pruned { false };
+
+            struct Span;
+
+            void emit (Op, uint32_t = 0);
+            void value (const std::string &);
+            void missing (const Plan &, size_t);
+            void elements (const sVec<std::string> &, Op, Op, Op);
+
+            uint32_t prune (const std::string &, const Projection &);
+            void skip (pn_data_t *, bool, sVec<Span> &) const;
+
+            bool execute (
+                uint32_t,
+                pn_data_t *,
+                writer::Tape &,
+                bool count_,
+                amqp::Error &) const;
+
+        public :
+            /**
+             * An enum reads its constants through its mapping in [enums_],
+             * if we're given any, see [EnumMapping]. A composite is read as
+             * the version [evolution_] has for it, if we're given one.
+             */
+            void compile (
+                const schema::AMQPTypeNotation &,
+                EnumMappings * enums_ = nullptr,
+                Evolution * evolution_ = nullptr);
+
+            /**
+             * Add to the program a subroutine for the type with this
+             * descriptor that reads only what [projection_] selects,
+             * returning where it starts. All the types the projection
+             * passes through have to have been compiled already.
+             */
+            uint32_t project (const std::string &, const Projection & projection_);
+
+            /**
+             * Where the subroutine for the type with this descriptor starts
+             */
+            uint32_t entry (const std::string &) const;
+
+            /**
+             * Write the value [data_] is on, of the type whose subroutine
+             * starts at [entry_]. A blob that isn't what we expected is an
+             * error, what's been written of it by then stays written.
+             */
+            amqp::Result<void> tryRun (
+                uint32_t entry_,
+                pn_data_t * data_,
+                amqp::writer::IWriter &) const;
+
+            /**
+             * As [tryRun] but throwing [amqp::Failure] on an error
+             */
+            void run (uint32_t, pn_data_t *, amqp::writer::IWriter &) const;
+
+            const sVec<Instruction> & code() const { return m_code; }
+            const sVec<std::string> & names() const { return m_names; }
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,229 @@
+#include "Projection.h"
+
+#include <stdexcept>
+
+/******************************************************************************/
+
+namespace {
+
+    [[noreturn]] void
+    badPath (std::string_view path_) {
+        throw std::runtime_error (
+                "Bad path in projection: \"" + std::string (path_) + "\"");
+    }
+
+    /**
+     * RFC 6901, ~1 is a / and ~0 a ~
+     */
+    sVec<std::string>
+    pointer (std::string_view path_) {
+        sVec<std::string> rtn;
+
+        for (size_t i { 1 } ; i <= path_.size() ; ++i) {
+            std::string segment;
+
+            for ( ; i < path_.size() && path_[i] != '/' ; ++i) {
+                if (path_[i] != '~') {
+                    segment += path_[i];
+                } else if (i + 1 < path_.size() && path_[i + 1] == '1') {
+                    segment += '/';
+                    ++i;
+                } else if (i + 1 < path_.size() && path_[i + 1] == '0') {
+                    segment += '~';
+                    ++i;
+                } else {
+                    badPath (path_);
+                }
+            }
+
+            rtn.push_back (std::move (segment));
+        }
+
+        return rtn;
+    }
+
+    /**
+     * a.b[3].c is a, b, 3 and c
+     */
+    sVec<std::string>
+    dotted (std::string_view path_) {
+        sVec<std::string> rtn;
+
+        size_t i { 0 };
+
+        while (i < path_.size()) {
+            if (path_[i] == '[') {
+                auto close = path_.find (']', i);
+
+                if (close == std::string_view::npos || close == i + 1) {
+                    badPath (path_);
+                }
+
+                rtn.emplace_back (path_.substr (i + 1, close - i - 1));
+                i = close + 1;
+
+                if (i < path_.size() && path_[i] == '.') {
+                    if (++i == path_.size()) {
+                        badPath (path_);
+                    }
+                }
+            } else {
+                auto end = path_.find_first_of (".[", i);
+
+                if (end == i) {
+                    badPath (path_);
+                }
+
+                rtn.emplace_back (path_.substr (i, end - i));
+
+                if (end == std::string_view::npos) {
+                    break;
+                }
+
+                i = end;
+
+                if (path_[i] == '.') {
+                    if (++i == path_.size()) {
+                        badPath (path_);
+                    }
+                }
+            }
+        }
+
+        return rtn;
+    }
+
+    std::string
+    escape (const std::string & segment_) {
+        std::string rtn;
+
+        for (auto c : segment_) {
+            switch (c) {
+                case '~' : rtn += "~0"; break;
+                case '/' : rtn += "~1"; break;
+                default  : rtn += c;
+            }
+        }
+
+        return rtn;
+    }
+
+    void
+    paths (
+        const amqp::internal::reader::Projection & projection_,
+        const std::string & prefix_,
+        std::string & rtn_
+    ) {
+        if (projection_.all()) {
+            if (!rtn_.empty()) {
+                rtn_ += ',';
+            }
+            rtn_ += prefix_;
+            return;
+        }
+
+        for (const auto & child : projection_.children()) {
+            paths (child.second, prefix_ + "/" + escape (child.first), rtn_);
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Projection
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+Projection::Projection()
+    : m_all { true }
+{ }
+
+/******************************************************************************/
+
+amqp::internal::reader::Projection
+amqp::internal::reader::
+Projection::parse (std::string_view paths_) {
+    Projection rtn;
+
+    size_t begin { 0 };
+
+    while (begin <= paths_.size()) {
+        auto end = paths_.find (',', begin);
+
+        if (end == std::string_view::npos) {
+            end = paths_.size();
+        }
+
+        auto path = paths_.substr (begin, end - begin);
+
+        if (path.empty()) {
+            badPath (path);
+        }
+
+        // the first path narrows the projection from everything to just
+        // what it selects, the rest widen it again
+        if (rtn.m_all && begin == 0) {
+            rtn.m_all = false;
+        }
+
+        rtn.add (path[0] == '/' ? pointer (path) : dotted (path));
+
+        begin = end + 1;
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+Projection::add (const sVec<std::string> & path_) {
+    auto * node = this;
+
+    for (const auto & segment : path_) {
+        // something above this is already selected in its entirety
+        if (node->m_all) {
+            return;
+        }
+
+        auto it = node->m_children.find (segment);
+
+        if (it == node->m_children.end()) {
+            Projection child;
+            child.m_all = false;
+
+            it = node->m_children.emplace (segment, std::move (child)).first;
+        }
+
+        node = &it->second;
+    }
+
+    node->m_all = true;
+    node->m_children.clear();
+}
+
+/******************************************************************************/
+
+const amqp::internal::reader::Projection *
+amqp::internal::reader::
+Projection::child (std::string_view name_) const {
+    auto it = m_children.find (name_);
+
+    return it == m_children.end() ? nullptr : &it->second;
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::reader::
+Projection::str() const {
+    std::string rtn;
+    paths (*this, "", rtn);
+
+    return rtn;
+}
+
+/******************************************************************************/
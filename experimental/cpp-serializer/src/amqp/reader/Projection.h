@@ -0,0 +1,70 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * Which parts of a blob to decode, as a tree of the property names,
+     * element indices and map keys leading to them. Everything beneath a
+     * selected path is selected, anything not on one is skipped.
+     *
+     * Paths are relative to the blob itself and given either dotted, with
+     * elements of a list or array in brackets
+     *
+     *      state.data.amount.quantity,outputs[3]
+     *
+     * or as JSON Pointers (RFC 6901)
+     *
+     *      /state/data/amount/quantity,/outputs/3
+     *
+     * A default constructed projection selects everything.
+     */
+    class Projection {
+        private :
+            std::map<std::string, Projection, std::less<>> m_children;
+            bool m_all;
+
+            void add (const sVec<std::string> &);
+
+        public :
+            Projection();
+
+            /**
+             * A comma separated list of paths
+             */
+            static Projection parse (std::string_view);
+
+            /**
+             * Whether everything from here down is selected
+             */
+            bool all() const { return m_all; }
+
+            /**
+             * What's selected beneath [name_], null if nothing is
+             */
+            const Projection * child (std::string_view name_) const;
+
+            const std::map<std::string, Projection, std::less<>> &
+            children() const {
+                return m_children;
+            }
+
+            /**
+             * The selected paths in a canonical form, two projections
+             * selecting the same things give the same string
+             */
+            std::string str() const;
+    };
+
+}
+
+/******************************************************************************/
@@ -5,15 +5,15 @@
 #include "amqp/reader/property-readers/LongPropertyReader.h"
 #include "amqp/reader/property-readers/StringPropertyReader.h"
 #include "amqp/reader/property-readers/DoublePropertyReader.h"
+#include "amqp/reader/property-readers/PrimitivePropertyReader.h"
 
-#include <map>
 #include <string>
-#include <iostream>
-#include <functional>
+#include <stdexcept>
 
 #include <proton/codec.h>
 
 #include "proton/proton_wrapper.h"
+#include "amqp/reader/Primitives.h"
 
 /******************************************************************************/
 
@@ -21,36 +21,24 @@ namespace {
 
     using namespace amqp::internal::reader;
 
-    std::map<
-            std::string,
-            std::shared_ptr<amqp::internal::reader::PropertyReader>(*)()
-    > propertyMap = { // NOLINT
-        {
-            "int", []() -> std::shared_ptr<PropertyReader> {
-                return std::make_shared<IntPropertyReader> ();
-            }
-        },
-        {
-            "string", []() -> std::shared_ptr<PropertyReader> {
-                return std::make_shared<StringPropertyReader> ();
-            }
-        },
-        {
-            "boolean", []() -> std::shared_ptr<PropertyReader> {
-                return std::make_shared<BoolPropertyReader> ();
-            }
-        },
-        {
-            "long", []() -> std::shared_ptr<PropertyReader> {
-                return std::make_shared<LongPropertyReader> ();
-            }
-        },
-        {
-            "double", []() -> std::shared_ptr<PropertyReader> {
-                return std::make_shared<DoublePropertyReader> ();
-            }
+    /**
+     * The primitives we've a reader of their own for get it, every other
+     * one shares the one that reads by way of [Primitives]
+     */
+    ReaderTable::Index
+    propertyReader (ReaderTable & table_, const std::string & type_) {
+        switch (Primitives::code (type_)) {
+            case PN_INT    : return table_.emplace<IntPropertyReader>();
+            case PN_STRING : return table_.emplace<StringPropertyReader>();
+            case PN_BOOL   : return table_.emplace<BoolPropertyReader>();
+            case PN_LONG   : return table_.emplace<LongPropertyReader>();
+            case PN_DOUBLE : return table_.emplace<DoublePropertyReader>();
+            case PN_INVALID :
+                throw std::runtime_error ("No reader for primitive type " + type_);
+            default :
+                return table_.emplace<PrimitivePropertyReader> (type_);
         }
-    };
+    }
 
 }
 
@@ -60,26 +48,26 @@ namespace {
  *
  ******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::PropertyReader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::reader::
-PropertyReader::make (const FieldPtr & field_) {
-    return propertyMap[field_->type()]();
+PropertyReader::make (ReaderTable & table_, const FieldPtr & field_) {
+    return propertyReader (table_, field_->type());
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::PropertyReader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::reader::
-PropertyReader::make (const std::string & type_) {
-    return propertyMap[type_]();
+PropertyReader::make (ReaderTable & table_, const std::string & type_) {
+    return propertyReader (table_, type_);
 }
 
 /******************************************************************************/
 
-std::shared_ptr<amqp::internal::reader::PropertyReader>
+amqp::internal::reader::ReaderTable::Index
 amqp::internal::reader::
-PropertyReader::make (const internal::schema::Field & field_) {
-    return propertyMap[field_.type()]();
+PropertyReader::make (ReaderTable & table_, const internal::schema::Field & field_) {
+    return propertyReader (table_, field_.type());
 }
 
 /******************************************************************************/
@@ -3,6 +3,7 @@
 /******************************************************************************/
 
 #include "Reader.h"
+#include "ReaderTable.h"
 
 #include "amqp/schema/field-types/Field.h"
 
@@ -17,10 +18,11 @@ namespace amqp::internal::reader {
         public :
             /**
              * Static Factory method for creating appropriate derived types
+             * in [table_], returning where
              */
-            static std::shared_ptr<PropertyReader> make (const internal::schema::Field &);
-            static std::shared_ptr<PropertyReader> make (const FieldPtr &);
-            static std::shared_ptr<PropertyReader> make (const std::string &);
+            static ReaderTable::Index make (ReaderTable &, const internal::schema::Field &);
+            static ReaderTable::Index make (ReaderTable &, const FieldPtr &);
+            static ReaderTable::Index make (ReaderTable &, const std::string &);
 
             PropertyReader() = default;
             ~PropertyReader() override = default;
@@ -40,6 +42,12 @@ namespace amqp::internal::reader {
                 const SchemaType &
             ) const override = 0;
 
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &
+            ) const override = 0;
+
             const std::string & name() const override = 0;
             const std::string & type() const override = 0;
     };
@@ -1,7 +1,9 @@
 #include "Reader.h"
 
+#include <cstdio>
 #include <memory>
 #include <sstream>
+#include <charconv>
 
 /******************************************************************************/
 
@@ -85,6 +87,138 @@ namespace {
         return rtn.str();
     }
 
+    /**
+     * Formatted exactly as each element would have been on its own, with
+     * std::to_string, but into the one string
+     */
+    template<typename T>
+    std::string
+    dumpPrimitives (std::string rtn_, const pmrVec<T> & values_) {
+        rtn_.reserve (rtn_.size() + values_.size() * 8 + 4);
+        rtn_ += "[ ";
+
+        char buf[512];
+
+        for (size_t i { 0 } ; i < values_.size() ; ++i) {
+            if (i) {
+                rtn_ += ", ";
+            }
+
+            if constexpr (std::is_floating_point_v<T>) {
+                auto n = snprintf (buf, sizeof (buf), "%f", values_[i]);
+                rtn_.append (buf, static_cast<size_t> (n));
+            } else {
+                auto end = std::to_chars (buf, buf + sizeof (buf), values_[i]).ptr;
+                rtn_.append (buf, end);
+            }
+        }
+
+        rtn_ += " ]";
+
+        return rtn_;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Value
+ *
+ ******************************************************************************/
+
+namespace {
+
+    /**
+     * Each node remembers where it came from so it can be handed back
+     * there, for an arena that's a no-op
+     */
+    struct alignas (std::max_align_t) Header {
+        std::pmr::memory_resource * m_resource;
+        size_t m_size;
+    };
+
+}
+
+/******************************************************************************/
+
+void *
+amqp::internal::reader::
+Value::operator new (size_t size_) {
+    auto resource = Arena::current();
+    auto size = size_ + sizeof (Header);
+
+    auto header = static_cast<Header *> (
+            resource->allocate (size, alignof (Header)));
+
+    header->m_resource = resource;
+    header->m_size = size;
+
+    return header + 1;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+Value::operator delete (void * ptr_) {
+    if (ptr_) {
+        auto header = static_cast<Header *> (ptr_) - 1;
+        header->m_resource->deallocate (header, header->m_size, alignof (Header));
+    }
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::Pair
+ *
+ ******************************************************************************/
+
+/**
+ * Every pair dumps as its property, a separator and then its value
+ */
+std::string
+amqp::internal::reader::
+Pair::dumpValue() const {
+    return dump().substr (m_property.size() + 3);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::SingleReference
+ *
+ ******************************************************************************/
+
+namespace {
+
+    std::string
+    valueOf (const amqp::reader::IValue & value_) {
+        if (auto pair = dynamic_cast<const amqp::internal::reader::Pair *>(&value_)) {
+            return pair->dumpValue();
+        }
+
+        return value_.dump();
+    }
+
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::reader::
+SingleReference::dump() const {
+    return ::valueOf (m_value);
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::PairReference
+ *
+ ******************************************************************************/
+
+std::string
+amqp::internal::reader::
+PairReference::dump() const {
+    return property() + " : " + ::valueOf (m_value);
 }
 
 /******************************************************************************
@@ -113,28 +247,63 @@ template<>
 std::string
 amqp::internal::reader::
 TypedPair<sVec<uPtr<amqp::internal::reader::Pair>>>::dump() const {
-    return ::dumpPair<AutoMap> (m_property, m_value.begin(), m_value.end());
+    return ::dumpPair<AutoMap> (property(), m_value.begin(), m_value.end());
 }
 
 template<>
 std::string
 amqp::internal::reader::
 TypedPair<sList<uPtr<amqp::internal::reader::Pair>>>::dump() const {
-    return ::dumpPair<AutoMap> (m_property, m_value.begin(), m_value.end());
+    return ::dumpPair<AutoMap> (property(), m_value.begin(), m_value.end());
 }
 
 template<>
 std::string
 amqp::internal::reader::
 TypedPair<sVec<uPtr<amqp::reader::IValue>>>::dump() const {
-    return ::dumpPair<AutoMap> (m_property, m_value.begin(), m_value.end());
+    return ::dumpPair<AutoMap> (property(), m_value.begin(), m_value.end());
 }
 
 template<>
 std::string
 amqp::internal::reader::
 TypedPair<sList<uPtr<amqp::reader::IValue>>>::dump() const {
-    return ::dumpPair<AutoList> (m_property, m_value.begin(), m_value.end());
+    return ::dumpPair<AutoList> (property(), m_value.begin(), m_value.end());
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<uPtr<amqp::reader::IValue>>>::dump() const {
+    return ::dumpPair<AutoMap> (property(), m_value.begin(), m_value.end());
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrList<uPtr<amqp::reader::IValue>>>::dump() const {
+    return ::dumpPair<AutoList> (property(), m_value.begin(), m_value.end());
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<int32_t>>::dump() const {
+    return ::dumpPrimitives (property() + " : ", m_value);
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<int64_t>>::dump() const {
+    return ::dumpPrimitives (property() + " : ", m_value);
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<double>>::dump() const {
+    return ::dumpPrimitives (property() + " : ", m_value);
 }
 
 /******************************************************************************
@@ -143,6 +312,20 @@ TypedPair<sList<uPtr<amqp::reader::IValue>>>::dump() const {
  *
  ******************************************************************************/
 
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrList<uPtr<amqp::reader::IValue>>>::dump() const {
+    return ::dumpSingle<AutoList> (m_value.begin(), m_value.end());
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<uPtr<amqp::reader::IValue>>>::dump() const {
+    return ::dumpSingle<AutoMap> (m_value.begin(), m_value.end());
+}
+
 template<>
 std::string
 amqp::internal::reader::
@@ -171,4 +354,25 @@ TypedSingle<sVec<uPtr<amqp::internal::reader::Single>>>::dump() const {
     return ::dumpSingle<AutoMap> (m_value.begin(), m_value.end());
 }
 
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<int32_t>>::dump() const {
+    return ::dumpPrimitives ({ }, m_value);
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<int64_t>>::dump() const {
+    return ::dumpPrimitives ({ }, m_value);
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<double>>::dump() const {
+    return ::dumpPrimitives ({ }, m_value);
+}
+
 /******************************************************************************/
@@ -7,7 +7,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <string_view>
 
+#include "Arena.h"
 #include "amqp/schema/described-types/Schema.h"
 #include "amqp/reader/IReader.h"
 
@@ -20,6 +22,12 @@ namespace amqp::internal::reader {
             std::string dump() const override = 0;
 
             ~Value() override = default;
+
+            /**
+             * Nodes come from the current [Arena] if there is one
+             */
+            static void * operator new (size_t);
+            static void operator delete (void *);
     };
 
     /*
@@ -77,12 +85,16 @@ namespace amqp::internal::reader {
      */
     class Pair : public Value {
         protected :
-            std::string m_property;
+            pmrString m_property;
+
+            std::string property() const {
+                return { m_property.data(), m_property.size() };
+            }
 
         public:
-            explicit Pair (std::string property_)
+            explicit Pair (std::string_view property_)
                 : Value()
-                , m_property (std::move (property_))
+                , m_property (arenaString (property_))
             { }
 
             ~Pair() override = default;
@@ -92,6 +104,12 @@ namespace amqp::internal::reader {
             { }
 
             std::string dump() const override = 0;
+
+            /**
+             * The value without the property, as though it had been read
+             * as a [Single]
+             */
+            std::string dumpValue() const;
     };
 
 
@@ -146,6 +164,41 @@ namespace amqp::internal::reader {
         std::string dump() const override;
     };
 
+    /**
+     * A value that was written as a reference back to one read earlier in
+     * the blob. Rather than a copy it points at the original, which lives
+     * as long as the tree they're both a part of. Either could have been
+     * read with or without a property so only the value of the original
+     * is used.
+     */
+    class SingleReference : public Single {
+        private :
+            const amqp::reader::IValue & m_value;
+
+        public :
+            explicit SingleReference (const amqp::reader::IValue & value_)
+                : Single()
+                , m_value (value_)
+            { }
+
+            std::string dump() const override;
+    };
+
+    class PairReference : public Pair {
+        private :
+            const amqp::reader::IValue & m_value;
+
+        public :
+            PairReference (
+                const std::string & property_,
+                const amqp::reader::IValue & value_
+            ) : Pair (property_)
+              , m_value (value_)
+            { }
+
+            std::string dump() const override;
+    };
+
 }
 
 /******************************************************************************
@@ -168,6 +221,23 @@ TypedSingle<std::string>::dump() const {
     return m_value;
 }
 
+template<>
+inline std::string
+amqp::internal::reader::
+TypedSingle<pmrString>::dump() const {
+    return { m_value.data(), m_value.size() };
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<uPtr<amqp::reader::IValue>>>::dump() const;
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrList<uPtr<amqp::reader::IValue>>>::dump() const;
+
 template<>
 std::string
 amqp::internal::reader::
@@ -188,6 +258,24 @@ std::string
 amqp::internal::reader::
 TypedSingle<sList<uPtr<amqp::internal::reader::Single>>>::dump() const;
 
+/*
+ * Lists and arrays of primitives read in one go
+ */
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<int32_t>>::dump() const;
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<int64_t>>::dump() const;
+
+template<>
+std::string
+amqp::internal::reader::
+TypedSingle<pmrVec<double>>::dump() const;
+
 /******************************************************************************
  *
  * amqp::internal::reader::TypedPair
@@ -198,16 +286,33 @@ template<typename T>
 inline std::string
 amqp::internal::reader::
 TypedPair<T>::dump() const {
-    return m_property + " : " + std::to_string (m_value);
+    return property() + " : " + std::to_string (m_value);
 }
 
 template<>
 inline std::string
 amqp::internal::reader::
 TypedPair<std::string>::dump() const {
-    return m_property + " : " + m_value;
+    return property() + " : " + m_value;
 }
 
+template<>
+inline std::string
+amqp::internal::reader::
+TypedPair<pmrString>::dump() const {
+    return property() + " : " + std::string (m_value.data(), m_value.size());
+}
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<uPtr<amqp::reader::IValue>>>::dump() const;
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrList<uPtr<amqp::reader::IValue>>>::dump() const;
+
 template<>
 std::string
 amqp::internal::reader::
@@ -228,6 +333,21 @@ std::string
 amqp::internal::reader::
 TypedPair<sList<uPtr<amqp::internal::reader::Pair>>>::dump() const;
 
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<int32_t>>::dump() const;
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<int64_t>>::dump() const;
+
+template<>
+std::string
+amqp::internal::reader::
+TypedPair<pmrVec<double>>::dump() const;
+
 /******************************************************************************
  *
  *
@@ -267,6 +387,11 @@ namespace amqp::internal::reader  {
             uPtr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override = 0;
+
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &) const override = 0;
     };
 
 }
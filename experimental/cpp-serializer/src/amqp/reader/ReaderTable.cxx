@@ -0,0 +1,72 @@
+#include "ReaderTable.h"
+
+#include <algorithm>
+
+#include "Reader.h"
+
+/******************************************************************************/
+
+namespace {
+
+    /*
+     * Big enough for the readers of most schemas in one block
+     */
+    constexpr size_t initialStorage { 16 * 1024 };
+    constexpr size_t initialIndex { 64 };
+
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::
+ReaderTable::ReaderTable()
+    : m_storage { initialStorage }
+    , m_index { nullptr }
+    , m_size { 0 }
+    , m_capacity { 0 }
+{ }
+
+/******************************************************************************/
+
+/**
+ * Readers don't own each other so can go in any order, their memory going
+ * with [m_storage] once they have
+ */
+amqp::internal::reader::
+ReaderTable::~ReaderTable() {
+    auto index = m_index.load (std::memory_order_relaxed);
+
+    for (size_t i { 0 } ; i < m_size ; ++i) {
+        index[i]->~Reader();
+    }
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::ReaderTable::Index
+amqp::internal::reader::
+ReaderTable::add (const Reader * reader_) {
+    if (m_size == m_capacity) {
+        auto capacity = std::max (initialIndex, 2 * m_capacity);
+        uPtr<const Reader *[]> index (new const Reader *[capacity]);
+
+        if (m_size) {
+            auto current = m_index.load (std::memory_order_relaxed);
+            std::copy (current, current + m_size, index.get());
+        }
+
+        // kept before it's published, so a push_back that throws can't
+        // leave us pointing at an index it's freed
+        m_indices.push_back (std::move (index));
+        m_index.store (m_indices.back().get(), std::memory_order_release);
+        m_capacity = capacity;
+    }
+
+    // nobody looks for it until they're told it's there, by which
+    // time this is visible to them
+    m_indices.back()[m_size] = reader_;
+
+    return static_cast<Index> (m_size++);
+}
+
+/******************************************************************************/
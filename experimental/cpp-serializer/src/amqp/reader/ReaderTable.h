@@ -0,0 +1,112 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <memory_resource>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    class Reader;
+
+    /**
+     * Every reader for a factory's types, built one after another into
+     * blocks of memory the table owns and referred to by their 32 bit
+     * index into it. Readers refer to the readers of their fields and
+     * elements the same way, so following one is an array lookup rather
+     * than locking a weak pointer, and the lot goes with the table.
+     *
+     * Readers are only ever added, by one thread at a time, and never
+     * moved. Looking one up takes no lock so any number of threads can
+     * do so while another adds to the table, as long as they only look
+     * for readers they were told about after they were added. Growing
+     * the index copies it, the old copy being kept until the table goes
+     * so anyone still reading it can carry on.
+     */
+    class ReaderTable {
+        public :
+            using Index = uint32_t;
+
+            /**
+             * A reader in a table, as held by the readers that use it
+             */
+            class Ref {
+                private :
+                    const ReaderTable * m_table;
+                    Index m_index;
+
+                public :
+                    Ref (const ReaderTable & table_, Index index_)
+                        : m_table (& table_)
+                        , m_index (index_)
+                    { }
+
+                    Index index() const { return m_index; }
+
+                    const Reader & operator * () const { return (*m_table)[m_index]; }
+                    const Reader * operator -> () const { return & (*m_table)[m_index]; }
+            };
+
+        private :
+            std::pmr::monotonic_buffer_resource m_storage;
+
+            std::atomic<const Reader * const *> m_index;
+            std::vector<uPtr<const Reader *[]>> m_indices;
+            size_t m_size;
+            size_t m_capacity;
+
+            Index add (const Reader *);
+
+        public :
+            ReaderTable();
+            ~ReaderTable();
+
+            ReaderTable (const ReaderTable &) = delete;
+            ReaderTable & operator = (const ReaderTable &) = delete;
+
+            /**
+             * Build an [R] in the table, returning its index
+             */
+            template<class R, class ... Args>
+            Index emplace (Args && ... args_);
+
+            const Reader & operator[] (Index index_) const {
+                return *m_index.load (std::memory_order_acquire)[index_];
+            }
+
+            Ref ref (Index index_) const { return Ref (*this, index_); }
+
+            /**
+             * Only for the thread adding readers
+             */
+            size_t size() const { return m_size; }
+    };
+
+}
+
+/******************************************************************************/
+
+template<class R, class ... Args>
+amqp::internal::reader::ReaderTable::Index
+amqp::internal::reader::
+ReaderTable::emplace (Args && ... args_) {
+    auto reader = new (m_storage.allocate (sizeof (R), alignof (R))) R (
+            std::forward<Args> (args_)...);
+
+    try {
+        return add (reader);
+    } catch (...) {
+        // its memory stays with the table, there's no giving it back
+        reader->~R();
+        throw;
+    }
+}
+
+/******************************************************************************/
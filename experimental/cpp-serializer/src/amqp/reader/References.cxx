@@ -0,0 +1,196 @@
+#include "References.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+#include "Arena.h"
+
+#include "amqp/schema/Descriptors.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+
+/******************************************************************************/
+
+namespace {
+
+    thread_local amqp::internal::reader::References * current { nullptr };
+
+    /**
+     * If [data_] is on a reference, the value it refers to
+     */
+    const amqp::reader::IValue *
+    referenced (pn_data_t * data_) {
+        using amqp::internal::reader::References;
+
+        if (pn_data_type (data_) != PN_DESCRIBED) {
+            return nullptr;
+        }
+
+        std::optional<uint32_t> index;
+
+        {
+            proton::auto_enter ae (data_);
+            index = References::index (data_);
+        }
+
+        if (!index) {
+            return nullptr;
+        }
+
+        pn_data_next (data_);
+
+        if (!::current) {
+            throw std::runtime_error (
+                    "Referenced object with no references in scope");
+        }
+
+        if (*index >= ::current->size()) {
+            throw std::runtime_error (
+                    "Reference to unknown object " + std::to_string (*index));
+        }
+
+        return ::current->at (*index);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::References
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::References *
+amqp::internal::reader::
+References::current() {
+    return ::current;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+References::record (uPtr<amqp::reader::IValue> value_) {
+    if (::current) {
+        ::current->m_values.push_back (value_.get());
+    }
+
+    return value_;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+References::drop (uPtr<amqp::reader::IValue> value_) {
+    // with nothing numbered nothing can refer to it
+    if (!::current) {
+        return;
+    }
+
+    if (Arena::current() != std::pmr::new_delete_resource()) {
+        value_.release();
+        return;
+    }
+
+    ::current->m_dropped.push_back (std::move (value_));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+References::resolve (const std::string & name_, pn_data_t * data_) {
+    if (auto value = referenced (data_)) {
+        return std::make_unique<PairReference> (name_, *value);
+    }
+
+    return nullptr;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+References::resolve (pn_data_t * data_) {
+    if (auto value = referenced (data_)) {
+        return std::make_unique<SingleReference> (*value);
+    }
+
+    return nullptr;
+}
+
+/******************************************************************************/
+
+/**
+ * The body of a reference is an unsigned int, we take a ulong as well
+ * since nothing stops an encoder picking the wider type
+ */
+amqp::Result<std::optional<uint32_t>>
+amqp::internal::reader::
+References::tryIndex (pn_data_t * data_) {
+    if (pn_data_type (data_) != PN_ULONG
+        || amqp::stripCorda (pn_data_get_ulong (data_))
+                != static_cast<uint32_t>(amqp::schema::descriptors::REFERENCED_OBJECT))
+    {
+        return std::optional<uint32_t> { };
+    }
+
+    pn_data_next (data_);
+
+    switch (pn_data_type (data_)) {
+        case PN_UINT  : return std::optional<uint32_t> { pn_data_get_uint (data_) };
+        case PN_ULONG : {
+            // wider than a uint can't be an index, rather than wrapping
+            // round onto an object we've seen
+            auto index = pn_data_get_ulong (data_);
+
+            if (index <= UINT32_MAX) {
+                return std::optional<uint32_t> { static_cast<uint32_t>(index) };
+            }
+
+            [[fallthrough]];
+        }
+        default :
+            return amqp::Error { amqp::Errc::Malformed, proton::offset (data_) };
+    }
+}
+
+/******************************************************************************/
+
+std::optional<uint32_t>
+amqp::internal::reader::
+References::index (pn_data_t * data_) {
+    auto rtn = tryIndex (data_);
+
+    if (!rtn) {
+        throw std::runtime_error ("Malformed object reference");
+    }
+
+    return *rtn;
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::reader::References::Scope
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+References::Scope::Scope (References & references_)
+    : m_previous { ::current }
+{
+    ::current = &references_;
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::
+References::Scope::~Scope() {
+    ::current = m_previous;
+}
+
+/******************************************************************************/
@@ -0,0 +1,121 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <cstdint>
+#include <optional>
+
+#include "types.h"
+#include "Reader.h"
+
+#include "amqp/Result.h"
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * When the JVM serialiser comes to write an object it has already
+     * written to the same blob it writes a reference back to it instead,
+     * a value described by REFERENCED_OBJECT whose body is the index of
+     * the earlier object. Objects are numbered in the order they finished
+     * being written, so a container comes after its contents, and only
+     * those that aren't primitives (boxed or otherwise) are numbered. For
+     * us that's anything described and strings read as elements of a
+     * collection, strings that are properties being written as primitives.
+     *
+     * This tracks the values dumped so far in that same order so a
+     * reference can share the value it refers to rather than reading it
+     * again. Like [Arena] it's per decode, the one in scope on the calling
+     * thread being used, and with none in scope nothing is recorded and
+     * any reference met is an error.
+     */
+    class References {
+        private :
+            sVec<const amqp::reader::IValue *> m_values;
+            sVec<uPtr<amqp::reader::IValue>> m_dropped;
+
+        public :
+            References() = default;
+
+            References (const References &) = delete;
+            References & operator = (const References &) = delete;
+
+            size_t size() const { return m_values.size(); }
+
+            const amqp::reader::IValue * at (size_t i_) const {
+                return m_values[i_];
+            }
+
+            void clear() {
+                m_values.clear();
+                m_dropped.clear();
+            }
+
+            /**
+             * The references in scope on this thread, if any
+             */
+            static References * current();
+
+            /**
+             * Number [value_] and hand it back
+             */
+            static uPtr<amqp::reader::IValue> record (
+                    uPtr<amqp::reader::IValue> value_);
+
+            /**
+             * A value that's been read, and so numbered, but has no place
+             * in the tree, as with a property dropped by an [Evolution].
+             * Anything after it can still refer to it so in an arena it's
+             * left there, going when the rest of the tree does, otherwise
+             * it's kept for as long as the references are.
+             */
+            static void drop (uPtr<amqp::reader::IValue> value_);
+
+            /**
+             * If [data_] is sitting on a reference move past it and return
+             * the value it refers to, named [name_], otherwise leave it be
+             * and return null
+             */
+            static uPtr<amqp::reader::IValue> resolve (
+                    const std::string & name_, pn_data_t * data_);
+
+            static uPtr<amqp::reader::IValue> resolve (pn_data_t * data_);
+
+            /**
+             * With [data_] on the descriptor of a described value, if that
+             * value is a reference move onto its body and return the index
+             * it refers to
+             */
+            static std::optional<uint32_t> index (pn_data_t * data_);
+
+            /**
+             * As [index] but a reference whose body isn't an index is an
+             * error rather than an exception
+             */
+            static amqp::Result<std::optional<uint32_t>> tryIndex (pn_data_t * data_);
+
+            /**
+             * Make a set of references the current one for as long as this
+             * is in scope
+             */
+            class Scope {
+                private :
+                    References * m_previous;
+
+                public :
+                    explicit Scope (References &);
+                    ~Scope();
+
+                    Scope (const Scope &) = delete;
+                    Scope & operator = (const Scope &) = delete;
+            };
+    };
+
+}
+
+/******************************************************************************/
@@ -40,6 +40,113 @@ RestrictedReader::readString (pn_data_t * data_) const {
 
 /******************************************************************************/
 
+namespace {
+
+    using namespace amqp::internal::reader;
+
+    template<typename T>
+    uPtr<amqp::reader::IValue>
+    dumpAll (const std::string * name_, pn_data_t * data_) {
+        pmrVec<T> values (Arena::current());
+
+        if (!proton::readPrimitives (data_, values)) {
+            return nullptr;
+        }
+
+        if (name_) {
+            return std::make_unique<TypedPair<pmrVec<T>>> (*name_, std::move (values));
+        }
+
+        return std::make_unique<TypedSingle<pmrVec<T>>> (std::move (values));
+    }
+
+    template<typename T>
+    bool
+    writeAll (pn_data_t * data_, amqp::writer::IWriter & writer_) {
+        static thread_local std::vector<T> values;
+
+        if (!proton::readPrimitives (data_, values)) {
+            return false;
+        }
+
+        writer_.beginArray();
+
+        for (auto value : values) {
+            if constexpr (std::is_floating_point_v<T>) {
+                writer_.floating (value);
+            } else {
+                writer_.integer (value);
+            }
+        }
+
+        writer_.endArray();
+
+        return true;
+    }
+
+}
+
+/******************************************************************************/
+
+amqp::internal::reader::RestrictedReader::Primitive
+amqp::internal::reader::
+RestrictedReader::primitive (const Reader & reader_) {
+    const auto & type = reader_.type();
+
+    return type == "int" ? Primitive::Int
+        : type == "long" ? Primitive::Long
+        : type == "double" ? Primitive::Double
+        : Primitive::None;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+RestrictedReader::dumpPrimitives (
+    Primitive primitive_,
+    const std::string * name_,
+    pn_data_t * data_
+) {
+    if (primitive_ == Primitive::None) {
+        return nullptr;
+    }
+
+    proton::auto_enter ae (data_, true);
+
+    switch (primitive_) {
+        case Primitive::Int    : return dumpAll<int32_t> (name_, data_);
+        case Primitive::Long   : return dumpAll<int64_t> (name_, data_);
+        case Primitive::Double : return dumpAll<double> (name_, data_);
+        default                : return nullptr;
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::reader::
+RestrictedReader::writePrimitives (
+    Primitive primitive_,
+    pn_data_t * data_,
+    amqp::writer::IWriter & writer_
+) {
+    if (primitive_ == Primitive::None) {
+        return false;
+    }
+
+    proton::auto_enter ae (data_, true);
+
+    switch (primitive_) {
+        case Primitive::Int    : return writeAll<int32_t> (data_, writer_);
+        case Primitive::Long   : return writeAll<int64_t> (data_, writer_);
+        case Primitive::Double : return writeAll<double> (data_, writer_);
+        default                : return false;
+    }
+}
+
+/******************************************************************************/
+
 const std::string &
 amqp::internal::reader::
 RestrictedReader::name() const {
@@ -3,6 +3,7 @@
 /******************************************************************************/
 
 #include "Reader.h"
+#include "ReaderTable.h"
 
 #include <any>
 #include <vector>
@@ -22,6 +23,37 @@ namespace amqp::internal::reader {
             static const std::string m_name;
             const std::string m_type;
 
+        protected :
+            /**
+             * Lists and arrays of ints, longs and doubles can be read in
+             * one go rather than an element at a time
+             */
+            enum class Primitive : uint8_t { None, Int, Long, Double };
+
+            /**
+             * Which of those the elements [reader_] reads are, if any
+             */
+            static Primitive primitive (const Reader & reader_);
+
+            /**
+             * With [data_] on a described list or array of [primitive_]s,
+             * all of them read into a single value, with [name_] as its
+             * property if it has one. Null, with nothing moved, if any of
+             * them is something else, a null say.
+             */
+            static uPtr<amqp::reader::IValue> dumpPrimitives (
+                Primitive primitive_,
+                const std::string * name_,
+                pn_data_t * data_);
+
+            /**
+             * As [dumpPrimitives] but writing them, false if we couldn't
+             */
+            static bool writePrimitives (
+                Primitive,
+                pn_data_t *,
+                amqp::writer::IWriter &);
+
         public :
             explicit RestrictedReader (std::string);
             ~RestrictedReader() override = default;
@@ -49,9 +49,9 @@ DoublePropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<pmrString>> (
             name_,
-            std::to_string (proton::readAndNext<double> (data_)));
+            arenaString (std::to_string (proton::readAndNext<double> (data_))));
 }
 
 /******************************************************************************/
@@ -62,8 +62,20 @@ DoublePropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<double> (data_)));
+    return std::make_unique<TypedSingle<pmrString>> (
+            arenaString (std::to_string (proton::readAndNext<double> (data_))));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+DoublePropertyReader::write (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::writer::IWriter & writer_) const
+{
+    writer_.floating (proton::readAndNext<double> (data_));
 }
 
 /******************************************************************************/
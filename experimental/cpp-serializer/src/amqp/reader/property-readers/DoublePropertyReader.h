@@ -29,6 +29,12 @@ namespace amqp::internal::reader {
                 const SchemaType &
             ) const override;
 
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &
+            ) const override;
+
             const std::string & name() const override;
             const std::string & type() const override;
     };
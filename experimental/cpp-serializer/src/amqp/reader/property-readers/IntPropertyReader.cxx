@@ -57,9 +57,9 @@ IntPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<pmrString>> (
             name_,
-            std::to_string (proton::readAndNext<int> (data_)));
+            arenaString (std::to_string (proton::readAndNext<int> (data_))));
 }
 
 /******************************************************************************/
@@ -70,8 +70,20 @@ IntPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<int> (data_)));
+    return std::make_unique<TypedSingle<pmrString>> (
+            arenaString (std::to_string (proton::readAndNext<int> (data_))));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+IntPropertyReader::write (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::writer::IWriter & writer_) const
+{
+    writer_.integer (proton::readAndNext<int> (data_));
 }
 
 /******************************************************************************/
@@ -51,9 +51,9 @@ LongPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<pmrString>> (
             name_,
-            std::to_string (proton::readAndNext<long> (data_)));
+            arenaString (std::to_string (proton::readAndNext<long> (data_))));
 }
 
 /******************************************************************************/
@@ -64,8 +64,20 @@ LongPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            std::to_string (proton::readAndNext<long> (data_)));
+    return std::make_unique<TypedSingle<pmrString>> (
+            arenaString (std::to_string (proton::readAndNext<long> (data_))));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+LongPropertyReader::write (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::writer::IWriter & writer_) const
+{
+    writer_.integer (proton::readAndNext<long> (data_));
 }
 
 /******************************************************************************/
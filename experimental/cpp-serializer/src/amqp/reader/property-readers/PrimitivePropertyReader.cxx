@@ -0,0 +1,119 @@
+#include "PrimitivePropertyReader.h"
+
+#include <any>
+#include <string>
+#include <proton/codec.h>
+
+#include "amqp/reader/IReader.h"
+#include "amqp/reader/Primitives.h"
+#include "amqp/writer/JsonWriter.h"
+
+/******************************************************************************
+ *
+ * PrimitivePropertyReader statics
+ *
+ ******************************************************************************/
+
+const std::string
+amqp::internal::reader::
+PrimitivePropertyReader::m_name { // NOLINT
+    "Primitive Reader"
+};
+
+/******************************************************************************/
+
+namespace {
+
+    std::string
+    json (pn_data_t * data_) {
+        amqp::internal::writer::JsonWriter writer;
+        amqp::internal::reader::Primitives::write (data_, writer);
+
+        return writer.take();
+    }
+
+}
+
+/******************************************************************************
+ *
+ * PrimitivePropertyReader
+ *
+ ******************************************************************************/
+
+amqp::internal::reader::
+PrimitivePropertyReader::PrimitivePropertyReader (std::string type_)
+    : m_type (std::move (type_))
+{
+}
+
+/******************************************************************************/
+
+std::any
+amqp::internal::reader::
+PrimitivePropertyReader::read (pn_data_t * data_) const {
+    return Primitives::read (data_);
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::reader::
+PrimitivePropertyReader::readString (pn_data_t * data_) const {
+    return json (data_);
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+PrimitivePropertyReader::dump (
+    const std::string & name_,
+    pn_data_t * data_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedPair<pmrString>> (
+            name_,
+            arenaString (json (data_)));
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+PrimitivePropertyReader::dump (
+    pn_data_t * data_,
+    const SchemaType & schema_) const
+{
+    return std::make_unique<TypedSingle<pmrString>> (
+            arenaString (json (data_)));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+PrimitivePropertyReader::write (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::writer::IWriter & writer_) const
+{
+    Primitives::write (data_, writer_);
+}
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::reader::
+PrimitivePropertyReader::name() const {
+    return m_name;
+}
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::reader::
+PrimitivePropertyReader::type() const {
+    return m_type;
+}
+
+/******************************************************************************/
@@ -0,0 +1,50 @@
+#pragma once
+
+/******************************************************************************/
+
+#include "PropertyReader.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * Any of the primitives without a reader of their own, reading them
+     * by way of [Primitives]. When dumped they're formatted as they'd be
+     * written as JSON.
+     */
+    class PrimitivePropertyReader : public PropertyReader {
+    private :
+        static const std::string m_name;
+        const std::string m_type;
+
+    public :
+        explicit PrimitivePropertyReader (std::string type_);
+        ~PrimitivePropertyReader() override = default;
+
+        std::string readString (pn_data_t *) const override;
+
+        std::any read(pn_data_t *) const override;
+
+        uPtr <amqp::reader::IValue> dump(
+                const std::string &,
+                pn_data_t *,
+                const SchemaType &
+        ) const override;
+
+        uPtr <amqp::reader::IValue> dump(
+                pn_data_t *,
+                const SchemaType &
+        ) const override;
+
+        void write (
+            pn_data_t *,
+            const SchemaType &,
+            amqp::writer::IWriter &) const override;
+
+        const std::string &name() const override;
+        const std::string &type() const override;
+    };
+}
+
+/******************************************************************************/
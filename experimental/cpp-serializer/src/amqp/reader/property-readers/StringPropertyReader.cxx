@@ -3,6 +3,8 @@
 #include <proton/codec.h>
 
 #include "proton/proton_wrapper.h"
+#include "amqp/reader/References.h"
+#include "amqp/writer/Escape.h"
 
 /******************************************************************************
  *
@@ -24,6 +26,24 @@ StringPropertyReader::m_name { // NOLINT
         "String Reader"
 };
 
+namespace {
+
+    /**
+     * Quoted and escaped as JSON would have it, so whatever the string
+     * holds the dump stays something that can be parsed
+     */
+    pmrString
+    quoted (std::string_view str_) {
+        pmrString rtn { amqp::internal::reader::Arena::current() };
+
+        rtn.reserve (str_.size() + 2);
+        amqp::internal::writer::escape (rtn, str_);
+
+        return rtn;
+    }
+
+}
+
 /******************************************************************************
  *
  * class StringPropertyReader
@@ -53,21 +73,42 @@ StringPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<pmrString>> (
             name_,
-            "\"" + proton::readAndNext<std::string> (data_) + "\"");
+            quoted (proton::readAndNext<std::string_view> (data_)));
 }
 
 /******************************************************************************/
 
+/**
+ * Without a property we're an element of a collection, or a key or value
+ * of a map, and unlike a property can be referred to later or be a
+ * reference ourselves
+ */
 uPtr<amqp::reader::IValue>
 amqp::internal::reader::
 StringPropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
-    return std::make_unique<TypedSingle<std::string>> (
-            "\"" + proton::readAndNext<std::string> (data_) + "\"");
+    if (auto ref = References::resolve (data_)) {
+        return ref;
+    }
+
+    return References::record (std::make_unique<TypedSingle<pmrString>> (
+            quoted (proton::readAndNext<std::string_view> (data_))));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+StringPropertyReader::write (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::writer::IWriter & writer_) const
+{
+    writer_.string (proton::readAndNext<std::string_view> (data_));
 }
 
 /******************************************************************************/
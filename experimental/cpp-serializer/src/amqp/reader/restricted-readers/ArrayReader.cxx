@@ -1,6 +1,8 @@
 #include "ArrayReader.h"
 
+#include "amqp/Symbols.h"
 #include "proton/proton_wrapper.h"
+#include "amqp/reader/References.h"
 
 /******************************************************************************
  *
@@ -11,9 +13,10 @@
 amqp::internal::reader::
 ArrayReader::ArrayReader (
     std::string type_,
-    std::weak_ptr<Reader> reader_
+    ReaderTable::Ref reader_
 ) : RestrictedReader (std::move (type_))
   , m_reader (std::move (reader_))
+  , m_primitive (primitive (*m_reader))
 { }
 
 /******************************************************************************/
@@ -33,11 +36,19 @@ ArrayReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    if (auto ref = References::resolve (name_, data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedPair<sList<uPtr<amqp::reader::IValue>>>>(
+    if (auto values = dumpPrimitives (m_primitive, &name_, data_)) {
+        return References::record (std::move (values));
+    }
+
+    return References::record (std::make_unique<TypedPair<pmrList<uPtr<amqp::reader::IValue>>>>(
             name_,
-            dump_ (data_, schema_));
+            dump_ (data_, schema_)));
 }
 
 /******************************************************************************/
@@ -48,15 +59,23 @@ ArrayReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    if (auto ref = References::resolve (data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedSingle<sList<uPtr<amqp::reader::IValue>>>>(
-            dump_ (data_, schema_));
+    if (auto values = dumpPrimitives (m_primitive, nullptr, data_)) {
+        return References::record (std::move (values));
+    }
+
+    return References::record (std::make_unique<TypedSingle<pmrList<uPtr<amqp::reader::IValue>>>>(
+            dump_ (data_, schema_)));
 }
 
 /******************************************************************************/
 
-sList<uPtr<amqp::reader::IValue>>
+pmrList<uPtr<amqp::reader::IValue>>
 amqp::internal::reader::
 ArrayReader::dump_(
         pn_data_t * data_,
@@ -64,17 +83,19 @@ ArrayReader::dump_(
 ) const {
     proton::is_described (data_);
 
-    decltype (dump_ (data_, schema_)) read;
+    decltype (dump_ (data_, schema_)) read { Arena::current() };
 
     {
         proton::auto_enter ae (data_);
-        schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+        schema_.fromDescriptor (
+            Symbols::find (proton::get_symbol<pn_bytes_t> (data_)));
+        pn_data_next (data_);
 
         {
             proton::auto_list_enter ale (data_, true);
 
             for (size_t i { 0 } ; i < ale.elements() ; ++i) {
-                read.emplace_back (m_reader.lock()->dump (data_, schema_));
+                read.emplace_back (m_reader->dump (data_, schema_));
             }
         }
     }
@@ -84,3 +105,39 @@ ArrayReader::dump_(
 
 /******************************************************************************/
 
+
+void
+amqp::internal::reader::
+ArrayReader::write (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::writer::IWriter & writer_
+) const {
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+
+    if (writePrimitives (m_primitive, data_, writer_)) {
+        return;
+    }
+
+    {
+        proton::auto_enter ae (data_);
+        // we already know what we're reading so skip the descriptor
+        proton::readAndNext<std::string_view>(data_);
+
+        {
+            proton::auto_list_enter ale (data_, true);
+            const auto & reader = *m_reader;
+
+            writer_.beginArray();
+
+            for (size_t i { 0 } ; i < ale.elements() ; ++i) {
+                reader.write (data_, schema_, writer_);
+            }
+
+            writer_.endArray();
+        }
+    }
+}
+
+/******************************************************************************/
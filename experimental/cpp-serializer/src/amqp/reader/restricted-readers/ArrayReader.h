@@ -11,9 +11,12 @@ namespace amqp::internal::reader {
     class ArrayReader : public RestrictedReader {
         private :
             // How to read the underlying types
-            std::weak_ptr<Reader> m_reader;
+            ReaderTable::Ref m_reader;
 
-            std::list<uPtr<amqp::reader::IValue>> dump_(
+            // and whether they can all be read at once
+            Primitive m_primitive;
+
+            pmrList<uPtr<amqp::reader::IValue>> dump_(
                 pn_data_t *,
                 const SchemaType &) const;
 
@@ -23,7 +26,7 @@ namespace amqp::internal::reader {
             std::string m_primType;
 
         public :
-            ArrayReader (std::string, std::weak_ptr<Reader>);
+            ArrayReader (std::string, ReaderTable::Ref);
 
             ~ArrayReader() final = default;
 
@@ -37,6 +40,11 @@ namespace amqp::internal::reader {
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &) const override;
     };
 
 }
@@ -4,16 +4,19 @@
 #include "amqp/schema/Descriptors.h"
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
 #include "proton/proton_wrapper.h"
+#include "amqp/reader/References.h"
 
 /******************************************************************************/
 
 amqp::internal::reader::
 EnumReader::EnumReader (
     std::string type_,
-    std::vector<std::string> choices_
+    std::vector<std::string> choices_,
+    sPtr<const EnumMapping> mapping_
 ) : RestrictedReader (std::move (type_))
-  , m_choices (std::move (choices_)
-) {
+  , m_choices (std::move (choices_))
+  , m_mapping (std::move (mapping_))
+{
 
 }
 
@@ -21,6 +24,10 @@ EnumReader::EnumReader (
 
 namespace {
 
+    /**
+     * References back to an enum we've already read are dealt with by
+     * [References] before we get here, see [EnumReader::dump]
+     */
     std::string
     getValue (pn_data_t * data_) {
         proton::is_described (data_);
@@ -28,21 +35,6 @@ namespace {
         {
             proton::auto_enter ae (data_);
 
-            /*
-             * Referenced objects are added to a stream when the serialiser
-             * notices it's writing a value it's already written, so to save
-             * space it will just link back to that. Currently we have
-             * no mechanism for decoding that so just throw an error
-             */
-            if (pn_data_type (data_) == PN_ULONG) {
-                if (amqp::stripCorda(pn_data_get_ulong(data_)) ==
-                amqp::schema::descriptors::REFERENCED_OBJECT
-            ) {
-                    throw std::runtime_error (
-                            "Currently don't support referenced objects");
-                }
-            }
-
             auto fingerprint = proton::readAndNext<std::string>(data_);
 
             proton::auto_list_enter ale (data_, true);
@@ -69,12 +61,18 @@ EnumReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    if (auto ref = References::resolve (name_, data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
     proton::is_described (data_);
 
-    return std::make_unique<TypedPair<std::string>> (
+    auto value = getValue (data_);
+
+    return References::record (std::make_unique<TypedPair<pmrString>> (
             name_,
-            getValue(data_));
+            arenaString ((*m_mapping) (value))));
 }
 
 /******************************************************************************/
@@ -84,11 +82,35 @@ amqp::internal::reader::
 EnumReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
+) const {
+    if (auto ref = References::resolve (data_)) {
+        return ref;
+    }
+
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+
+    auto value = getValue (data_);
+
+    return References::record (std::make_unique<TypedSingle<pmrString>> (
+            arenaString ((*m_mapping) (value))));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+EnumReader::write (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::writer::IWriter & writer_
 ) const {
     proton::auto_next an (data_);
     proton::is_described (data_);
 
-    return std::make_unique<TypedSingle<std::string>> (getValue(data_));
+    auto value = getValue (data_);
+
+    writer_.string ((*m_mapping) (value));
 }
 
 /******************************************************************************/
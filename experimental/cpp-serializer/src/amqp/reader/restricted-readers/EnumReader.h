@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RestrictedReader.h"
+#include "EnumMapping.h"
 
 /******************************************************************************/
 
@@ -9,8 +10,15 @@ namespace amqp::internal::reader {
     class EnumReader : public RestrictedReader {
         private :
             std::vector<std::string> m_choices;
+
+            // what each constant reads as now
+            sPtr<const EnumMapping> m_mapping;
+
         public :
-            EnumReader (std::string, std::vector<std::string>);
+            EnumReader (
+                std::string,
+                std::vector<std::string>,
+                sPtr<const EnumMapping>);
 
             std::unique_ptr<amqp::reader::IValue> dump(
                 const std::string &,
@@ -20,6 +28,11 @@ namespace amqp::internal::reader {
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &) const override;
     };
 
 }
@@ -11,18 +11,22 @@ namespace amqp::internal::reader {
     class ListReader : public RestrictedReader {
         private :
             // How to read the underlying types
-            std::weak_ptr<Reader> m_reader;
+            ReaderTable::Ref m_reader;
 
-            std::list<uPtr<amqp::reader::IValue>> dump_(
+            // and whether they can all be read at once
+            Primitive m_primitive;
+
+            pmrList<uPtr<amqp::reader::IValue>> dump_(
                 pn_data_t *,
                 const SchemaType &) const;
 
         public :
             ListReader (
                 const std::string & type_,
-                std::weak_ptr<Reader> reader_
+                ReaderTable::Ref reader_
             ) : RestrictedReader (type_)
               , m_reader (std::move (reader_))
+              , m_primitive (primitive (*m_reader))
             { }
 
             ~ListReader() final = default;
@@ -37,6 +41,11 @@ namespace amqp::internal::reader {
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &) const override;
     };
 
 }
@@ -1,8 +1,10 @@
 #include "MapReader.h"
 
 #include "Reader.h"
+#include "amqp/Symbols.h"
 #include "amqp/reader/IReader.h"
 #include "proton/proton_wrapper.h"
+#include "amqp/reader/References.h"
 
 /******************************************************************************/
 
@@ -14,7 +16,7 @@ MapReader::restrictedType() const {
 
 /******************************************************************************/
 
-sVec<uPtr<amqp::reader::IValue>>
+pmrVec<uPtr<amqp::reader::IValue>>
 amqp::internal::reader::
 MapReader::dump_(
     pn_data_t * data_,
@@ -27,20 +29,27 @@ MapReader::dump_(
     // we don't need it, we know the types this is a reader for
     // and don't need context from the schema as there isn't
     // any. Maps have a Key and a Value, they aren't named
-    // parameters, unlike composite types.
-    schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+    // parameters, unlike composite types. Just check the schema
+    // has it.
+    schema_.fromDescriptor (
+        Symbols::find (proton::get_symbol<pn_bytes_t> (data_)));
+    pn_data_next (data_);
 
     {
         proton::auto_map_enter am (data_, true);
 
-        decltype (dump_(data_, schema_)) rtn;
+        decltype (dump_(data_, schema_)) rtn { Arena::current() };
         rtn.reserve (am.elements() / 2);
 
-        for (int i {0} ; i < am.elements() ; i += 2) {
+        for (size_t i {0} ; i < am.elements() ; i += 2) {
+            // the order in which function arguments are evaluated is
+            // unspecified so make sure we read the key first
+            auto key = m_keyReader->dump (data_, schema_);
+
             rtn.emplace_back (
                 std::make_unique<ValuePair> (
-                    m_keyReader.lock()->dump (data_, schema_),
-                    m_valueReader.lock()->dump (data_, schema_)
+                    std::move (key),
+                    m_valueReader->dump (data_, schema_)
                 )
             );
         }
@@ -58,11 +67,15 @@ MapReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    if (auto ref = References::resolve (name_, data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>>(
+    return References::record (std::make_unique<TypedPair<pmrVec<uPtr<amqp::reader::IValue>>>>(
             name_,
-            dump_ (data_, schema_));
+            dump_ (data_, schema_)));
 }
 
 /******************************************************************************/
@@ -73,10 +86,51 @@ MapReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const  {
+    if (auto ref = References::resolve (data_)) {
+        return ref;
+    }
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>>(
-            dump_ (data_, schema_));
+    return References::record (std::make_unique<TypedSingle<pmrVec<uPtr<amqp::reader::IValue>>>>(
+            dump_ (data_, schema_)));
+}
+
+/******************************************************************************/
+
+/**
+ * JSON keys are strings so keys are written in their string form, a map
+ * whose keys aren't scalars can't be written this way
+ */
+void
+amqp::internal::reader::
+MapReader::write (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::writer::IWriter & writer_
+) const {
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    // we already know what we're reading so skip the descriptor
+    proton::readAndNext<std::string_view>(data_);
+
+    {
+        proton::auto_map_enter am (data_, true);
+
+        const auto & keyReader = *m_keyReader;
+        const auto & valueReader = *m_valueReader;
+
+        writer_.beginObject();
+
+        for (size_t i {0} ; i < am.elements() ; i += 2) {
+            keyReader.write (data_, schema_, writer_);
+            valueReader.write (data_, schema_, writer_);
+        }
+
+        writer_.endObject();
+    }
 }
 
 /******************************************************************************/
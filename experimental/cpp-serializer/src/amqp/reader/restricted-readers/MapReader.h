@@ -11,18 +11,18 @@ namespace amqp::internal::reader {
     class MapReader : public RestrictedReader {
         private :
             // How to read the underlying types
-            std::weak_ptr<Reader> m_keyReader;
-            std::weak_ptr<Reader> m_valueReader;
+            ReaderTable::Ref m_keyReader;
+            ReaderTable::Ref m_valueReader;
 
-            sVec<uPtr<amqp::reader::IValue>> dump_(
+            pmrVec<uPtr<amqp::reader::IValue>> dump_(
                     pn_data_t *,
                     const SchemaType &) const;
 
         public :
             MapReader (
                 const std::string & type_,
-                std::weak_ptr<Reader> keyReader_,
-                std::weak_ptr<Reader> valueReader_
+                ReaderTable::Ref keyReader_,
+                ReaderTable::Ref valueReader_
             ) : RestrictedReader (type_)
               , m_keyReader (std::move (keyReader_))
               , m_valueReader (std::move (valueReader_))
@@ -40,6 +40,11 @@ namespace amqp::internal::reader {
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void write (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::writer::IWriter &) const override;
     };
 
 }
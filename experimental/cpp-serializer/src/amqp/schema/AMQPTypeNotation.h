@@ -56,9 +56,6 @@ namespace amqp::internal::schema {
             const std::string & name() const;
 
             virtual Type type() const = 0;
-
-            virtual int dependsOnRHS (const Restricted &) const = 0;
-            virtual int dependsOnRHS (const Composite &) const = 0;
     };
 
 }
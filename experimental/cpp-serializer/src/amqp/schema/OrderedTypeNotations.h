@@ -1,8 +1,15 @@
 #pragma once
 
 #include <list>
+#include <vector>
 #include <ostream>
+#include <limits>
+#include <numeric>
 #include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
 
 #include "debug.h"
 #include "types.h"
@@ -36,7 +43,11 @@ namespace amqp::internal::schema {
         public :
             virtual ~OrderedTypeNotation() = default;
 
-            virtual int dependsOn (const OrderedTypeNotation &) const = 0;
+            /**
+             * Append the names of the types this one depends on to [deps_].
+             * These are what [OrderedTypeNotations] orders types by.
+             */
+            virtual void dependencies (std::vector<std::string_view> & deps_) const = 0;
     };
 
 }
@@ -48,17 +59,15 @@ namespace amqp::internal::schema {
     template<class T>
     class OrderedTypeNotations {
         private:
-            std::list<std::list<uPtr<T>>> m_schemas;
+            /**
+             * Types inserted since the levels were last worked out, oldest
+             * first
+             */
+            mutable std::vector<uPtr<T>> m_unordered;
 
-        public :
-            typedef decltype(m_schemas.begin()) iterator;
+            mutable std::list<std::list<uPtr<T>>> m_schemas;
 
-        private:
-            void insert (uPtr<T> &&, iterator);
-            void insertNewList (uPtr<T> &&);
-            void insertNewList (
-                    uPtr<T> &&,
-                    typename std::list<std::list<uPtr<T>>>::iterator &);
+            void order() const;
 
         public :
             void insert (uPtr<T> && ptr);
@@ -67,11 +76,18 @@ namespace amqp::internal::schema {
                     std::ostream &,
                     const amqp::internal::schema::OrderedTypeNotations<T> &);
 
+            /**
+             * The levels are only worked out once something looks at them
+             * so it's up to whoever owns us to do that before sharing us
+             * between threads, as [Schema] does on construction
+             */
             decltype (m_schemas.cbegin()) begin() const {
+                order();
                 return m_schemas.cbegin();
             }
 
             decltype (m_schemas.cend()) end() const {
+                order();
                 return m_schemas.cend();
             }
     };
@@ -87,7 +103,7 @@ operator << (
         const amqp::internal::schema::OrderedTypeNotations<T> &otn_
 ) {
     int idx1 {0};
-    for (const auto &i : otn_.m_schemas) {
+    for (const auto &i : otn_) {
         stream_ << "level " << ++idx1 << std::endl;
         for (const auto &j : i) {
             stream_ << "    * " << j->name() << std::endl;
@@ -103,106 +119,193 @@ operator << (
 template<class T>
 void
 amqp::internal::schema::
-OrderedTypeNotations<T>::insertNewList(uPtr<T> && ptr) {
-    std::list<uPtr<T>> l;
-    l.emplace_back (std::move (ptr));
-    m_schemas.emplace_back(std::move (l));
+OrderedTypeNotations<T>::insert (uPtr<T> && ptr) {
+    DBG ("Insert: " << ptr->name() << std::endl);
+
+    m_unordered.emplace_back (std::move (ptr));
 }
 
 /******************************************************************************/
 
 /**
- * This could be a bit more space efficient by checking the previous element
- * for dependendies again as its possible we are moving multiple elements "up"
- * but the extra checks probably don't make it worth it.
+ * Every type has to come after the types it depends on, the readers for a
+ * type being built from the readers of what it depends on.
+ *
+ * Index the types by name and turn what each depends on into edges, then
+ * peel them off a level at a time (Kahn's algorithm): the first level is
+ * everything that depends on nothing else in the schema and each following
+ * level is whatever only depends on the levels above it. That puts each
+ * type on the level after the last of its dependencies in time linear in
+ * types plus edges.
+ *
+ * Within a level the most recently inserted type comes first. A dependency
+ * cycle can't be ordered, so when nothing else can be placed one is broken
+ * by placing a type in it as though it depended on nothing.
  */
 template<class T>
 void
 amqp::internal::schema::
-OrderedTypeNotations<T>::insertNewList(
-        uPtr<T> && ptr,
-        typename std::list<std::list<uPtr<T>>>::iterator & here_)
-{
-    std::list<uPtr<T>> l;
-    l.emplace_back (std::move (ptr));
-    m_schemas.insert(here_, std::move (l));
-}
+OrderedTypeNotations<T>::order() const {
+    if (m_unordered.empty()) {
+        return;
+    }
 
-/******************************************************************************/
+    /*
+     * Anything already ordered goes back in ahead of what's new, each level
+     * reversed so ties between those types break the same way again
+     */
+    std::vector<uPtr<T>> types;
 
-template<class T>
-void
-amqp::internal::schema::
-OrderedTypeNotations<T>::insert (uPtr<T> && ptr) {
-    return insert (std::move (ptr), m_schemas.begin());
-}
+    for (auto i = m_schemas.rbegin() ; i != m_schemas.rend() ; ++i) {
+        for (auto j = i->rbegin() ; j != i->rend() ; ++j) {
+            types.emplace_back (std::move (*j));
+        }
+    }
 
-/******************************************************************************/
+    m_schemas.clear();
+
+    std::move (
+        m_unordered.begin(), m_unordered.end(), std::back_inserter (types));
+
+    m_unordered.clear();
+
+    const auto n { types.size() };
+
+    std::unordered_map<std::string_view, size_t> index;
+    index.reserve (n);
+
+    for (size_t i { 0 } ; i < n ; ++i) {
+        index[types[i]->name()] = i;
+    }
 
-template<class T>
-void
-amqp::internal::schema::
-OrderedTypeNotations<T>::insert (
-        uPtr<T> && ptr,
-        amqp::internal::schema::OrderedTypeNotations<T>::iterator l_
-) {
-    DBG ("Insert: " << ptr->name() << std::endl);
     /*
-     * First we find where this element needs to be added
+     * The types [i] depends on are edges[first[i]] to edges[first[i + 1]]
+     * and the types that depend on it back[firstBack[i]] onwards in the
+     * same way
      */
-    amqp::internal::schema::OrderedTypeNotations<T>::iterator insertionPoint { l_ };
+    std::vector<size_t> first (n + 1);
+    std::vector<size_t> edges;
+    std::vector<std::string_view> names;
 
-    for (auto i = l_ ; i != m_schemas.end() ; ++i) {
-        for (const auto & j : *i) {
-            /*
-             * A score of 0 means no dependencies at all
-             * A score of 1 means "j" has a dependency on what's being inserted
-             * A score of 2 means what's being inserted depends on "j"
-             */
-            auto score = j->dependsOn(*ptr);
+    for (size_t i { 0 } ; i < n ; ++i) {
+        first[i] = edges.size();
+
+        names.clear();
+        types[i]->dependencies (names);
 
-            if (score == 1) {
-                insertionPoint = std::next(i);
-            } else if (score == 2) {
-                insertionPoint = i;
-                goto done;
+        for (const auto & name : names) {
+            auto dependency = index.find (name);
+
+            // primitives and anything else not in the schema don't count,
+            // nor does a type that refers to itself
+            if (dependency != index.end() && dependency->second != i) {
+                edges.push_back (dependency->second);
             }
         }
     }
-done:
+
+    first[n] = edges.size();
+
+    std::vector<size_t> firstBack (n + 1);
+    std::vector<size_t> back (edges.size());
+
+    for (auto e : edges) {
+        ++firstBack[e + 1];
+    }
+
+    std::partial_sum (firstBack.begin(), firstBack.end(), firstBack.begin());
+
+    {
+        auto fill { firstBack };
+
+        for (size_t i { 0 } ; i < n ; ++i) {
+            for (auto e { first[i] } ; e < first[i + 1] ; ++e) {
+                back[fill[edges[e]]++] = i;
+            }
+        }
+    }
+
+    constexpr auto unplaced { std::numeric_limits<size_t>::max() };
 
     /*
-     * Now we insert it and work out if anything requires shuffling
+     * waiting[i] is how many of the types [i] depends on are still to be
+     * placed
      */
-    if (insertionPoint == m_schemas.end()) {
-        insertNewList (std::move(ptr));
-    } else {
-        const auto & insertedPtr = insertionPoint->emplace_front (std::move(ptr));
-
-        for (auto j = std::next (insertionPoint->begin()) ; j != insertionPoint->end() ; ) {
-            auto toErase = j++;
-
-            auto score { insertedPtr->dependsOn (**toErase) };
-
-            if (score > 0) {
-                uPtr<T> tmpPtr{std::move(*toErase)};
-                insertionPoint->erase (toErase);
-                switch (score) {
-                    // Needs to go after the element we're adding
-                    case 1: {
-                        insert(std::move(tmpPtr), std::next(insertionPoint));
-                        break;
-                    }
-                    // Needs to go before the element we're adding
-                    case 2: {
-                        insertNewList (std::move(tmpPtr), insertionPoint);
+    std::vector<size_t> waiting (n);
+    std::vector<size_t> level (n, unplaced);
+    std::vector<size_t> seen (n, unplaced);
+    std::vector<size_t> current;
+    std::vector<size_t> next;
+    size_t levels { 0 };
+    size_t walks { 0 };
+    auto remaining { n };
+
+    for (size_t i { 0 } ; i < n ; ++i) {
+        waiting[i] = first[i + 1] - first[i];
+
+        if (waiting[i] == 0) {
+            current.push_back (i);
+        }
+    }
+
+    for (;;) {
+        if (current.empty()) {
+            while (remaining > 0 && level[remaining - 1] != unplaced) {
+                --remaining;
+            }
+
+            if (remaining == 0) {
+                break;
+            }
+
+            /*
+             * Everything left is in a dependency cycle or depends on one.
+             * Following what's still waiting to be placed has to come round
+             * to a type twice, and that one is in a cycle, so break it there
+             */
+            auto i { remaining - 1 };
+
+            for (++walks ; seen[i] != walks ; ) {
+                seen[i] = walks;
+
+                for (auto e { first[i] } ; ; ++e) {
+                    if (level[edges[e]] == unplaced) {
+                        i = edges[e];
                         break;
                     }
                 }
+            }
+
+            DBG ("Breaking dependency cycle at " << types[i]->name() << std::endl);
+
+            current.push_back (i);
+        }
+
+        for (auto i : current) {
+            level[i] = levels;
+
+            for (auto e { firstBack[i] } ; e < firstBack[i + 1] ; ++e) {
+                auto dependent { back[e] };
 
+                if (--waiting[dependent] == 0 && level[dependent] == unplaced) {
+                    next.push_back (dependent);
+                }
             }
         }
+
+        ++levels;
+        current.swap (next);
+        next.clear();
     }
+
+    std::vector<std::list<uPtr<T>>> ordered (levels);
+
+    for (auto i { n } ; i-- > 0 ; ) {
+        ordered[level[i]].emplace_back (std::move (types[i]));
+    }
+
+    std::move (
+        ordered.begin(), ordered.end(), std::back_inserter (m_schemas));
 }
 
 /******************************************************************************/
@@ -67,86 +67,12 @@ Composite::type() const {
 
 /******************************************************************************/
 
-/**
- * Use a visitor style pattern to work out weather two types, composite or
- * restricted, are "less than" one or not. In this case we define being
- * "less than" not having a type that the other depends on. This will
- * eventually give us a set ordered in such a way we can simply create
- * each element in turn
- *
- * "...This object determines the order of the elements in the container: it is
- * a function pointer or a function object that takes two arguments of the same
- * type as the container elements, and returns true if the first argument is
- * considered to go before the second in the strict weak ordering it defines,
- * and false otherwise. ..."
-
- *
- * @param rhs
- * @return
- */
-int
-amqp::internal::schema::
-Composite::dependsOn (const OrderedTypeNotation & rhs) const {
-    return dynamic_cast<const AMQPTypeNotation &>(rhs).dependsOnRHS(*this);
-}
-
-/******************************************************************************/
-
-int
-amqp::internal::schema::
-Composite::dependsOnRHS (
-        const amqp::internal::schema::Restricted & lhs_
-) const {
-    // does this depend on the left hand side
-    for (auto const & field : m_fields) {
-        DBG ("  C/R b) " << field->resolvedType() << " == " << lhs_.name() << std::endl); // NOLINT
-
-        if (field->resolvedType() == lhs_.name()) {
-            return 1;
-        }
-    }
-
-    // does the left hand side depend on us
-    for (const auto i : lhs_) {
-        DBG ("  C/R a) " << i << " == " << name() << std::endl); // NOLINT
-        if (i == name()) {
-            return 2;
-        }
-    }
-
-    return 0;
-}
-
-/*********************************************************o*********************/
-
-int
+void
 amqp::internal::schema::
-Composite::dependsOnRHS (
-        const amqp::internal::schema::Composite & lhs_
-) const {
-    DBG (name() << " ?Depends on " << lhs_.name() << std::endl);
-
-    // do we depend on the lhs
+Composite::dependencies (std::vector<std::string_view> & deps_) const {
     for (const auto & field : m_fields) {
-        DBG ("FIELD - " << name() << "::" << type() << std::endl);
-        DBG ("  C/C a) " << field->resolvedType() << " == " << lhs_.name() << std::endl); // NOLINT
-
-        if (field->resolvedType() == lhs_.name()) {
-            return 1;
-        }
-    }
-
-    // does it depend on us
-    for (auto const & field : lhs_) {
-        DBG ("FIELD - " << name() << "::" << type() << std::endl);
-        DBG ("  C/C b) " << field->resolvedType() << " == " << name() << std::endl); // NOLINT
-        if (field->resolvedType() == name()) {
-            return 2;
-        }
+        deps_.emplace_back (field->resolvedType());
     }
-
-
-    return 0;
 }
 
 /******************************************************************************/
@@ -6,6 +6,7 @@
 #include <vector>
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <types.h>
 
 #include "schema/field-types/Field.h"
@@ -72,9 +73,7 @@ namespace amqp::internal::schema {
 
             Type type() const override;
 
-            int dependsOn (const OrderedTypeNotation &) const override;
-            int dependsOnRHS (const class Restricted &) const override;
-            int dependsOnRHS (const Composite &) const override;
+            void dependencies (std::vector<std::string_view> &) const override;
 
             decltype(m_fields)::const_iterator begin() const { return m_fields.cbegin();}
             decltype(m_fields)::const_iterator end() const { return m_fields.cend(); }
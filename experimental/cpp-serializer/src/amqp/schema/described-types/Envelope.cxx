@@ -29,9 +29,27 @@ operator << (
 amqp::internal::schema::
 Envelope::Envelope (
     uPtr<Schema> & schema_,
-    std::string descriptor_
+    std::string descriptor_,
+    uPtr<Transforms> transforms_
 ) : m_schema (std::move (schema_))
   , m_descriptor (std::move (descriptor_))
+  , m_transforms (transforms_
+        ? std::move (transforms_)
+        : std::make_unique<Transforms>())
+{ }
+
+/******************************************************************************/
+
+amqp::internal::schema::
+Envelope::Envelope (
+    sPtr<const Schema> schema_,
+    std::string descriptor_,
+    uPtr<Transforms> transforms_
+) : m_schema (std::move (schema_))
+  , m_descriptor (std::move (descriptor_))
+  , m_transforms (transforms_
+        ? std::move (transforms_)
+        : std::make_unique<Transforms>())
 { }
 
 /******************************************************************************/
@@ -51,3 +69,11 @@ Envelope::descriptor() const {
 }
 
 /******************************************************************************/
+
+const amqp::internal::schema::Transforms &
+amqp::internal::schema::
+Envelope::transforms() const {
+    return *m_transforms;
+}
+
+/******************************************************************************/
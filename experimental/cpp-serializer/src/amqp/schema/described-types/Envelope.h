@@ -2,9 +2,11 @@
 
 /******************************************************************************/
 
+#include "types.h"
 #include "amqp/AMQPDescribed.h"
 
 #include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Transforms.h"
 
 #include <iosfwd>
 
@@ -17,19 +19,34 @@ namespace amqp::internal::schema {
             friend std::ostream & operator << (std::ostream &, const Envelope &);
 
         private :
-            std::unique_ptr<Schema> m_schema;
+            // shared since under a lazy build the schema belongs to
+            // whichever earlier blob we first saw it on
+            sPtr<const Schema> m_schema;
             std::string m_descriptor;
+            uPtr<Transforms> m_transforms;
 
         public :
             Envelope() = delete;
 
             Envelope (
                 std::unique_ptr<Schema> & schema_,
-                std::string descriptor_);
+                std::string descriptor_,
+                uPtr<Transforms> transforms_ = nullptr);
+
+            Envelope (
+                sPtr<const Schema> schema_,
+                std::string descriptor_,
+                uPtr<Transforms> transforms_ = nullptr);
 
             const ISchemaType & schema() const;
 
             const std::string & descriptor() const;
+
+            /**
+             * What's been done to the types of the schema over time, see
+             * [reader::EnumMapping]
+             */
+            const Transforms & transforms() const;
     };
 
 }
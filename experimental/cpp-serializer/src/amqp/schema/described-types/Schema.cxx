@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <iostream>
+#include <stdexcept>
 
 /******************************************************************************
  *
@@ -45,8 +46,10 @@ Schema::Schema (
     for (auto i { m_types.begin() } ; i != m_types.end() ; ++i) {
         for (auto & j : *i) {
             DBG ("Schema: " << j->descriptor() << " " << j->name() << std::endl); // NOLINT
-            m_descriptorToType.emplace (j->descriptor(), std::ref (j));
+            auto [it, _] = m_descriptorToType.emplace (j->descriptor(), std::ref (j));
             m_typeToDescriptor.emplace (j->name(), std::ref (j));
+
+            m_symbolToType.emplace (Symbols::intern (j->descriptor()), it);
         }
     }
 }
@@ -77,3 +80,20 @@ Schema::fromDescriptor (const std::string & descriptor_) const {
 
 /******************************************************************************/
 
+amqp::internal::schema::SchemaMap::const_iterator
+amqp::internal::schema::
+Schema::fromDescriptor (Symbols::id_t descriptor_) const {
+    auto it = m_symbolToType.find (descriptor_);
+
+    if (it == m_symbolToType.end()) {
+        throw std::runtime_error (
+            descriptor_ == Symbols::unknown
+                ? std::string ("Unknown descriptor")
+                : "No type in the schema for " + Symbols::name (descriptor_));
+    }
+
+    return it->second;
+}
+
+/******************************************************************************/
+
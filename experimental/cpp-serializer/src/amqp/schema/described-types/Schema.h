@@ -5,8 +5,10 @@
 #include <set>
 #include <map>
 #include <iosfwd>
+#include <unordered_map>
 
 #include "types.h"
+#include "amqp/Symbols.h"
 #include "Composite.h"
 #include "Descriptor.h"
 #include "schema/OrderedTypeNotations.h"
@@ -43,6 +45,8 @@ namespace amqp::internal::schema {
             SchemaMap m_descriptorToType;
             SchemaMap m_typeToDescriptor;
 
+            std::unordered_map<Symbols::id_t, SchemaMap::const_iterator> m_symbolToType;
+
         public :
             explicit Schema (OrderedTypeNotations<AMQPTypeNotation>);
 
@@ -50,6 +54,7 @@ namespace amqp::internal::schema {
 
             SchemaMap::const_iterator fromType (const std::string &) const override;
             SchemaMap::const_iterator fromDescriptor (const std::string &) const override ;
+            SchemaMap::const_iterator fromDescriptor (Symbols::id_t) const override;
 
             decltype (m_types.begin()) begin() const { return m_types.begin(); }
             decltype (m_types.end()) end() const { return m_types.end(); }
@@ -0,0 +1,126 @@
+#include "Transforms.h"
+
+#include <iostream>
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+std::ostream &
+operator << (std::ostream & os_, const Transform & transform_) {
+    switch (transform_.m_kind) {
+        case Transform::Kind::EnumDefault : os_ << "EnumDefault"; break;
+        case Transform::Kind::Rename      : os_ << "Rename"; break;
+        default                           : os_ << "Unknown"; break;
+    }
+
+    os_ << " " << transform_.m_from << " -> " << transform_.m_to;
+
+    return os_;
+}
+
+/******************************************************************************/
+
+std::ostream &
+operator << (std::ostream & os_, const Transforms & transforms_) {
+    for (const auto & type : transforms_.m_types) {
+        os_ << type.first << std::endl;
+
+        for (const auto & transform : type.second) {
+            os_ << "  " << transform << std::endl;
+        }
+    }
+
+    return os_;
+}
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::Transform
+ *
+ ******************************************************************************/
+
+amqp::internal::schema::
+Transform::Transform (
+    Kind kind_,
+    std::string from_,
+    std::string to_
+) : m_kind (kind_)
+  , m_from (std::move (from_))
+  , m_to (std::move (to_))
+{ }
+
+/******************************************************************************/
+
+amqp::internal::schema::Transform::Kind
+amqp::internal::schema::
+Transform::kind() const {
+    return m_kind;
+}
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::schema::
+Transform::from() const {
+    return m_from;
+}
+
+/******************************************************************************/
+
+const std::string &
+amqp::internal::schema::
+Transform::to() const {
+    return m_to;
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::Transforms
+ *
+ ******************************************************************************/
+
+amqp::internal::schema::
+Transforms::Transforms (TransformsMap types_)
+    : m_types (std::move (types_))
+{ }
+
+/******************************************************************************/
+
+bool
+amqp::internal::schema::
+Transforms::empty() const {
+    return m_types.empty();
+}
+
+/******************************************************************************/
+
+const std::vector<amqp::internal::schema::Transform> &
+amqp::internal::schema::
+Transforms::operator[] (const std::string & type_) const {
+    static const std::vector<Transform> none;
+
+    auto it = m_types.find (type_);
+
+    return it == m_types.end() ? none : it->second;
+}
+
+/******************************************************************************/
+
+amqp::internal::schema::Transforms::TransformsMap::const_iterator
+amqp::internal::schema::
+Transforms::begin() const {
+    return m_types.begin();
+}
+
+/******************************************************************************/
+
+amqp::internal::schema::Transforms::TransformsMap::const_iterator
+amqp::internal::schema::
+Transforms::end() const {
+    return m_types.end();
+}
+
+/******************************************************************************/
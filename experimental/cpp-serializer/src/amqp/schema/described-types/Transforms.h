@@ -0,0 +1,78 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstdint>
+
+#include "types.h"
+#include "amqp/AMQPDescribed.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * A change made to a type since it was first written, as recorded by
+     * Corda's transform annotations. The two kinds we know of are both for
+     * enums and both say the constant [from] reads as [to]
+     *
+     *  Rename       [from] has since been renamed [to]
+     *  EnumDefault  [from] was added later, anything that doesn't know it
+     *               reads it as the older [to]
+     *
+     * Any other kind is Unknown and ignored.
+     */
+    class Transform : public AMQPDescribed {
+        public :
+            enum class Kind : uint8_t { Unknown, EnumDefault, Rename };
+
+            friend std::ostream & operator << (std::ostream &, const Transform &);
+
+        private :
+            Kind m_kind;
+            std::string m_from;
+            std::string m_to;
+
+        public :
+            Transform (Kind, std::string, std::string);
+
+            Kind kind() const;
+            const std::string & from() const;
+            const std::string & to() const;
+    };
+
+    /**
+     * The transforms section of an envelope, the transforms of each type
+     * in its schema that's had any
+     */
+    class Transforms : public AMQPDescribed {
+        public :
+            friend std::ostream & operator << (std::ostream &, const Transforms &);
+
+            using TransformsMap = std::map<std::string, std::vector<Transform>>;
+
+        private :
+            TransformsMap m_types;
+
+        public :
+            Transforms() = default;
+            explicit Transforms (TransformsMap);
+
+            bool empty() const;
+
+            /**
+             * Those of the type named [type_], none if it's not changed
+             */
+            const std::vector<Transform> & operator[] (const std::string & type_) const;
+
+            TransformsMap::const_iterator begin() const;
+            TransformsMap::const_iterator end() const;
+    };
+
+}
+
+/******************************************************************************/
@@ -70,6 +70,12 @@ namespace amqp::internal::schema::descriptors {
 
             void validateAndNext (pn_data_t *) const;
 
+            /**
+             * Whether [data_] is on this descriptor, as [validateAndNext]
+             * but neither throwing nor moving
+             */
+            bool matches (pn_data_t * data_) const;
+
             virtual std::unique_ptr<AMQPDescribed> build (pn_data_t *) const;
 
             virtual void read (
@@ -13,6 +13,7 @@
 
 #include <limits>
 #include <climits>
+#include <stdexcept>
 
 /******************************************************************************/
 
@@ -21,8 +22,7 @@
  */
 namespace amqp::internal {
 
-    std::map<uint64_t, std::shared_ptr<internal::schema::descriptors::AMQPDescriptor>>
-    AMQPDescriptorRegistory = {
+    const DescriptorRegistry AMQPDescriptorRegistory { {
         {
             22UL,
             std::make_shared<internal::schema::descriptors::AMQPDescriptor> ("DESCRIBED", -1)
@@ -93,7 +93,22 @@ namespace amqp::internal {
                     "TRANSFORM_ELEMENT_KEY",
                     ::amqp::schema::descriptors::TRANSFORM_ELEMENT_KEY)
         }
-    };
+    } };
+}
+
+/******************************************************************************/
+
+const amqp::internal::DescriptorRegistry::Descriptor &
+amqp::internal::
+DescriptorRegistry::at (uint64_t id_) const {
+    auto it = m_table.find (id_);
+
+    if (it == m_table.end()) {
+        throw std::runtime_error (
+                "Unknown descriptor " + std::to_string (id_));
+    }
+
+    return it->second;
 }
 
 /******************************************************************************/
@@ -15,11 +15,40 @@
 /******************************************************************************/
 
 /**
- *
+ * Every descriptor we understand, keyed on its AMQP descriptor. It's
+ * built during static initialisation and never changes after, so any
+ * number of threads can look things up in it without locking. Looking
+ * up something that isn't there throws rather than, as a std::map's
+ * operator[] would, adding a null descriptor for it.
  */
 namespace amqp::internal {
 
-    extern std::map<uint64_t, std::shared_ptr<internal::schema::descriptors::AMQPDescriptor>> AMQPDescriptorRegistory;
+    class DescriptorRegistry {
+        public :
+            using Descriptor = std::shared_ptr<const schema::descriptors::AMQPDescriptor>;
+            using Table = std::map<uint64_t, Descriptor>;
+            using const_iterator = Table::const_iterator;
+
+        private :
+            const Table m_table;
+
+        public :
+            explicit DescriptorRegistry (Table table_)
+                : m_table { std::move (table_) }
+            { }
+
+            DescriptorRegistry (const DescriptorRegistry &) = delete;
+            DescriptorRegistry & operator = (const DescriptorRegistry &) = delete;
+
+            const_iterator find (uint64_t id_) const { return m_table.find (id_); }
+            const_iterator begin() const { return m_table.begin(); }
+            const_iterator end() const { return m_table.end(); }
+
+            const Descriptor & at (uint64_t) const;
+            const Descriptor & operator[] (uint64_t id_) const { return at (id_); }
+    };
+
+    extern const DescriptorRegistry AMQPDescriptorRegistory;
 
 }
 
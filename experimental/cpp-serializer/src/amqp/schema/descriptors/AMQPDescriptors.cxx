@@ -12,6 +12,7 @@
 #include "field-types/Field.h"
 #include "amqp/schema/described-types/Schema.h"
 #include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/described-types/Transforms.h"
 #include "amqp/schema/described-types/Composite.h"
 #include "amqp/schema/restricted-types/Restricted.h"
 #include "amqp/schema/OrderedTypeNotations.h"
@@ -33,9 +34,7 @@ AMQPDescriptor::validateAndNext (pn_data_t * const data_) const {
         throw std::runtime_error ("Bad type for a descriptor");
     }
 
-    if (   (m_val == -1)
-        || (pn_data_get_ulong(data_) != (static_cast<uint32_t>(m_val) | amqp::schema::descriptors::DESCRIPTOR_TOP_32BITS)))
-    {
+    if (!matches (data_)) {
         throw std::runtime_error ("Invalid Type");
     }
 
@@ -44,6 +43,17 @@ AMQPDescriptor::validateAndNext (pn_data_t * const data_) const {
 
 /******************************************************************************/
 
+bool
+amqp::internal::schema::descriptors::
+AMQPDescriptor::matches (pn_data_t * const data_) const {
+    return pn_data_type (data_) == PN_ULONG
+        && m_val != -1
+        && pn_data_get_ulong (data_)
+            == (static_cast<uint32_t>(m_val) | amqp::schema::descriptors::DESCRIPTOR_TOP_32BITS);
+}
+
+/******************************************************************************/
+
 uPtr<amqp::AMQPDescribed>
 amqp::internal::schema::descriptors::
 ReferencedObjectDescriptor::build (pn_data_t * data_) const {
@@ -63,7 +73,35 @@ TransformSchemaDescriptor::build (pn_data_t * data_) const {
 
     DBG ("TRANSFORM SCHEMA " << data_ << std::endl); // NOLINT
 
-    return uPtr<amqp::AMQPDescribed> (nullptr);
+    schema::Transforms::TransformsMap types;
+
+    /*
+     * A map of type names to maps of the kind of transform, itself a
+     * described type, to a list of them. Each transform names its own
+     * kind again so we needn't read the keys
+     */
+    {
+        proton::auto_map_enter ame (data_);
+
+        while (pn_data_next (data_)) {
+            auto & transforms = types[proton::get_string (data_)];
+
+            pn_data_next (data_);
+            proton::auto_map_enter ame2 (data_);
+
+            while (pn_data_next (data_)) {
+                pn_data_next (data_);
+                proton::auto_list_enter ale (data_);
+
+                while (pn_data_next (data_)) {
+                    transforms.push_back (std::move (*dispatchDescribed<schema::Transform> (
+                            data_)));
+                }
+            }
+        }
+    }
+
+    return std::make_unique<schema::Transforms> (std::move (types));
 }
 
 /******************************************************************************/
@@ -75,7 +113,30 @@ TransformElementDescriptor::build (pn_data_t * data_) const {
 
     DBG ("TRANSFORM ELEMENT " << data_ << std::endl); // NOLINT
 
-    return uPtr<amqp::AMQPDescribed> (nullptr);
+    /*
+     * A list of the kind's name and, for those we know of, the two
+     * constants it relates
+     */
+    proton::auto_list_enter ale (data_, true);
+
+    auto name = proton::readAndNext<std::string> (data_);
+
+    auto kind = name == "EnumDefault" ? schema::Transform::Kind::EnumDefault
+        : name == "Rename" ? schema::Transform::Kind::Rename
+        : schema::Transform::Kind::Unknown;
+
+    if (kind == schema::Transform::Kind::Unknown || ale.elements() < 3) {
+        return std::make_unique<schema::Transform> (
+                schema::Transform::Kind::Unknown, "", "");
+    }
+
+    auto first = proton::readAndNext<std::string> (data_);
+    auto second = proton::readAndNext<std::string> (data_);
+
+    // an EnumDefault gives the old constant first, a Rename the new one last
+    return kind == schema::Transform::Kind::EnumDefault
+        ? std::make_unique<schema::Transform> (kind, second, first)
+        : std::make_unique<schema::Transform> (kind, first, second);
 }
 
 /******************************************************************************/
@@ -87,6 +148,7 @@ TransformElementKeyDescriptor::build (pn_data_t * data_) const {
 
     DBG ("TRANSFORM ELEMENT KEY" << data_ << std::endl); // NOLINT
 
+    // only ever a map key, see TransformSchemaDescriptor::build
     return uPtr<amqp::AMQPDescribed> (nullptr);
 }
 
@@ -2,6 +2,7 @@
 
 #include "amqp/schema/described-types/Schema.h"
 #include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/descriptors/AMQPDescriptors.h"
 #include "proton/proton_wrapper.h"
 
 #include "types.h"
@@ -13,11 +14,27 @@
 
 namespace {
 
-    const std::string
-    consumeBlob (pn_data_t * data_) {
-        proton::is_described (data_);
-        proton::auto_enter p (data_);
-        return proton::get_symbol<std::string> (data_);
+    amqp::Error
+    error (amqp::Errc code_, pn_data_t * data_) {
+        return { code_, proton::offset (data_) };
+    }
+
+    /**
+     * The schema and transforms sections are built by descriptors that
+     * throw, anything they throw means the section wasn't what it should
+     * have been
+     */
+    template<class F>
+    auto
+    section (pn_data_t * data_, F f_) -> amqp::Result<decltype (f_())> {
+        auto offset = proton::offset (data_);
+
+        try {
+            return f_();
+        } catch (const std::exception & e) {
+            DBG ("Bad section: " << e.what() << std::endl); // NOLINT
+            return amqp::Error { amqp::Errc::BadSchema, offset };
+        }
     }
 
 }
@@ -75,9 +92,57 @@ EnvelopeDescriptor::EnvelopeDescriptor (
 uPtr<amqp::AMQPDescribed>
 amqp::internal::schema::descriptors::
 EnvelopeDescriptor::build (pn_data_t * data_) const {
+    return build (data_, [](pn_data_t * schema_) {
+        return sPtr<const schema::Schema> (
+            descriptors::dispatchDescribed<schema::Schema> (schema_));
+    });
+}
+
+/******************************************************************************/
+
+/**
+ * Building the schema is the bulk of the cost of reading the envelope,
+ * walking every field and choice of every type, so leave how that happens
+ * to [resolver_]. It can hand back a schema it's already built rather
+ * than parse the section again, in which case the cursor simply steps
+ * over it.
+ */
+uPtr<amqp::internal::schema::Envelope>
+amqp::internal::schema::descriptors::
+EnvelopeDescriptor::build (
+    pn_data_t * data_,
+    const SchemaResolver & resolver_
+) const {
+    return tryBuild (data_, [&resolver_](pn_data_t * schema_) {
+        return amqp::Result<sPtr<const schema::Schema>> (resolver_ (schema_));
+    }).value();
+}
+
+/******************************************************************************/
+
+/**
+ * Everything about the envelope itself is checked as we go, how the
+ * schema is read being up to [resolver_]. The transforms are parsed
+ * every time, though they're almost always an empty map.
+ */
+amqp::Result<uPtr<amqp::internal::schema::Envelope>>
+amqp::internal::schema::descriptors::
+EnvelopeDescriptor::tryBuild (
+    pn_data_t * data_,
+    const TrySchemaResolver & resolver_
+) const {
     DBG ("ENVELOPE" << std::endl); // NOLINT
 
-    validateAndNext(data_);
+    if (!matches (data_)) {
+        return error (amqp::Errc::NotAnEnvelope, data_);
+    }
+
+    pn_data_next (data_);
+
+    // the blob, its schema and the transforms
+    if (pn_data_type (data_) != PN_LIST || pn_data_get_list (data_) != 3) {
+        return error (amqp::Errc::NotAnEnvelope, data_);
+    }
 
     proton::auto_enter p (data_);
 
@@ -87,25 +152,66 @@ EnvelopeDescriptor::build (pn_data_t * data_) const {
      * have any so we are actually going to need to use the schema
      * which we parse *after* this to be able to read any data!
      */
-    std::string outerType = consumeBlob(data_);
+    if (!pn_data_is_described (data_)) {
+        return error (amqp::Errc::UnexpectedType, data_);
+    }
+
+    std::string outerType;
+
+    {
+        proton::auto_enter p2 (data_);
+
+        if (pn_data_type (data_) != PN_SYMBOL) {
+            return error (amqp::Errc::UnexpectedType, data_);
+        }
+
+        auto symbol = pn_data_get_symbol (data_);
+        outerType.assign (symbol.start, symbol.size);
+    }
 
     pn_data_next (data_);
 
     /*
      * The schema
      */
-    auto schema = descriptors::dispatchDescribed<schema::Schema> (data_);
+    auto schema = resolver_ (data_);
 
-    pn_data_next(data_);
+    if (!schema) {
+        return schema.error();
+    }
+
+    pn_data_next (data_);
 
     /*
-     * The transforms schema
+     * The transforms schema, almost always an empty map
      */
-    // Skip for now
-    // dispatchDescribed (data_);
+    if (!pn_data_is_described (data_)) {
+        return error (amqp::Errc::BadSchema, data_);
+    }
+
+    auto transforms = section (data_, [data_]() {
+        return descriptors::dispatchDescribed<schema::Transforms> (data_);
+    });
+
+    if (!transforms) {
+        return transforms.error();
+    }
 
-    return std::make_unique<schema::Envelope> (schema::Envelope (schema, outerType));
+    return std::make_unique<schema::Envelope> (
+            std::move (*schema), outerType, std::move (*transforms));
 }
 
 /******************************************************************************/
 
+amqp::Result<uPtr<amqp::internal::schema::Envelope>>
+amqp::internal::schema::descriptors::
+EnvelopeDescriptor::tryBuild (pn_data_t * data_) const {
+    return tryBuild (data_, [](pn_data_t * schema_) {
+        return section (schema_, [schema_]() {
+            return sPtr<const schema::Schema> (
+                descriptors::dispatchDescribed<schema::Schema> (schema_));
+        });
+    });
+}
+
+/******************************************************************************/
@@ -2,8 +2,12 @@
 
 
 #include <string>
+#include <functional>
 
-#include "AMQPDescriptors.h"
+#include "amqp/Result.h"
+#include "amqp/schema/descriptors/AMQPDescriptor.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
 
 /******************************************************************************
  *
@@ -23,6 +27,20 @@ namespace amqp::internal::schema::descriptors {
 
     class EnvelopeDescriptor : public AMQPDescriptor {
         public :
+            /**
+             * Given the cursor on the described schema section, produce
+             * the [Schema] it describes.
+             */
+            using SchemaResolver = std::function<
+                sPtr<const schema::Schema> (pn_data_t *)>;
+
+            /**
+             * As a [SchemaResolver] but handing back what's wrong with
+             * the schema section rather than throwing
+             */
+            using TrySchemaResolver = std::function<
+                amqp::Result<sPtr<const schema::Schema>> (pn_data_t *)>;
+
             EnvelopeDescriptor() = delete;
             EnvelopeDescriptor (std::string, int);
 
@@ -30,6 +48,24 @@ namespace amqp::internal::schema::descriptors {
 
             std::unique_ptr<AMQPDescribed> build (pn_data_t *) const override;
 
+            std::unique_ptr<schema::Envelope> build (
+                    pn_data_t *,
+                    const SchemaResolver &) const;
+
+            /**
+             * As [build] but an envelope that isn't as it should be is an
+             * error rather than an exception, see [amqp::Result]
+             */
+            amqp::Result<std::unique_ptr<schema::Envelope>> tryBuild (
+                    pn_data_t *,
+                    const TrySchemaResolver &) const;
+
+            /**
+             * As above, parsing the schema in full
+             */
+            amqp::Result<std::unique_ptr<schema::Envelope>> tryBuild (
+                    pn_data_t *) const;
+
             void read (
                     pn_data_t *,
                     std::stringstream &,
@@ -22,11 +22,11 @@ namespace {
             },
             {
                 "java.lang.Boolean",
-                std::pair { std::regex { "java.lang.Boolean"}, "bool"}
+                std::pair { std::regex { "java.lang.Boolean"}, "boolean"}
             },
             {
                 "java.lang.Byte",
-                std::pair { std::regex { "java.lang.Byte"}, "char"}
+                std::pair { std::regex { "java.lang.Byte"}, "byte"}
             },
             {
                 "java.lang.Short",
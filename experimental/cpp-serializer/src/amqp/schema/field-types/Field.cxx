@@ -12,6 +12,8 @@
 
 #include "../restricted-types/Array.h"
 
+#include "amqp/reader/Primitives.h"
+
 /******************************************************************************/
 
 namespace amqp::internal::schema {
@@ -118,11 +120,7 @@ Field::Field (
 bool
 amqp::internal::schema::
 Field::typeIsPrimitive (const std::string & type_) {
-    return (type_ == "string" ||
-            type_ == "long" ||
-            type_ == "boolean" ||
-            type_ == "int" ||
-            type_ == "double");
+    return reader::Primitives::isPrimitive (type_);
 }
 
 /******************************************************************************/
@@ -151,3 +149,19 @@ Field::requires() const {
 
 /******************************************************************************/
 
+const std::string &
+amqp::internal::schema::
+Field::defaultValue() const {
+    return m_default;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::schema::
+Field::mandatory() const {
+    return m_mandatory;
+}
+
+/******************************************************************************/
+
@@ -54,6 +54,12 @@ namespace amqp::internal::schema {
             const std::string & type() const;
             const std::list<std::string> & requires() const;
 
+            /**
+             * Empty if the field has no default
+             */
+            const std::string & defaultValue() const;
+            bool mandatory() const;
+
             virtual bool primitive() const = 0;
             virtual const std::string & fieldType() const = 0;
             virtual const std::string & resolvedType() const = 0;
@@ -12,11 +12,6 @@ namespace amqp::internal::schema {
             std::vector<std::string> m_enum;
             std::vector<uPtr<Choice>> m_choices;
 
-            int dependsOnMap (const Map &) const override;
-            int dependsOnList (const List &) const override;
-            int dependsOnEnum (const Enum &) const override;
-            int dependsOnArray (const Array &) const override;
-
         public :
             Enum (
                 uPtr<Descriptor> descriptor_,
@@ -29,7 +24,7 @@ namespace amqp::internal::schema {
             std::vector<std::string>::const_iterator begin() const override;
             std::vector<std::string>::const_iterator end() const override;
 
-            int dependsOnRHS (const Composite &) const override;
+            void dependencies (std::vector<std::string_view> &) const override;
 
             std::vector<std::string> makeChoices() const;
     };
@@ -15,11 +15,6 @@ namespace amqp::internal::schema {
             std::vector<std::string> m_listOf;
             std::string m_source;
 
-            int dependsOnMap (const Map &) const override;
-            int dependsOnList (const List &) const override;
-            int dependsOnEnum (const Enum &) const override;
-            int dependsOnArray (const Array &) const override;
-
         public :
             List (
                 uPtr<Descriptor> descriptor_,
@@ -32,8 +27,6 @@ namespace amqp::internal::schema {
             std::vector<std::string>::const_iterator end() const override;
 
             const std::string & listOf() const;
-
-            int dependsOnRHS (const Composite &) const override;
     };
 
 }
@@ -86,86 +86,3 @@ Map::mapOf() const {
 }
 
 /******************************************************************************/
-
-int
-amqp::internal::schema::
-Map::dependsOnMap (const amqp::internal::schema::Map & lhs_) const {
-    // do we depend on the lhs
-    if (m_mapOf[0] == lhs_.name() || m_mapOf[1] == lhs_.name()) {
-        return 1;
-    }
-
-    // does lhs_ depend on us
-    auto lhsMapOf { lhs_.mapOf() };
-    if (lhsMapOf.first.get() == name() || lhsMapOf.second.get() == name()) {
-        return 2;
-    }
-
-    return 0;
-}
-
-/******************************************************************************/
-
-int
-amqp::internal::schema::
-Map::dependsOnList (const amqp::internal::schema::List & lhs_) const {
-    // do we depend on the lhs
-    if (m_mapOf[0] == lhs_.name() || m_mapOf[1] == lhs_.name()) {
-        return 1;
-    }
-
-    // does lhs_ depend on us
-    if (lhs_.listOf() == name()) {
-        return 2;
-    }
-
-    return 0;
-}
-
-/******************************************************************************/
-
-int
-amqp::internal::schema::
-Map::dependsOnArray (const amqp::internal::schema::Array & lhs_) const {
-    return 0;
-}
-
-/******************************************************************************/
-
-int
-amqp::internal::schema::
-Map::dependsOnEnum (const amqp::internal::schema::Enum & lhs_) const {
-    // do we depend on the lhs
-    if (m_mapOf[0] == lhs_.name() || m_mapOf[1] == lhs_.name()) {
-        return 1;
-    }
-
-    // does lhs_ depend on us
-    if (lhs_.name() == name()) {
-        return 2;
-    }
-
-    return 0;
-}
-
-/******************************************************************************/
-
-int
-amqp::internal::schema::
-Map::dependsOnRHS (const amqp::internal::schema::Composite & lhs_) const  {
-    // do we depend on the lhs
-    if (m_mapOf[0] == lhs_.name() || m_mapOf[1] == lhs_.name()) {
-        return 1;
-    }
-
-    // does lhs_ depend on us
-    for (const auto & field : lhs_.fields()) {
-        if (field->resolvedType() == name()) {
-            return 2;
-        }
-    }
-
-    return 0;
-}
-
-/******************************************************************************/
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Reader.h"
+#include "Arena.h"
+
+/******************************************************************************/
+
+using namespace amqp::reader;
+using namespace amqp::internal::reader;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Is [ptr_] somewhere within the first [size_] bytes handed out by
+     * [arena_]
+     */
+    bool
+    inArena (Arena & arena_, const void * ptr_, size_t size_) {
+        auto probe = static_cast<const std::byte *> (
+                arena_.resource()->allocate (1, 1));
+
+        return ptr_ < probe && ptr_ >= probe - size_;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Arena, noArenaUsesTheHeap) { // NOLINT
+    EXPECT_EQ (std::pmr::new_delete_resource(), Arena::current());
+
+    auto pair = std::make_unique<TypedPair<pmrString>> (
+        "property", arenaString ("value"));
+
+    EXPECT_EQ ("property : value", pair->dump());
+}
+
+/******************************************************************************/
+
+TEST (Arena, scope) { // NOLINT
+    Arena outer;
+    Arena inner;
+
+    {
+        Arena::Scope s1 (outer);
+        EXPECT_EQ (outer.resource(), Arena::current());
+
+        {
+            Arena::Scope s2 (inner);
+            EXPECT_EQ (inner.resource(), Arena::current());
+        }
+
+        EXPECT_EQ (outer.resource(), Arena::current());
+    }
+
+    EXPECT_EQ (std::pmr::new_delete_resource(), Arena::current());
+}
+
+/******************************************************************************/
+
+TEST (Arena, nodesStringsAndContainers) { // NOLINT
+    Arena arena;
+    uPtr<IValue> tree;
+
+    {
+        Arena::Scope scope (arena);
+
+        pmrVec<uPtr<IValue>> fields { Arena::current() };
+        fields.emplace_back (std::make_unique<TypedPair<pmrString>> (
+            "a", arenaString ("a value that won't fit in a small string")));
+        fields.emplace_back (std::make_unique<TypedPair<pmrString>> (
+            "b", arenaString ("2")));
+
+        EXPECT_EQ (arena.resource(), fields.get_allocator().resource());
+
+        auto & first = dynamic_cast<TypedPair<pmrString> &> (*fields[0]);
+        EXPECT_EQ (arena.resource(), first.value().get_allocator().resource());
+
+        tree = std::make_unique<TypedPair<pmrVec<uPtr<IValue>>>> (
+            "c", std::move (fields));
+    }
+
+    EXPECT_TRUE (inArena (arena, tree.get(), Arena::defaultSize));
+    EXPECT_EQ (
+        "c : { a : a value that won't fit in a small string, b : 2 }",
+        tree->dump());
+
+    // destroying the tree the normal way is fine, it just doesn't free
+    // anything until the arena goes
+    tree.reset();
+}
+
+/******************************************************************************/
+
+TEST (Arena, arenaPtr) { // NOLINT
+    auto arena = std::make_unique<Arena>();
+    Arena::Scope scope (*arena);
+
+    ArenaPtr<IValue> value (
+        std::move (arena),
+        std::make_unique<TypedSingle<pmrString>> (arenaString ("hello")));
+
+    EXPECT_EQ ("hello", value->dump());
+}
+
+/******************************************************************************/
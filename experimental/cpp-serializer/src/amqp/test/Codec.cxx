@@ -0,0 +1,330 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+/******************************************************************************
+ *
+ * Navigation over hand encoded blobs. The readers only depend on the
+ * pn_data_t API so whichever codec backs it these should hold.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    /*
+     * described (0x53 0x01) list8 [
+     *     smallint 5,
+     *     str8 "hi",
+     *     map8 { sym8 "k" : true },
+     *     array8 int [ 1, 2, 3 ]
+     * ]
+     */
+    const std::vector<char> blob { // NOLINT
+        0x00, 0x53, 0x01,
+        (char)0xc0, 0x1e, 0x04,
+            0x54, 0x05,
+            (char)0xa1, 0x02, 'h', 'i',
+            (char)0xc1, 0x05, 0x02, (char)0xa3, 0x01, 'k', 0x41,
+            (char)0xe0, 0x0e, 0x03, 0x71,
+                0x00, 0x00, 0x00, 0x01,
+                0x00, 0x00, 0x00, 0x02,
+                0x00, 0x00, 0x00, 0x03,
+        // trailing bytes that aren't part of the value
+        0x40, 0x40
+    };
+
+    std::string
+    str (pn_bytes_t bytes_) {
+        return std::string (bytes_.start, bytes_.size);
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Codec, decodeConsumesOneValue) { // NOLINT
+    auto data = pn_data (0);
+
+    EXPECT_EQ (blob.size() - 2, pn_data_decode (data, blob.data(), blob.size()));
+    EXPECT_EQ (PN_DESCRIBED, pn_data_type (data));
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+TEST (Codec, truncated) { // NOLINT
+    auto data = pn_data (0);
+
+    EXPECT_LT (pn_data_decode (data, blob.data(), 10), 0);
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+TEST (Codec, malformed) { // NOLINT
+    auto data = pn_data (0);
+
+    // a list8 and an array8 whose size doesn't leave room for their count
+    for (char code : { (char)0xc0, (char)0xe0 }) {
+        std::vector<char> empty { code, 0x00 };
+        EXPECT_LT (pn_data_decode (data, empty.data(), empty.size()), 0);
+    }
+
+    /*
+     * null described by null described by ... [depth_] times over
+     */
+    auto nested = [](size_t depth_) {
+        std::vector<char> rtn (depth_, 0x00);
+        rtn.insert (rtn.end(), depth_ + 1, 0x40);
+        return rtn;
+    };
+
+    auto shallow = nested (4);
+    EXPECT_EQ ((ssize_t)shallow.size(), pn_data_decode (data, shallow.data(), shallow.size()));
+
+#ifdef AMQP_CODEC_NATIVE
+    // deep enough to have taken the stack were it not refused
+    auto deep = nested (1000000);
+    EXPECT_LT (pn_data_decode (data, deep.data(), deep.size()), 0);
+#endif
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+TEST (Codec, navigate) { // NOLINT
+    auto data = pn_data (0);
+    pn_data_decode (data, blob.data(), blob.size());
+
+    ASSERT_TRUE (pn_data_is_described (data));
+    ASSERT_TRUE (pn_data_enter (data));
+    ASSERT_TRUE (pn_data_next (data));
+    EXPECT_EQ (PN_ULONG, pn_data_type (data));
+    EXPECT_EQ (1UL, pn_data_get_ulong (data));
+
+    ASSERT_TRUE (pn_data_next (data));
+    EXPECT_EQ (PN_LIST, pn_data_type (data));
+    EXPECT_EQ (4UL, pn_data_get_list (data));
+
+    ASSERT_TRUE (pn_data_enter (data));
+    {
+        ASSERT_TRUE (pn_data_next (data));
+        EXPECT_EQ (5, pn_data_get_int (data));
+
+        ASSERT_TRUE (pn_data_next (data));
+        EXPECT_EQ ("hi", str (pn_data_get_string (data)));
+
+        ASSERT_TRUE (pn_data_next (data));
+        EXPECT_EQ (2UL, pn_data_get_map (data));
+
+        ASSERT_TRUE (pn_data_enter (data));
+        {
+            ASSERT_TRUE (pn_data_next (data));
+            EXPECT_EQ ("k", str (pn_data_get_symbol (data)));
+            ASSERT_TRUE (pn_data_next (data));
+            EXPECT_TRUE (pn_data_get_bool (data));
+            EXPECT_FALSE (pn_data_next (data));
+        }
+        ASSERT_TRUE (pn_data_exit (data));
+        EXPECT_EQ (PN_MAP, pn_data_type (data));
+
+        ASSERT_TRUE (pn_data_next (data));
+        EXPECT_EQ (PN_ARRAY, pn_data_type (data));
+        EXPECT_EQ (3UL, pn_data_get_array (data));
+        EXPECT_EQ (PN_INT, pn_data_get_array_type (data));
+
+        ASSERT_TRUE (pn_data_enter (data));
+        {
+            for (int i { 1 } ; i <= 3 ; ++i) {
+                ASSERT_TRUE (pn_data_next (data));
+                EXPECT_EQ (i, pn_data_get_int (data));
+            }
+
+            // failing to move on leaves us where we were
+            EXPECT_FALSE (pn_data_next (data));
+            EXPECT_EQ (3, pn_data_get_int (data));
+        }
+        ASSERT_TRUE (pn_data_exit (data));
+
+        EXPECT_FALSE (pn_data_next (data));
+    }
+    ASSERT_TRUE (pn_data_exit (data));
+    EXPECT_EQ (PN_LIST, pn_data_type (data));
+
+    ASSERT_TRUE (pn_data_exit (data));
+    EXPECT_EQ (PN_DESCRIBED, pn_data_type (data));
+    EXPECT_FALSE (pn_data_exit (data));
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+TEST (Codec, wrongTypeReadsAsZero) { // NOLINT
+    auto data = pn_data (0);
+    pn_data_decode (data, blob.data(), blob.size());
+
+    pn_data_enter (data);
+    pn_data_next (data);
+
+    EXPECT_EQ (0, pn_data_get_int (data));
+    EXPECT_EQ (0UL, str (pn_data_get_string (data)).size());
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+/**
+ * Skipping moves on exactly as next does, the native codec counting the
+ * bytes of each value it steps over: the int's 1, the string's size and
+ * bytes, and everything after the constructor of the map and the array
+ */
+TEST (Codec, skip) { // NOLINT
+    auto data = pn_data (0);
+    pn_data_decode (data, blob.data(), blob.size());
+
+    pn_data_enter (data);
+    pn_data_next (data);
+    ASSERT_TRUE (pn_data_next (data));
+    ASSERT_TRUE (pn_data_enter (data));
+    ASSERT_TRUE (pn_data_next (data));
+
+    EXPECT_EQ (0UL, proton::skipped (data));
+
+    ASSERT_TRUE (proton::skip (data));
+    EXPECT_EQ (PN_STRING, pn_data_type (data));
+    ASSERT_TRUE (proton::skip (data));
+    EXPECT_EQ (PN_MAP, pn_data_type (data));
+    ASSERT_TRUE (proton::skip (data));
+    EXPECT_EQ (PN_ARRAY, pn_data_type (data));
+    EXPECT_FALSE (proton::skip (data));
+
+#ifdef AMQP_CODEC_NATIVE
+    EXPECT_EQ (25UL, proton::skipped (data));
+#else
+    EXPECT_EQ (0UL, proton::skipped (data));
+#endif
+
+    pn_data_decode (data, blob.data(), blob.size());
+    EXPECT_EQ (0UL, proton::skipped (data));
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+namespace {
+
+    template<typename T>
+    void
+    putBE (std::vector<char> & bytes_, T value_) {
+        for (int i = sizeof (T) - 1 ; i >= 0 ; --i) {
+            bytes_.push_back (static_cast<char> (
+                    static_cast<uint64_t> (value_) >> (i * 8)));
+        }
+    }
+
+    /**
+     * array32 of [n_] ints or longs, 0, -1, 2, -3...
+     */
+    template<typename T>
+    std::vector<char>
+    array (uint32_t n_) {
+        std::vector<char> rtn { (char)0xf0 };
+
+        putBE<uint32_t> (rtn, 4 + 1 + n_ * sizeof (T));
+        putBE<uint32_t> (rtn, n_);
+        rtn.push_back (sizeof (T) == 4 ? 0x71 : (char)0x81);
+
+        for (uint32_t i { 0 } ; i < n_ ; ++i) {
+            auto value = static_cast<T> (i);
+            putBE<T> (rtn, i % 2 ? -value : value);
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Long enough to go through the widest registers and then the remainder
+ */
+TEST (Codec, readPrimitivesArray) { // NOLINT
+    auto data = pn_data (0);
+
+    auto ints = array<int32_t> (37);
+    pn_data_decode (data, ints.data(), ints.size());
+
+    std::vector<int32_t> i32;
+    ASSERT_TRUE (proton::readPrimitives (data, i32));
+    ASSERT_EQ (37UL, i32.size());
+
+    for (int32_t i { 0 } ; i < 37 ; ++i) {
+        EXPECT_EQ (i % 2 ? -i : i, i32[i]);
+    }
+
+    // the wrong type altogether
+    std::vector<double> d;
+    EXPECT_FALSE (proton::readPrimitives (data, d));
+    EXPECT_TRUE (d.empty());
+
+    auto longs = array<int64_t> (11);
+    pn_data_decode (data, longs.data(), longs.size());
+
+    std::vector<int64_t> i64;
+    ASSERT_TRUE (proton::readPrimitives (data, i64));
+    ASSERT_EQ (11UL, i64.size());
+    EXPECT_EQ (-9, i64[9]);
+    EXPECT_EQ (10, i64[10]);
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
+
+/**
+ * Lists, which is what the JVM writes, mix the one and four byte forms,
+ * and might have a null in them
+ */
+TEST (Codec, readPrimitivesList) { // NOLINT
+    const std::vector<char> list { // NOLINT
+        (char)0xc0, 0x0a, 0x03,
+            0x54, (char)0xfb,
+            0x71, 0x00, 0x00, 0x01, 0x00,
+            0x54, 0x07
+    };
+
+    auto data = pn_data (0);
+    pn_data_decode (data, list.data(), list.size());
+
+    std::vector<int32_t> ints;
+    ASSERT_TRUE (proton::readPrimitives (data, ints));
+    EXPECT_EQ ((std::vector<int32_t> { -5, 256, 7 }), ints);
+
+    // and we've not moved
+    EXPECT_EQ (PN_LIST, pn_data_type (data));
+
+    // the last one a null instead
+    auto nulled = list;
+    nulled.pop_back();
+    nulled[1] = 0x09;
+    nulled[10] = 0x40;
+
+    pn_data_decode (data, nulled.data(), nulled.size());
+    EXPECT_FALSE (proton::readPrimitives (data, ints));
+
+    pn_data_free (data);
+}
+
+/******************************************************************************/
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "EnumMapping.h"
+#include "amqp/schema/described-types/Transforms.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::reader;
+using amqp::internal::schema::Transform;
+
+/******************************************************************************/
+
+namespace {
+
+    Transform
+    renamed (const std::string & from_, const std::string & to_) {
+        return Transform (Transform::Kind::Rename, from_, to_);
+    }
+
+    Transform
+    added (const std::string & added_, const std::string & as_) {
+        return Transform (Transform::Kind::EnumDefault, added_, as_);
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (EnumMapping, unevolved) { // NOLINT
+    EnumMapping mapping;
+
+    EXPECT_EQ ("A", mapping ("A"));
+
+    mapping.evolve ({ "A", "B" }, { });
+
+    EXPECT_EQ ("A", mapping ("A"));
+}
+
+/******************************************************************************/
+
+/**
+ * A was renamed B which was renamed C, so both read as C. D was added
+ * later still and as this version knows of it that's what it reads as
+ */
+TEST (EnumMapping, renames) { // NOLINT
+    EnumMapping mapping;
+
+    mapping.evolve (
+        { "C", "D" },
+        { renamed ("A", "B"), renamed ("B", "C"), added ("D", "C") });
+
+    EXPECT_EQ ("C", mapping ("A"));
+    EXPECT_EQ ("C", mapping ("B"));
+    EXPECT_EQ ("C", mapping ("C"));
+    EXPECT_EQ ("D", mapping ("D"));
+    EXPECT_EQ ("X", mapping ("X"));
+}
+
+/******************************************************************************/
+
+/**
+ * A version of the enum that's not heard of E or F, added after D with
+ * defaults of D and E, reads both as D
+ */
+TEST (EnumMapping, defaults) { // NOLINT
+    EnumMapping mapping;
+
+    mapping.evolve (
+        { "C", "D" },
+        { renamed ("A", "C"), added ("D", "C"), added ("E", "D"),
+          added ("F", "E") });
+
+    EXPECT_EQ ("C", mapping ("A"));
+    EXPECT_EQ ("D", mapping ("D"));
+    EXPECT_EQ ("D", mapping ("E"));
+    EXPECT_EQ ("D", mapping ("F"));
+}
+
+/******************************************************************************/
+
+/**
+ * The version we're told of last is the one that counts, however many
+ * transforms it has
+ */
+TEST (EnumMapping, replaced) { // NOLINT
+    EnumMapping mapping;
+
+    mapping.evolve ({ "B", "C" }, { renamed ("A", "B"), renamed ("B", "C") });
+
+    EXPECT_EQ ("C", mapping ("A"));
+
+    mapping.evolve ({ "B" }, { renamed ("A", "B") });
+
+    EXPECT_EQ ("B", mapping ("A"));
+    EXPECT_EQ ("B", mapping ("B"));
+
+    EnumMappings mappings;
+    auto shared = mappings["E"];
+
+    mappings.evolve ("E", { "B" }, { renamed ("A", "B") });
+
+    EXPECT_EQ ("B", (*shared) ("A"));
+    EXPECT_EQ (shared, mappings["E"]);
+}
+
+/******************************************************************************/
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <random>
+
+#include "writer/Escape.h"
+
+/******************************************************************************
+ *
+ * Every kernel the CPU has is checked against the same strings, each at
+ * every offset into a block so whatever's wrong with them is found
+ * wherever it falls.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal::writer;
+
+    const Kernel kernels[] = { Kernel::Scalar, Kernel::SSE42, Kernel::AVX2 }; // NOLINT
+
+    /**
+     * Runs [f_] once with each kernel the CPU supports
+     */
+    template<class F>
+    void
+    each (F f_) {
+        auto was = kernel();
+
+        for (auto k : kernels) {
+            if (use (k) == k) {
+                f_ (k);
+            }
+        }
+
+        use (was);
+    }
+
+    std::string
+    escaped (std::string_view str_) {
+        std::string rtn;
+        escape (rtn, str_);
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Escape, valid) { // NOLINT
+    const std::string good[] = { // NOLINT
+        "",
+        "plain ascii",
+        "\xc2\xa3",                 // £
+        "\xe2\x82\xac",             // €
+        "\xef\xbf\xbf",             // U+FFFF
+        "\xf0\x9f\x98\x80",         // 😀
+        "\xf4\x8f\xbf\xbf",         // U+10FFFF
+        "\xed\x9f\xbf",             // U+D7FF, just below the surrogates
+    };
+
+    const std::string bad[] = { // NOLINT
+        "\x80",                     // a lone continuation
+        "\xc2",                     // truncated
+        "\xe2\x82",
+        "\xf0\x9f\x98",
+        "\xc0\xaf",                 // overlong /
+        "\xe0\x80\xaf",
+        "\xf0\x80\x80\xaf",
+        "\xed\xa0\x80",             // U+D800
+        "\xf4\x90\x80\x80",         // U+110000
+        "\xf8\x88\x80\x80\x80",     // five bytes
+        "\xc2\x41",                 // ASCII where a continuation should be
+        "\xe2\x82\xac\xac",         // one continuation too many
+    };
+
+    each ([&](Kernel k_) {
+        for (size_t offset { 0 } ; offset < 40 ; ++offset) {
+            std::string prefix (offset, 'x');
+
+            for (const auto & s : good) {
+                EXPECT_TRUE (validUtf8 (prefix + s)) << int (k_) << " " << offset;
+                EXPECT_TRUE (validUtf8 (prefix + s + prefix)) << int (k_) << " " << offset;
+            }
+
+            for (const auto & s : bad) {
+                EXPECT_FALSE (validUtf8 (prefix + s)) << int (k_) << " " << offset;
+                EXPECT_FALSE (validUtf8 (prefix + s + prefix)) << int (k_) << " " << offset;
+            }
+        }
+    });
+}
+
+/******************************************************************************/
+
+/**
+ * Random bytes, mostly multibyte characters with the odd byte corrupted,
+ * have to be judged the same by every kernel
+ */
+TEST (Escape, kernelsAgree) { // NOLINT
+    std::mt19937 rng { 1234 };
+
+    const std::string pieces[] = { // NOLINT
+        "a", "\"", "\\", "\n", "\xc2\xa3", "\xe2\x82\xac", "\xf0\x9f\x98\x80"
+    };
+
+    for (int i { 0 } ; i < 2000 ; ++i) {
+        std::string str;
+
+        for (size_t n = rng() % 100 ; n > 0 ; --n) {
+            str += pieces[rng() % std::size (pieces)];
+        }
+
+        if (!str.empty() && rng() % 2) {
+            str[rng() % str.size()] = static_cast<char> (rng());
+        }
+
+        use (Kernel::Scalar);
+        auto valid = validUtf8 (str);
+        auto expected = escaped (str);
+
+        each ([&](Kernel k_) {
+            EXPECT_EQ (valid, validUtf8 (str)) << int (k_);
+            EXPECT_EQ (expected, escaped (str)) << int (k_);
+        });
+    }
+}
+
+/******************************************************************************/
+
+TEST (Escape, escape) { // NOLINT
+    each ([](Kernel) {
+        EXPECT_EQ (R"("")", escaped (""));
+        EXPECT_EQ (R"("q\"b\\n\nt\tc\u0001z\u001f")",
+                escaped ("q\"b\\n\nt\tc\x01z\x1f"));
+
+        // multibyte characters are copied as they are
+        EXPECT_EQ ("\"\xc2\xa3\x31\xe2\x82\xac\"", escaped ("\xc2\xa3\x31\xe2\x82\xac"));
+
+        // and anything that isn't one becomes U+FFFD
+        EXPECT_EQ ("\"a\xef\xbf\xbd\x62\xef\xbf\xbd\xef\xbf\xbd\"",
+                escaped ("a\xc0" "b\xed\xa0"));
+
+        // escapes either side of a block boundary
+        std::string long_ (70, 'x');
+        long_[15] = '"';
+        long_[16] = '\\';
+        long_[31] = '\n';
+        long_[32] = '\x7f';
+
+        auto expected = "\"" + std::string (15, 'x') + "\\\"\\\\"
+            + std::string (14, 'x') + "\\n\x7f" + std::string (37, 'x') + "\"";
+
+        EXPECT_EQ (expected, escaped (long_));
+    });
+}
+
+/******************************************************************************/
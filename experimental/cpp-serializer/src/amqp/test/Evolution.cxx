@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Evolution.h"
+#include "amqp/schema/field-types/Field.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/described-types/Descriptor.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::reader;
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    uPtr<Field>
+    field (
+        const std::string & name_,
+        const std::string & type_,
+        const std::string & default_ = "",
+        bool mandatory_ = false
+    ) {
+        return Field::make (name_, type_, { }, default_, "", mandatory_, false);
+    }
+
+    /**
+     * Version [fingerprint_] of the type with [fields_]
+     */
+    uPtr<Composite>
+    version (const std::string & fingerprint_, sVec<uPtr<Field>> fields_) {
+        return std::make_unique<Composite> (
+                "net.corda.C",
+                "",
+                std::list<std::string> { },
+                std::make_unique<Descriptor> ("net.corda:" + fingerprint_),
+                std::move (fields_));
+    }
+
+    template<class ... F>
+    uPtr<Composite>
+    version (const std::string & fingerprint_, F && ... fields_) {
+        sVec<uPtr<Field>> fields;
+        (fields.push_back (std::forward<F> (fields_)), ...);
+
+        return version (fingerprint_, std::move (fields));
+    }
+
+    void
+    target (Evolution & evolution_, uPtr<Composite> composite_) {
+        OrderedTypeNotations<AMQPTypeNotation> types;
+        types.insert (uPtr<AMQPTypeNotation> (std::move (composite_)));
+
+        evolution_.target (Schema (std::move (types)));
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Evolution, unevolved) { // NOLINT
+    Evolution evolution;
+
+    auto wire = version ("1", field ("a", "int"));
+
+    EXPECT_EQ (nullptr, evolution.plan (*wire));
+
+    target (evolution, version ("1", field ("a", "int")));
+
+    EXPECT_EQ (nullptr, evolution.plan (*wire));
+
+    // a fingerprint can change without any properties changing
+    target (evolution, version ("2", field ("a", "int")));
+
+    EXPECT_EQ (nullptr, evolution.plan (*wire));
+}
+
+/******************************************************************************/
+
+TEST (Evolution, addedAndRemoved) { // NOLINT
+    Evolution evolution;
+
+    target (evolution, version ("2",
+        field ("a", "int", "", true),
+        field ("c", "long", "", true),
+        field ("d", "string", "x"),
+        field ("e", "string")));
+
+    auto wire = version ("1",
+        field ("a", "int", "", true),
+        field ("b", "string"),
+        field ("c", "long", "", true));
+
+    auto plan = evolution.plan (*wire);
+
+    ASSERT_NE (nullptr, plan);
+    EXPECT_EQ ((std::vector<bool> { true, false, true }), plan->keep);
+
+    ASSERT_EQ (2, plan->missing.size());
+    EXPECT_EQ ("d", plan->missing[0].name);
+    EXPECT_EQ ("x", std::get<std::string> (plan->missing[0].value));
+    EXPECT_FALSE (plan->missing[0].null());
+    EXPECT_EQ ("e", plan->missing[1].name);
+    EXPECT_TRUE (plan->missing[1].null());
+
+    // planned once for each pair of versions
+    EXPECT_EQ (plan, evolution.plan (*wire));
+}
+
+/******************************************************************************/
+
+/**
+ * Properties are read in the order they're on the wire, so a target that
+ * only reorders them is no different from the version written
+ */
+TEST (Evolution, reordered) { // NOLINT
+    Evolution evolution;
+
+    target (evolution, version ("2", field ("b", "string"), field ("a", "int")));
+
+    EXPECT_EQ (nullptr, evolution.plan (*version ("1", field ("a", "int"), field ("b", "string"))));
+
+    // though dropping one as well still has to be planned for
+    auto plan = evolution.plan (*version ("3",
+        field ("a", "int"), field ("c", "long"), field ("b", "string")));
+
+    ASSERT_NE (nullptr, plan);
+    EXPECT_EQ ((std::vector<bool> { true, false, true }), plan->keep);
+    EXPECT_TRUE (plan->missing.empty());
+}
+
+/******************************************************************************/
+
+/**
+ * Defaults are held as what their type is written as, only a string's
+ * being a string
+ */
+TEST (Evolution, typedDefaults) { // NOLINT
+    Evolution evolution;
+
+    target (evolution, version ("2",
+        field ("a", "int", "0"),
+        field ("b", "boolean", "true"),
+        field ("c", "ulong", "7"),
+        field ("d", "double", "0.5"),
+        field ("e", "string", "0")));
+
+    auto plan = evolution.plan (*version ("1"));
+
+    ASSERT_NE (nullptr, plan);
+    ASSERT_EQ (5, plan->missing.size());
+    EXPECT_EQ ("int", plan->missing[0].type);
+    EXPECT_EQ (0, std::get<int64_t> (plan->missing[0].value));
+    EXPECT_TRUE (std::get<bool> (plan->missing[1].value));
+    EXPECT_EQ (7U, std::get<uint64_t> (plan->missing[2].value));
+    EXPECT_EQ (0.5, std::get<double> (plan->missing[3].value));
+    EXPECT_EQ ("0", std::get<std::string> (plan->missing[4].value));
+
+    // and a default that isn't one of its type can't be filled in
+    target (evolution, version ("3", field ("a", "int", "zero")));
+    EXPECT_ANY_THROW (evolution.plan (*version ("1"))); // NOLINT
+
+    target (evolution, version ("4", field ("a", "uint", "-1")));
+    EXPECT_ANY_THROW (evolution.plan (*version ("1"))); // NOLINT
+
+    target (evolution, version ("5", field ("a", "boolean", "1")));
+    EXPECT_ANY_THROW (evolution.plan (*version ("1"))); // NOLINT
+}
+
+/******************************************************************************/
+
+TEST (Evolution, impossible) { // NOLINT
+    Evolution evolution;
+
+    target (evolution, version ("2", field ("a", "long"), field ("b", "int", "", true)));
+
+    // a changed type
+    EXPECT_ANY_THROW (evolution.plan (*version ("1", field ("a", "int")))); // NOLINT
+
+    // a mandatory property with no default
+    EXPECT_ANY_THROW (evolution.plan (*version ("3", field ("a", "long")))); // NOLINT
+}
+
+/******************************************************************************/
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <limits>
+
+#include "amqp/writer/JsonWriter.h"
+
+/******************************************************************************/
+
+using amqp::internal::writer::JsonWriter;
+
+/******************************************************************************/
+
+TEST (JsonWriter, nesting) { // NOLINT
+    JsonWriter writer;
+
+    writer.beginObject();
+    writer.key ("a");
+    writer.integer (1);
+    writer.key ("b");
+    writer.beginArray();
+    writer.boolean (true);
+    writer.null();
+    writer.beginObject();
+    writer.endObject();
+    writer.beginArray();
+    writer.endArray();
+    writer.endArray();
+    writer.key ("c");
+    writer.string ("d");
+    writer.endObject();
+
+    EXPECT_EQ (R"({"a":1,"b":[true,null,{},[]],"c":"d"})", writer.str());
+}
+
+/******************************************************************************/
+
+TEST (JsonWriter, escaping) { // NOLINT
+    JsonWriter writer;
+
+    writer.string (std::string ("q\"b\\n\nt\tc\x01z\0", 12));
+
+    EXPECT_EQ (R"("q\"b\\n\nt\tc\u0001z\u0000")", writer.str());
+}
+
+/******************************************************************************/
+
+TEST (JsonWriter, doubles) { // NOLINT
+    JsonWriter writer;
+
+    writer.beginArray();
+    writer.floating (10.1);
+    writer.floating (0.1 + 0.2);
+    writer.floating (5.0);
+    writer.floating (1e300);
+    writer.floating (std::nan (""));
+    writer.floating (std::numeric_limits<double>::infinity());
+    writer.endArray();
+
+    EXPECT_EQ ("[10.1,0.30000000000000004,5,1e+300,null,null]", writer.str());
+}
+
+/******************************************************************************/
+
+/**
+ * Map keys come from readers so can be any scalar, they need quoting
+ */
+TEST (JsonWriter, scalarKeys) { // NOLINT
+    JsonWriter writer;
+
+    writer.beginObject();
+    writer.integer (-1);
+    writer.string ("a");
+    writer.unsignedInteger (2);
+    writer.floating (2.5);
+    writer.boolean (false);
+    writer.beginArray();
+    writer.endArray();
+    writer.endObject();
+
+    EXPECT_EQ (R"({"-1":"a","2":2.5,"false":[]})", writer.str());
+
+    JsonWriter bad;
+    bad.beginObject();
+    EXPECT_THROW (bad.beginObject(), std::runtime_error);
+    EXPECT_THROW (JsonWriter().key ("a"), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (JsonWriter, file) { // NOLINT
+    auto file = tmpfile();
+    ASSERT_NE (nullptr, file);
+
+    {
+        JsonWriter writer (file);
+
+        writer.beginArray();
+        for (int i { 0 } ; i < 100000 ; ++i) {
+            writer.string ("abcdefghij");
+        }
+        writer.endArray();
+
+        // big enough that some of it's already been written out
+        EXPECT_LT (writer.str().size(), 100000UL);
+    }
+
+    EXPECT_EQ (2 + 100000 * 13 - 1, ftell (file));
+
+    fclose (file);
+}
+
+/******************************************************************************/
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <vector>
+#include <string_view>
+
 #include "restricted-types/List.h"
 #include "restricted-types/Restricted.h"
 #include "TestUtils.h"
@@ -19,8 +22,14 @@ TEST (List, dependsOn1) {
     auto list1 = test::list ("string");
     auto list2 = test::list (list1->name());
 
-    ASSERT_EQ (1, list1->dependsOn (*list2));
-    ASSERT_EQ (2, list2->dependsOn (*list1));
+    std::vector<std::string_view> deps1;
+    std::vector<std::string_view> deps2;
+
+    list1->dependencies (deps1);
+    list2->dependencies (deps2);
+
+    ASSERT_EQ (std::vector<std::string_view> { "string" }, deps1);
+    ASSERT_EQ (std::vector<std::string_view> { list1->name() }, deps2);
 }
 
 /******************************************************************************/
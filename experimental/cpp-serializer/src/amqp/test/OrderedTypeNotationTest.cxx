@@ -16,31 +16,8 @@ namespace {
                 , m_dependsOn (std::move (dependsOn_))
             { }
 
-
-            int dependsOn (const OrderedTypeNotation & otn_) const override {
-                const auto & otn = dynamic_cast<const OTN &>(otn_);
-
-                // does the "left hand side" depend on us (in this case
-                // the lhs is us as we're not inverting
-                if (std::find (
-                        m_dependsOn.begin(),
-                        m_dependsOn.end(),
-                        otn.name()) != m_dependsOn.end())
-                {
-                    return 1;
-                }
-
-                // do we depend on the left hand side
-
-                if (std::find (
-                        otn.begin(),
-                        otn.end(),
-                        name()) != otn.end())
-                {
-                    return 2;
-                }
-
-                return 0;
+            void dependencies (std::vector<std::string_view> & deps_) const override {
+                deps_.insert (deps_.end(), m_dependsOn.begin(), m_dependsOn.end());
             }
 
             const std::string & name() const { return m_name; }
@@ -69,7 +46,7 @@ operator << (
         const amqp::internal::schema::OrderedTypeNotations<OTN> &otn_
 ) {
     auto first { true };
-    for (const auto & i : otn_.m_schemas) {
+    for (const auto & i : otn_) {
         for (const auto & j : i) {
             if (first) {
                 first = false;
@@ -114,10 +91,8 @@ TEST (OTNTest, twoInserts) { // NOLINT
     list.insert(std::make_unique<OTN>("A", std::vector<std::string>()));
     list.insert(std::make_unique<OTN>("B", std::vector<std::string>()));
 
-    // Inserting B after A with no dependencies between the two will force
-    // B to be recorded before A since elements added at the same
-    // level are always added to the front of the list to ensrue we can
-    // inspect the rest of that level
+    // With no dependencies between them A and B share a level, and within
+    // a level the most recently inserted comes first
     ASSERT_EQ ("B A", str (list));
 }
 
@@ -129,7 +104,7 @@ TEST (OTNTest, A_depends_on_B) { // NOLINT
     std::vector<std::string> aDeps = { "B" };
     list.insert(std::make_unique<OTN>("A", aDeps));
     list.insert(std::make_unique<OTN>("B", std::vector<std::string>()));
-    ASSERT_EQ("A B", str (list));
+    ASSERT_EQ("B A", str (list));
 }
 
 /******************************************************************************/
@@ -143,7 +118,7 @@ TEST (OTNTest, B_depends_on_A) { // NOLINT
     list.insert(std::make_unique<OTN>("A", aDeps));
     list.insert(std::make_unique<OTN>("B", bDeps));
 
-    ASSERT_EQ ("B A", str (list));
+    ASSERT_EQ ("A B", str (list));
 }
 
 /******************************************************************************/
@@ -159,7 +134,8 @@ TEST (OTNTest, three_1) { // NOLINT
     list.insert(std::make_unique<OTN>("B", bDeps));
     list.insert(std::make_unique<OTN>("C", cDeps));
 
-    ASSERT_EQ ("B C A", str (list));
+    // B and C share the second level, C in front as the more recent
+    ASSERT_EQ ("A C B", str (list));
 }
 
 /******************************************************************************/
@@ -175,7 +151,7 @@ TEST (OTNTest, three_2) { // NOLINT
     list.insert(std::make_unique<OTN>("B", bDeps));
     list.insert(std::make_unique<OTN>("C", cDeps));
 
-    EXPECT_EQ ("A B C", str (list));
+    EXPECT_EQ ("C B A", str (list));
 }
 
 /******************************************************************************/
@@ -191,7 +167,7 @@ TEST (OTNTest, three_3) { // NOLINT
     list.insert(std::make_unique<OTN>("A", aDeps));
     list.insert(std::make_unique<OTN>("B", bDeps));
 
-    EXPECT_EQ ("A B C", str (list));
+    EXPECT_EQ ("C B A", str (list));
 }
 
 /******************************************************************************/
@@ -207,7 +183,7 @@ TEST (OTNTest, three_4) { // NOLINT
     list.insert(std::make_unique<OTN>("B", bDeps));
     list.insert(std::make_unique<OTN>("A", aDeps));
 
-    EXPECT_EQ ("A B C", str (list));
+    EXPECT_EQ ("C B A", str (list));
 }
 
 /******************************************************************************/
@@ -223,7 +199,50 @@ TEST (OTNTest, three_5) { // NOLINT
     list.insert(std::make_unique<OTN>("C", cDeps));
     list.insert(std::make_unique<OTN>("A", aDeps));
 
-    EXPECT_EQ ("A B C", str (list));
+    EXPECT_EQ ("C B A", str (list));
+}
+
+/******************************************************************************/
+
+TEST (OTNTest, levels) { // NOLINT
+    amqp::internal::schema::OrderedTypeNotations<OTN> list;
+
+    // A diamond, D depending on B and C which both depend on A, with E
+    // depending on A alone
+    list.insert(std::make_unique<OTN>("A", std::vector<std::string> { }));
+    list.insert(std::make_unique<OTN>("D", std::vector<std::string> { "B", "C" }));
+    list.insert(std::make_unique<OTN>("B", std::vector<std::string> { "A" }));
+    list.insert(std::make_unique<OTN>("C", std::vector<std::string> { "A", "int" }));
+    list.insert(std::make_unique<OTN>("E", std::vector<std::string> { "A" }));
+
+    std::vector<std::string> levels;
+    for (const auto & level : list) {
+        std::string names;
+        for (const auto & type : level) {
+            names += type->name();
+        }
+        levels.push_back (names);
+    }
+
+    ASSERT_EQ ((std::vector<std::string> { "A", "ECB", "D" }), levels);
+
+    // adding to an ordered list orders it again
+    list.insert(std::make_unique<OTN>("F", std::vector<std::string> { "D" }));
+    ASSERT_EQ ("A E C B D F", str (list));
+}
+
+/******************************************************************************/
+
+TEST (OTNTest, cycle) { // NOLINT
+    amqp::internal::schema::OrderedTypeNotations<OTN> list;
+
+    list.insert(std::make_unique<OTN>("B", std::vector<std::string> { "C", "A" }));
+    list.insert(std::make_unique<OTN>("C", std::vector<std::string> { "B" }));
+    list.insert(std::make_unique<OTN>("A", std::vector<std::string> { "A" }));
+
+    // A referring to itself doesn't matter but B and C can't both come
+    // after each other, whichever comes first A still comes before B
+    ASSERT_EQ ("A C B", str (list));
 }
 
 /******************************************************************************/
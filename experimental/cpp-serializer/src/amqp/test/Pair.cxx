@@ -59,3 +59,19 @@ TEST (Pair, UP2) { // NOLINT
 
 /******************************************************************************/
 
+
+/**
+ * A reference dumps as the value it refers to under its own property,
+ * whatever property, if any, the original was read with
+ */
+TEST (Pair, reference) { // NOLINT
+    TypedPair<std::string> original ("first", "Hello");
+    TypedSingle<std::string> single ("World");
+
+    EXPECT_EQ ("second : Hello", PairReference ("second", original).dump());
+    EXPECT_EQ ("Hello", SingleReference (original).dump());
+    EXPECT_EQ ("third : World", PairReference ("third", single).dump());
+    EXPECT_EQ ("World", SingleReference (single).dump());
+}
+
+/******************************************************************************/
@@ -0,0 +1,368 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <proton/codec.h>
+
+#include "TestUtils.h"
+#include "Program.h"
+#include "Projection.h"
+#include "writer/JsonWriter.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::reader;
+using Op = Program::Op;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * [value_] described by the symbol [descriptor_]
+     */
+    std::vector<char>
+    described (const std::string & descriptor_, std::vector<char> value_) {
+        std::vector<char> rtn { 0x00, (char)0xa3, (char)descriptor_.size() };
+        rtn.insert (rtn.end(), descriptor_.begin(), descriptor_.end());
+        rtn.insert (rtn.end(), value_.begin(), value_.end());
+
+        return rtn;
+    }
+
+    std::string
+    run (const Program & program_, uint32_t entry_, const std::vector<char> & blob_) {
+        auto data = pn_data (0);
+        pn_data_decode (data, blob_.data(), blob_.size());
+
+        amqp::internal::writer::JsonWriter writer;
+        program_.run (entry_, data, writer);
+
+        pn_data_free (data);
+
+        return writer.take();
+    }
+
+    std::string
+    run (const Program & program_, const std::string & descriptor_, const std::vector<char> & blob_) {
+        return run (program_, program_.entry (descriptor_), blob_);
+    }
+
+    amqp::Error
+    error (const Program & program_, const std::string & descriptor_, const std::vector<char> & blob_) {
+        auto data = pn_data (0);
+        pn_data_decode (data, blob_.data(), blob_.size());
+
+        amqp::internal::writer::JsonWriter writer;
+        auto rtn = program_.tryRun (program_.entry (descriptor_), data, writer);
+
+        pn_data_free (data);
+
+        return rtn.error();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Program, listOfInts) { // NOLINT
+    auto list = test::list ("int");
+
+    Program program;
+    program.compile (*list);
+
+    std::vector<Op> expected {
+        Op::EnterDescribed, Op::Next, Op::ReadInts, Op::EnterList,
+        Op::BeginArray, Op::Loop, Op::ReadInt, Op::Jump,
+        Op::EndArray, Op::Exit, Op::Exit, Op::Next, Op::Return
+    };
+
+    ASSERT_EQ (expected.size(), program.code().size());
+
+    for (size_t i { 0 } ; i < expected.size() ; ++i) {
+        EXPECT_EQ (expected[i], program.code()[i].op) << i;
+    }
+
+    // reading them all at once goes straight to leaving the described
+    // type, failing that the loop exits past the jump back to it
+    EXPECT_EQ (10U, program.code()[2].arg);
+    EXPECT_EQ (8U, program.code()[5].arg);
+    EXPECT_EQ (5U, program.code()[7].arg);
+
+    auto blob = described (list->descriptor(), {
+        (char)0xc0, 0x05, 0x02, 0x54, 0x01, 0x54, 0x02 });
+
+    EXPECT_EQ ("[1,2]", run (program, list->descriptor(), blob));
+
+    auto empty = described (list->descriptor(), { (char)0xc0, 0x01, 0x00 });
+
+    EXPECT_EQ ("[]", run (program, list->descriptor(), empty));
+}
+
+/******************************************************************************/
+
+/**
+ * Non primitive types are called rather than inlined
+ */
+TEST (Program, mapOfLists) { // NOLINT
+    auto list = test::list ("string");
+    auto map = test::map ("int", list->name());
+
+    Program program;
+    program.compile (*list);
+    program.compile (*map);
+
+    auto call = std::find_if (
+        program.code().begin(), program.code().end(),
+        [](const auto & i_) { return i_.op == Op::Call; });
+
+    ASSERT_NE (program.code().end(), call);
+    EXPECT_EQ (program.entry (list->descriptor()), call->arg);
+
+    auto blob = described (map->descriptor(), {
+        (char)0xc1, 0x00, 0x02,
+            0x54, 0x07 });
+
+    auto inner = described (list->descriptor(), {
+        (char)0xc0, 0x04, 0x01, (char)0xa1, 0x01, 'x' });
+
+    blob.insert (blob.end(), inner.begin(), inner.end());
+
+    // patch up the size of the map now we know it
+    blob[blob[2] + 4] = blob.size() - (blob[2] + 5);
+
+    EXPECT_EQ (R"({"7":["x"]})", run (program, map->descriptor(), blob));
+}
+
+/******************************************************************************/
+
+/**
+ * A reference back to the first element, described by REFERENCED_OBJECT
+ * with the index as a smalluint
+ */
+const std::vector<char> reference { // NOLINT
+    0x00, (char)0x80, (char)0xc5, 0x62, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+    0x52, 0x00 };
+
+/******************************************************************************/
+
+/**
+ * Strings in a collection can be referred to, and be references
+ */
+TEST (Program, referencedString) { // NOLINT
+    auto list = test::list ("string");
+
+    Program program;
+    program.compile (*list);
+
+    std::vector<char> elements { (char)0xa1, 0x01, 'x' };
+    elements.insert (elements.end(), reference.begin(), reference.end());
+
+    std::vector<char> value { (char)0xc0, (char)(elements.size() + 1), 0x02 };
+    value.insert (value.end(), elements.begin(), elements.end());
+
+    EXPECT_EQ (R"(["x","x"])",
+        run (program, list->descriptor(), described (list->descriptor(), value)));
+
+    // an index as a ulong too wide for a uint doesn't wrap round to 0
+    std::vector<char> wide (reference.begin(), reference.end() - 2);
+    wide.insert (wide.end(), { (char)0x80, 0, 0, 0, 0x01, 0, 0, 0, 0 });
+
+    elements = { (char)0xa1, 0x01, 'x' };
+    elements.insert (elements.end(), wide.begin(), wide.end());
+
+    value = { (char)0xc0, (char)(elements.size() + 1), 0x02 };
+    value.insert (value.end(), elements.begin(), elements.end());
+
+    EXPECT_THROW ( // NOLINT
+        run (program, list->descriptor(), described (list->descriptor(), value)),
+        std::runtime_error);
+
+    EXPECT_EQ (amqp::Errc::Malformed,
+        error (program, list->descriptor(), described (list->descriptor(), value)).code);
+}
+
+/******************************************************************************/
+
+/**
+ * Referring to a list writes it again, references within it included
+ */
+namespace {
+
+    /**
+     * A list of two lists of strings, the second a reference to the first
+     * which, the string in it being object 0, is object 1
+     */
+    std::vector<char>
+    listOfLists (const std::string & outer_, const std::string & inner_) {
+        auto first = described (inner_, {
+            (char)0xc0, 0x04, 0x01, (char)0xa1, 0x01, 'x' });
+
+        std::vector<char> elements (first.begin(), first.end());
+        elements.insert (elements.end(), reference.begin(), reference.end());
+        elements.back() = 0x01;
+
+        std::vector<char> value { (char)0xc0, (char)(elements.size() + 1), 0x02 };
+        value.insert (value.end(), elements.begin(), elements.end());
+
+        return described (outer_, value);
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Program, referencedList) { // NOLINT
+    auto inner = test::list ("string");
+    auto outer = test::list (inner->name());
+
+    Program program;
+    program.compile (*inner);
+    program.compile (*outer);
+
+    EXPECT_EQ (R"([["x"],["x"]])",
+        run (program, outer->descriptor(),
+             listOfLists (outer->descriptor(), inner->descriptor())));
+
+    // and nothing's been written yet to refer to
+    std::vector<char> dangling { (char)0xc0, (char)(reference.size() + 1), 0x01 };
+    dangling.insert (dangling.end(), reference.begin(), reference.end());
+
+    EXPECT_THROW (
+        run (program, outer->descriptor(), described (outer->descriptor(), dangling)),
+        std::runtime_error);
+}
+
+/******************************************************************************/
+
+/**
+ * Pruned to one element the other is skipped, unless the one selected
+ * refers to it in which case it has to be read after all
+ */
+TEST (Program, projectList) { // NOLINT
+    using amqp::internal::reader::Projection;
+
+    auto inner = test::list ("string");
+    auto outer = test::list (inner->name());
+
+    Program program;
+    program.compile (*inner);
+    program.compile (*outer);
+
+    auto blob = listOfLists (outer->descriptor(), inner->descriptor());
+
+    auto first = program.project (outer->descriptor(), Projection::parse ("[0]"));
+
+    EXPECT_NE (program.entry (outer->descriptor()), first);
+    EXPECT_TRUE (std::any_of (
+        program.code().begin() + first, program.code().end(),
+        [](const auto & i_) { return i_.op == Op::SkipElement; }));
+
+    EXPECT_EQ (R"([["x"]])", run (program, first, blob));
+
+    auto second = program.project (outer->descriptor(), Projection::parse ("[1]"));
+    EXPECT_EQ (R"([["x"]])", run (program, second, blob));
+
+    auto neither = program.project (outer->descriptor(), Projection::parse ("[2]"));
+    EXPECT_EQ ("[]", run (program, neither, blob));
+
+    // and pruning leaves the rest of the program alone
+    EXPECT_EQ (R"([["x"],["x"]])", run (program, outer->descriptor(), blob));
+
+    EXPECT_THROW (
+        program.project (outer->descriptor(), Projection::parse ("x")),
+        std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (Program, projectMap) { // NOLINT
+    using amqp::internal::reader::Projection;
+
+    auto list = test::list ("string");
+    auto map = test::map ("int", list->name());
+
+    Program program;
+    program.compile (*list);
+    program.compile (*map);
+
+    auto blob = described (map->descriptor(), {
+        (char)0xc1, 0x00, 0x04,
+            0x54, 0x07 });
+
+    auto inner = described (list->descriptor(), {
+        (char)0xc0, 0x04, 0x01, (char)0xa1, 0x01, 'x' });
+
+    blob.insert (blob.end(), inner.begin(), inner.end());
+    blob.push_back (0x54);
+    blob.push_back (0x08);
+    blob.insert (blob.end(), reference.begin(), reference.end());
+    blob.back() = 0x01;
+
+    blob[blob[2] + 4] = blob.size() - (blob[2] + 5);
+
+    EXPECT_EQ (R"({"7":["x"],"8":["x"]})", run (program, map->descriptor(), blob));
+
+    EXPECT_EQ (R"({"7":["x"]})",
+        run (program, program.project (map->descriptor(), Projection::parse ("7")), blob));
+
+    EXPECT_EQ (R"({"8":["x"]})",
+        run (program, program.project (map->descriptor(), Projection::parse ("8")), blob));
+
+    EXPECT_EQ (R"({"8":[]})",
+        run (program, program.project (map->descriptor(), Projection::parse ("8[1]")), blob));
+}
+
+/******************************************************************************/
+
+TEST (Program, missingType) { // NOLINT
+    auto list = test::list ("net.corda.NotCompiledYet");
+
+    Program program;
+    EXPECT_THROW (program.compile (*list), std::runtime_error);
+    EXPECT_THROW (program.entry (list->descriptor()), std::runtime_error);
+}
+
+/******************************************************************************/
+
+/**
+ * A blob that isn't what the program expects is an error rather than an
+ * exception, only [Program::run] throws
+ */
+TEST (Program, errors) { // NOLINT
+    auto list = test::list ("string");
+
+    Program program;
+    program.compile (*list);
+
+    std::vector<char> value { (char)0xc0, 0x05, 0x02, (char)0xa1, 0x01, 'x', 0x40 };
+    auto blob = described (list->descriptor(), value);
+
+    EXPECT_FALSE (error (program, list->descriptor(), described (list->descriptor(), {
+        (char)0xc0, 0x04, 0x01, (char)0xa1, 0x01, 'x' })));
+
+    auto e = error (program, list->descriptor(), blob);
+
+    EXPECT_EQ (amqp::Errc::UnexpectedType, e.code);
+#ifdef AMQP_CODEC_NATIVE
+    // the null is the last byte
+    EXPECT_EQ (blob.size() - 1, e.offset);
+#endif
+
+    EXPECT_THROW (run (program, list->descriptor(), blob), amqp::Failure);
+
+    // not a list at all
+    EXPECT_EQ (amqp::Errc::UnexpectedType,
+        error (program, list->descriptor(), described (list->descriptor(), { 0x40 })).code);
+
+    // and a reference to nothing
+    std::vector<char> dangling { (char)0xc0, (char)(reference.size() + 1), 0x01 };
+    dangling.insert (dangling.end(), reference.begin(), reference.end());
+
+    EXPECT_EQ (amqp::Errc::UnknownReference,
+        error (program, list->descriptor(), described (list->descriptor(), dangling)).code);
+}
+
+/******************************************************************************/
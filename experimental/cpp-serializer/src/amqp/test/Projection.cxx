@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <stdexcept>
+
+#include "Projection.h"
+
+/******************************************************************************/
+
+using amqp::internal::reader::Projection;
+
+/******************************************************************************/
+
+TEST (Projection, all) { // NOLINT
+    Projection projection;
+
+    EXPECT_TRUE (projection.all());
+    EXPECT_TRUE (projection.children().empty());
+    EXPECT_EQ ("", projection.str());
+}
+
+/******************************************************************************/
+
+TEST (Projection, dotted) { // NOLINT
+    auto projection = Projection::parse ("state.data.amount,outputs[3].x");
+
+    EXPECT_FALSE (projection.all());
+    EXPECT_EQ ("/outputs/3/x,/state/data/amount", projection.str());
+
+    auto state = projection.child ("state");
+    ASSERT_NE (nullptr, state);
+    EXPECT_FALSE (state->all());
+    EXPECT_EQ (nullptr, state->child ("outputs"));
+
+    auto amount = state->child ("data")->child ("amount");
+    ASSERT_NE (nullptr, amount);
+    EXPECT_TRUE (amount->all());
+
+    EXPECT_EQ ("/a/0/1", Projection::parse ("a[0][1]").str());
+}
+
+/******************************************************************************/
+
+TEST (Projection, pointer) { // NOLINT
+    EXPECT_EQ (
+        Projection::parse ("state.data.amount,outputs[3].x").str(),
+        Projection::parse ("/state/data/amount,/outputs/3/x").str());
+
+    // ~1 is a / and ~0 a ~, which is how they come back out
+    auto projection = Projection::parse ("/a~1b/c~0d");
+
+    ASSERT_NE (nullptr, projection.child ("a/b"));
+    ASSERT_NE (nullptr, projection.child ("a/b")->child ("c~d"));
+    EXPECT_EQ ("/a~1b/c~0d", projection.str());
+}
+
+/******************************************************************************/
+
+/**
+ * Selecting something selects everything beneath it
+ */
+TEST (Projection, overlapping) { // NOLINT
+    EXPECT_EQ ("/a", Projection::parse ("a.b,a").str());
+    EXPECT_EQ ("/a", Projection::parse ("a,a.b").str());
+    EXPECT_EQ ("/a/b,/a/c", Projection::parse ("a.c,a.b,a.b").str());
+}
+
+/******************************************************************************/
+
+TEST (Projection, bad) { // NOLINT
+    EXPECT_THROW (Projection::parse (""), std::runtime_error);
+    EXPECT_THROW (Projection::parse ("a,"), std::runtime_error);
+    EXPECT_THROW (Projection::parse ("a..b"), std::runtime_error);
+    EXPECT_THROW (Projection::parse ("a."), std::runtime_error);
+    EXPECT_THROW (Projection::parse ("a[]"), std::runtime_error);
+    EXPECT_THROW (Projection::parse ("a[1"), std::runtime_error);
+    EXPECT_THROW (Projection::parse ("/a~2"), std::runtime_error);
+}
+
+/******************************************************************************/
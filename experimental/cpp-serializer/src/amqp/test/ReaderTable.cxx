@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ReaderTable.h"
+#include "PropertyReader.h"
+#include "restricted-readers/ListReader.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::reader;
+
+/******************************************************************************/
+
+TEST (ReaderTable, indices) { // NOLINT
+    ReaderTable table;
+    std::vector<const Reader *> readers;
+
+    // enough to outgrow both the first block and the first index
+    for (size_t i { 0 } ; i < 4096 ; ++i) {
+        auto index = PropertyReader::make (table, i % 2 ? "int" : "string");
+
+        EXPECT_EQ (i, index);
+        readers.push_back (&table[index]);
+    }
+
+    EXPECT_EQ (4096, table.size());
+
+    for (size_t i { 0 } ; i < readers.size() ; ++i) {
+        EXPECT_EQ (readers[i], &table[i]);
+        EXPECT_EQ (i % 2 ? "int" : "string", table[i].type());
+    }
+}
+
+/******************************************************************************/
+
+TEST (ReaderTable, refs) { // NOLINT
+    ReaderTable table;
+
+    auto ints = PropertyReader::make (table, "int");
+    auto list = table.emplace<ListReader> ("list<int>", table.ref (ints));
+
+    EXPECT_EQ ("list<int>", table[list].type());
+
+    auto ref = table.ref (ints);
+
+    for (int i { 0 } ; i < 100 ; ++i) {
+        PropertyReader::make (table, "long");
+    }
+
+    EXPECT_EQ (ints, ref.index());
+    EXPECT_EQ (&table[ints], &*ref);
+    EXPECT_EQ ("int", ref->type());
+}
+
+/******************************************************************************/
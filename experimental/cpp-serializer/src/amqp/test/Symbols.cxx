@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Symbols.h"
+
+/******************************************************************************/
+
+using amqp::internal::Symbols;
+
+/******************************************************************************/
+
+TEST (Symbols, intern) { // NOLINT
+    auto a = Symbols::intern ("net.corda:symbols/a");
+    auto b = Symbols::intern ("net.corda:symbols/b");
+
+    EXPECT_NE (a, b);
+    EXPECT_EQ (a, Symbols::intern ("net.corda:symbols/a"));
+    EXPECT_EQ ("net.corda:symbols/a", Symbols::name (a));
+    EXPECT_EQ ("net.corda:symbols/b", Symbols::name (b));
+}
+
+/******************************************************************************/
+
+TEST (Symbols, find) { // NOLINT
+    EXPECT_EQ (Symbols::unknown, Symbols::find ("net.corda:symbols/c"));
+
+    auto c = Symbols::intern ("net.corda:symbols/c");
+
+    EXPECT_EQ (c, Symbols::find ("net.corda:symbols/c"));
+
+    // straight from the bytes of a symbol, which needn't be terminated
+    std::string bytes { "net.corda:symbols/cd" };
+    EXPECT_EQ (c, Symbols::find (pn_bytes_t { bytes.size() - 1, bytes.data() }));
+
+    EXPECT_THROW (Symbols::name (Symbols::unknown), std::runtime_error); // NOLINT
+}
+
+/******************************************************************************/
+
+/**
+ * Threads interning the same symbols at once all agree on their ids
+ */
+TEST (Symbols, threads) { // NOLINT
+    constexpr int threads { 4 };
+    constexpr int symbols { 1000 };
+
+    std::vector<std::vector<Symbols::id_t>> ids (threads);
+    std::vector<std::thread> workers;
+
+    for (int t { 0 } ; t < threads ; ++t) {
+        workers.emplace_back ([t, &ids] {
+            for (int i { 0 } ; i < symbols ; ++i) {
+                ids[t].push_back (Symbols::intern (
+                    "net.corda:threads/" + std::to_string ((i * (t + 1)) % symbols)));
+            }
+        });
+    }
+
+    for (auto & worker : workers) {
+        worker.join();
+    }
+
+    for (int t { 0 } ; t < threads ; ++t) {
+        for (int i { 0 } ; i < symbols ; ++i) {
+            auto name = "net.corda:threads/" + std::to_string ((i * (t + 1)) % symbols);
+
+            ASSERT_EQ (name, Symbols::name (ids[t][i]));
+            ASSERT_EQ (ids[t][i], Symbols::find (name));
+        }
+    }
+}
+
+/******************************************************************************/
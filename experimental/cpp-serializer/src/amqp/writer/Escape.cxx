@@ -0,0 +1,499 @@
+#include "Escape.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if (defined (__x86_64__) || defined (__i386__)) && (defined (__GNUC__) || defined (__clang__))
+#define AMQP_ESCAPE_X86
+#include <immintrin.h>
+#endif
+
+/******************************************************************************
+ *
+ * Validating UTF-8 a block at a time is Keiser and Lemire's "Validating
+ * UTF-8 In Less Than One Instruction Per Byte". Every error in a sequence
+ * shows up in its first two bytes, or as a continuation byte missing two
+ * or three bytes after a lead, so with each byte and the one before it
+ * looked up in three tables of the errors they could be part of, ANDing
+ * the three leaves the errors they are part of.
+ *
+ ******************************************************************************/
+
+namespace {
+
+    constexpr uint8_t tooShort  = 1 << 0; // 11______ 0_______, 11______ 11______
+    constexpr uint8_t tooLong   = 1 << 1; // 0_______ 10______
+    constexpr uint8_t overlong3 = 1 << 2; // 11100000 100_____
+    constexpr uint8_t tooLarge  = 1 << 3; // 11110100 1001____, 11110101+ 10______
+    constexpr uint8_t surrogate = 1 << 4; // 11101101 101_____
+    constexpr uint8_t overlong2 = 1 << 5; // 1100000_ 10______
+    constexpr uint8_t large1000 = 1 << 6; // 11110101+ 1000____
+    constexpr uint8_t overlong4 = 1 << 6; // 11110000 1000____
+    constexpr uint8_t twoConts  = 1 << 7; // 10______ 10______
+
+    constexpr uint8_t carry = tooShort | tooLong | twoConts;
+
+    /*
+     * By the high nibble of the first byte
+     */
+    alignas (16) constexpr uint8_t byte1High[16] = {
+        tooLong, tooLong, tooLong, tooLong,
+        tooLong, tooLong, tooLong, tooLong,
+        twoConts, twoConts, twoConts, twoConts,
+        tooShort | overlong2,
+        tooShort,
+        tooShort | overlong3 | surrogate,
+        tooShort | tooLarge | large1000 | overlong4
+    };
+
+    /*
+     * By the low nibble of the first byte
+     */
+    alignas (16) constexpr uint8_t byte1Low[16] = {
+        carry | overlong3 | overlong2 | overlong4,
+        carry | overlong2,
+        carry,
+        carry,
+        carry | tooLarge,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000 | surrogate,
+        carry | tooLarge | large1000,
+        carry | tooLarge | large1000
+    };
+
+    /*
+     * By the high nibble of the second byte
+     */
+    alignas (16) constexpr uint8_t byte2High[16] = {
+        tooShort, tooShort, tooShort, tooShort,
+        tooShort, tooShort, tooShort, tooShort,
+        tooLong | overlong2 | twoConts | overlong3 | large1000 | overlong4,
+        tooLong | overlong2 | twoConts | overlong3 | tooLarge,
+        tooLong | overlong2 | twoConts | surrogate | tooLarge,
+        tooLong | overlong2 | twoConts | surrogate | tooLarge,
+        tooShort, tooShort, tooShort, tooShort
+    };
+
+    inline bool
+    needsEscape (unsigned char c_) {
+        return c_ < 0x20 || c_ == '"' || c_ == '\\';
+    }
+
+}
+
+/******************************************************************************
+ *
+ * A byte at a time
+ *
+ ******************************************************************************/
+
+namespace {
+
+    bool
+    validScalar (const char * begin_, size_t size_) {
+        auto end = begin_ + size_;
+
+        while (begin_ != end) {
+            if (static_cast<unsigned char>(*begin_) < 0x80) {
+                ++begin_;
+            } else if (auto n = amqp::internal::writer::sequence (begin_, end)) {
+                begin_ += n;
+            } else {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    const char *
+    plainScalar (const char * begin_, const char * end_, bool utf8_) {
+        for ( ; begin_ != end_ ; ++begin_) {
+            auto c = static_cast<unsigned char>(*begin_);
+
+            if (needsEscape (c) || (!utf8_ && c >= 0x80)) {
+                break;
+            }
+        }
+
+        return begin_;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * SSE4.2, 16 bytes at a time
+ *
+ ******************************************************************************/
+
+#ifdef AMQP_ESCAPE_X86
+
+#define TARGET_SSE42 __attribute__ ((target ("sse4.2")))
+
+namespace {
+
+    TARGET_SSE42 inline __m128i
+    table (const uint8_t * table_) {
+        return _mm_load_si128 (reinterpret_cast<const __m128i *>(table_));
+    }
+
+    TARGET_SSE42 inline __m128i
+    high (__m128i bytes_) {
+        return _mm_and_si128 (_mm_srli_epi16 (bytes_, 4), _mm_set1_epi8 (0x0f));
+    }
+
+    /**
+     * The errors in [input_], [previous_] being the block before it
+     */
+    TARGET_SSE42 inline __m128i
+    errors (__m128i input_, __m128i previous_) {
+        auto prev1 = _mm_alignr_epi8 (input_, previous_, 15);
+        auto prev2 = _mm_alignr_epi8 (input_, previous_, 14);
+        auto prev3 = _mm_alignr_epi8 (input_, previous_, 13);
+
+        auto special = _mm_and_si128 (
+            _mm_and_si128 (
+                _mm_shuffle_epi8 (table (byte1High), high (prev1)),
+                _mm_shuffle_epi8 (table (byte1Low),
+                        _mm_and_si128 (prev1, _mm_set1_epi8 (0x0f)))),
+            _mm_shuffle_epi8 (table (byte2High), high (input_)));
+
+        // a third or fourth byte has to be a continuation, only 111_____
+        // and 1111____ two and three back are left with their top bit set
+        auto third = _mm_subs_epu8 (prev2, _mm_set1_epi8 (char (0xe0 - 0x80)));
+        auto fourth = _mm_subs_epu8 (prev3, _mm_set1_epi8 (char (0xf0 - 0x80)));
+
+        auto mustContinue = _mm_and_si128 (
+                _mm_or_si128 (third, fourth), _mm_set1_epi8 (char (0x80)));
+
+        return _mm_xor_si128 (mustContinue, special);
+    }
+
+    /**
+     * The tail is padded with zeros, which being ASCII show up any sequence
+     * left incomplete at the end
+     */
+    TARGET_SSE42 bool
+    validSSE42 (const char * begin_, size_t size_) {
+        auto previous = _mm_setzero_si128();
+        auto error = _mm_setzero_si128();
+
+        size_t i { 0 };
+
+        for ( ; i + 16 <= size_ ; i += 16) {
+            auto input = _mm_loadu_si128 (
+                    reinterpret_cast<const __m128i *>(begin_ + i));
+
+            // nothing can be wrong with ASCII following ASCII
+            if (_mm_movemask_epi8 (_mm_or_si128 (input, previous))) {
+                error = _mm_or_si128 (error, errors (input, previous));
+            }
+
+            previous = input;
+        }
+
+        alignas (16) char tail[16] { };
+
+        if (size_ > i) {
+            memcpy (tail, begin_ + i, size_ - i);
+        }
+
+        error = _mm_or_si128 (error, errors (
+                _mm_load_si128 (reinterpret_cast<const __m128i *>(tail)),
+                previous));
+
+        return _mm_testz_si128 (error, error);
+    }
+
+    TARGET_SSE42 const char *
+    plainSSE42 (const char * begin_, const char * end_, bool utf8_) {
+        auto quote = _mm_set1_epi8 ('"');
+        auto backslash = _mm_set1_epi8 ('\\');
+        auto control = _mm_set1_epi8 (0x1f);
+
+        while (end_ - begin_ >= 16) {
+            auto input = _mm_loadu_si128 (reinterpret_cast<const __m128i *>(begin_));
+
+            auto special = _mm_or_si128 (
+                _mm_or_si128 (
+                    _mm_cmpeq_epi8 (input, quote),
+                    _mm_cmpeq_epi8 (input, backslash)),
+                _mm_cmpeq_epi8 (_mm_min_epu8 (input, control), input));
+
+            auto mask = static_cast<unsigned> (_mm_movemask_epi8 (special));
+
+            if (!utf8_) {
+                mask |= static_cast<unsigned> (_mm_movemask_epi8 (input));
+            }
+
+            if (mask) {
+                return begin_ + __builtin_ctz (mask);
+            }
+
+            begin_ += 16;
+        }
+
+        return plainScalar (begin_, end_, utf8_);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * AVX2, 32 bytes at a time
+ *
+ ******************************************************************************/
+
+#define TARGET_AVX2 __attribute__ ((target ("avx2")))
+
+namespace {
+
+    TARGET_AVX2 inline __m256i
+    table256 (const uint8_t * table_) {
+        return _mm256_broadcastsi128_si256 (
+                _mm_load_si128 (reinterpret_cast<const __m128i *>(table_)));
+    }
+
+    TARGET_AVX2 inline __m256i
+    high (__m256i bytes_) {
+        return _mm256_and_si256 (_mm256_srli_epi16 (bytes_, 4), _mm256_set1_epi8 (0x0f));
+    }
+
+    /**
+     * As the SSE4.2 version but the shuffles work on each 128 bit lane on
+     * its own, so the bytes before the start of the high lane come from
+     * the low one
+     */
+    TARGET_AVX2 inline __m256i
+    errors (__m256i input_, __m256i previous_) {
+        auto straddle = _mm256_permute2x128_si256 (previous_, input_, 0x21);
+
+        auto prev1 = _mm256_alignr_epi8 (input_, straddle, 15);
+        auto prev2 = _mm256_alignr_epi8 (input_, straddle, 14);
+        auto prev3 = _mm256_alignr_epi8 (input_, straddle, 13);
+
+        auto special = _mm256_and_si256 (
+            _mm256_and_si256 (
+                _mm256_shuffle_epi8 (table256 (byte1High), high (prev1)),
+                _mm256_shuffle_epi8 (table256 (byte1Low),
+                        _mm256_and_si256 (prev1, _mm256_set1_epi8 (0x0f)))),
+            _mm256_shuffle_epi8 (table256 (byte2High), high (input_)));
+
+        auto third = _mm256_subs_epu8 (prev2, _mm256_set1_epi8 (char (0xe0 - 0x80)));
+        auto fourth = _mm256_subs_epu8 (prev3, _mm256_set1_epi8 (char (0xf0 - 0x80)));
+
+        auto mustContinue = _mm256_and_si256 (
+                _mm256_or_si256 (third, fourth), _mm256_set1_epi8 (char (0x80)));
+
+        return _mm256_xor_si256 (mustContinue, special);
+    }
+
+    TARGET_AVX2 bool
+    validAVX2 (const char * begin_, size_t size_) {
+        auto previous = _mm256_setzero_si256();
+        auto error = _mm256_setzero_si256();
+
+        size_t i { 0 };
+
+        for ( ; i + 32 <= size_ ; i += 32) {
+            auto input = _mm256_loadu_si256 (
+                    reinterpret_cast<const __m256i *>(begin_ + i));
+
+            if (_mm256_movemask_epi8 (_mm256_or_si256 (input, previous))) {
+                error = _mm256_or_si256 (error, errors (input, previous));
+            }
+
+            previous = input;
+        }
+
+        alignas (32) char tail[32] { };
+
+        if (size_ > i) {
+            memcpy (tail, begin_ + i, size_ - i);
+        }
+
+        error = _mm256_or_si256 (error, errors (
+                _mm256_load_si256 (reinterpret_cast<const __m256i *>(tail)),
+                previous));
+
+        return _mm256_testz_si256 (error, error);
+    }
+
+    TARGET_AVX2 const char *
+    plainAVX2 (const char * begin_, const char * end_, bool utf8_) {
+        auto quote = _mm256_set1_epi8 ('"');
+        auto backslash = _mm256_set1_epi8 ('\\');
+        auto control = _mm256_set1_epi8 (0x1f);
+
+        while (end_ - begin_ >= 32) {
+            auto input = _mm256_loadu_si256 (reinterpret_cast<const __m256i *>(begin_));
+
+            auto special = _mm256_or_si256 (
+                _mm256_or_si256 (
+                    _mm256_cmpeq_epi8 (input, quote),
+                    _mm256_cmpeq_epi8 (input, backslash)),
+                _mm256_cmpeq_epi8 (_mm256_min_epu8 (input, control), input));
+
+            auto mask = static_cast<unsigned> (_mm256_movemask_epi8 (special));
+
+            if (!utf8_) {
+                mask |= static_cast<unsigned> (_mm256_movemask_epi8 (input));
+            }
+
+            if (mask) {
+                return begin_ + __builtin_ctz (mask);
+            }
+
+            begin_ += 32;
+        }
+
+        return plainSSE42 (begin_, end_, utf8_);
+    }
+
+}
+
+#endif
+
+/******************************************************************************
+ *
+ * Picking which to use
+ *
+ ******************************************************************************/
+
+namespace {
+
+    using amqp::internal::writer::Kernel;
+
+    struct Kernels {
+        Kernel kernel;
+        bool (* valid)(const char *, size_t);
+        const char * (* plain)(const char *, const char *, bool);
+    };
+
+    constexpr Kernels scalar { Kernel::Scalar, &validScalar, &plainScalar };
+
+#ifdef AMQP_ESCAPE_X86
+    constexpr Kernels sse42 { Kernel::SSE42, &validSSE42, &plainSSE42 };
+    constexpr Kernels avx2 { Kernel::AVX2, &validAVX2, &plainAVX2 };
+#endif
+
+    const Kernels *
+    best (Kernel most_) {
+#ifdef AMQP_ESCAPE_X86
+        __builtin_cpu_init();
+
+        if (most_ >= Kernel::AVX2 && __builtin_cpu_supports ("avx2")) {
+            return &avx2;
+        }
+
+        if (most_ >= Kernel::SSE42 && __builtin_cpu_supports ("sse4.2")) {
+            return &sse42;
+        }
+#endif
+        return &scalar;
+    }
+
+    std::atomic<const Kernels *> &
+    kernels() {
+        static std::atomic<const Kernels *> rtn { best (Kernel::AVX2) };
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************
+ *
+ *
+ *
+ ******************************************************************************/
+
+amqp::internal::writer::Kernel
+amqp::internal::writer::
+kernel() {
+    return kernels().load (std::memory_order_relaxed)->kernel;
+}
+
+/******************************************************************************/
+
+amqp::internal::writer::Kernel
+amqp::internal::writer::
+use (Kernel kernel_) {
+    kernels().store (best (kernel_), std::memory_order_relaxed);
+
+    return kernel();
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::writer::
+validUtf8 (std::string_view str_) {
+    return kernels().load (std::memory_order_relaxed)->valid (
+            str_.data(), str_.size());
+}
+
+/******************************************************************************/
+
+const char *
+amqp::internal::writer::
+plain (const char * begin_, const char * end_, bool utf8_) {
+    return kernels().load (std::memory_order_relaxed)->plain (
+            begin_, end_, utf8_);
+}
+
+/******************************************************************************/
+
+/**
+ * Past the lead byte the first continuation is where the ranges narrow,
+ * E0 can't be followed by anything under A0 (overlong), ED by anything
+ * over 9F (a surrogate), F0 by anything under 90 (overlong) and F4 by
+ * anything over 8F (past U+10FFFF)
+ */
+size_t
+amqp::internal::writer::
+sequence (const char * begin_, const char * end_) {
+    auto left = static_cast<size_t> (end_ - begin_);
+
+    auto at = [begin_](size_t i_) {
+        return static_cast<unsigned char>(begin_[i_]);
+    };
+
+    auto continues = [&](size_t i_, unsigned lo_ = 0x80, unsigned hi_ = 0xbf) {
+        return i_ < left && at (i_) >= lo_ && at (i_) <= hi_;
+    };
+
+    auto c = at (0);
+
+    if (c < 0x80) {
+        return 1;
+    }
+
+    if (c >= 0xc2 && c <= 0xdf) {
+        return continues (1) ? 2 : 0;
+    }
+
+    if (c >= 0xe0 && c <= 0xef) {
+        return continues (1, c == 0xe0 ? 0xa0 : 0x80, c == 0xed ? 0x9f : 0xbf)
+            && continues (2) ? 3 : 0;
+    }
+
+    if (c >= 0xf0 && c <= 0xf4) {
+        return continues (1, c == 0xf0 ? 0x90 : 0x80, c == 0xf4 ? 0x8f : 0xbf)
+            && continues (2)
+            && continues (3) ? 4 : 0;
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
@@ -0,0 +1,124 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <cstddef>
+#include <string_view>
+
+/******************************************************************************
+ *
+ * Strings come off the wire as whatever bytes the JVM wrote. Before they
+ * go into a JSON string they have to be checked as UTF-8, anything that
+ * isn't becoming U+FFFD, and have quotes, backslashes and control
+ * characters escaped.
+ *
+ * Both are done a block at a time with AVX2 or SSE4.2 where the CPU has
+ * them, decided once at start up, and a byte at a time where it doesn't.
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::writer {
+
+    enum class Kernel { Scalar, SSE42, AVX2 };
+
+    /**
+     * Which kernels are in use
+     */
+    Kernel kernel();
+
+    /**
+     * Use at most [kernel_] from now on, falling back to whatever the CPU
+     * does support, returning what's now in use. The best there is gets
+     * used unless told otherwise, this is for the tests and benchmarks.
+     */
+    Kernel use (Kernel kernel_);
+
+    /**
+     * Whether [str_] is well formed UTF-8 as RFC 3629 has it, so no
+     * overlong forms, surrogates, or anything past U+10FFFF
+     */
+    bool validUtf8 (std::string_view str_);
+
+    /**
+     * The first byte of [begin_, end_) that can't be copied into a JSON
+     * string as it is, [end_] if there isn't one. That's a quote, a
+     * backslash or a control character and, unless [utf8_] says the
+     * string has already been validated, anything that isn't ASCII.
+     */
+    const char * plain (const char * begin_, const char * end_, bool utf8_);
+
+    /**
+     * How long the UTF-8 sequence starting at [begin_] is, 0 if it isn't
+     * a valid one
+     */
+    size_t sequence (const char * begin_, const char * end_);
+
+    /**
+     * Append [str_] to [out_] quoted and escaped, copying everything that
+     * needs no escaping a run at a time straight into [out_]
+     */
+    template<class S>
+    void escape (S & out_, std::string_view str_);
+
+}
+
+/******************************************************************************/
+
+template<class S>
+void
+amqp::internal::writer::
+escape (S & out_, std::string_view str_) {
+    constexpr char hex[] = "0123456789abcdef";
+
+    auto utf8 = validUtf8 (str_);
+
+    auto begin = str_.data();
+    auto end = begin + str_.size();
+
+    out_.push_back ('"');
+
+    while (begin != end) {
+        auto run = plain (begin, end, utf8);
+
+        out_.append (begin, run);
+
+        if (run == end) {
+            break;
+        }
+
+        auto c = static_cast<unsigned char>(*run);
+
+        if (c >= 0x80) {
+            auto n = sequence (run, end);
+
+            if (n) {
+                out_.append (run, n);
+            } else {
+                out_.append ("\xef\xbf\xbd");
+            }
+
+            begin = run + (n ? n : 1);
+            continue;
+        }
+
+        switch (c) {
+            case '"'  : out_.append ("\\\""); break;
+            case '\\' : out_.append ("\\\\"); break;
+            case '\b' : out_.append ("\\b"); break;
+            case '\f' : out_.append ("\\f"); break;
+            case '\n' : out_.append ("\\n"); break;
+            case '\r' : out_.append ("\\r"); break;
+            case '\t' : out_.append ("\\t"); break;
+            default : {
+                char u[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+                out_.append (u, sizeof (u));
+            }
+        }
+
+        begin = run + 1;
+    }
+
+    out_.push_back ('"');
+}
+
+/******************************************************************************/
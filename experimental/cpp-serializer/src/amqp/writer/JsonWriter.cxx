@@ -0,0 +1,293 @@
+#include "JsonWriter.h"
+#include "Escape.h"
+
+#include <cmath>
+#include <charconv>
+#include <stdexcept>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * When writing to a file this is how much we let build up before
+     * writing it out
+     */
+    constexpr size_t flushAt { 64 * 1024 };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::writer::JsonWriter
+ *
+ ******************************************************************************/
+
+amqp::internal::writer::
+JsonWriter::JsonWriter()
+    : m_file { nullptr }
+{ }
+
+/******************************************************************************/
+
+amqp::internal::writer::
+JsonWriter::JsonWriter (FILE * file_)
+    : m_file { file_ }
+{
+    m_buffer.reserve (flushAt + 1024);
+}
+
+/******************************************************************************/
+
+amqp::internal::writer::
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::flush() {
+    if (m_file && !m_buffer.empty()) {
+        fwrite (m_buffer.data(), 1, m_buffer.size(), m_file);
+        m_buffer.clear();
+    }
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::writer::
+JsonWriter::take() {
+    std::string rtn;
+    rtn.swap (m_buffer);
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Comma between elements of an array or pairs of an object
+ */
+void
+amqp::internal::writer::
+JsonWriter::separate() {
+    auto & level = m_levels.back();
+
+    if (level & isFirst) {
+        level &= ~isFirst;
+    } else {
+        m_buffer.push_back (',');
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Called ahead of writing any value, returns true if rather than a value
+ * what's about to be written is standing in for a key
+ */
+bool
+amqp::internal::writer::
+JsonWriter::prefix() {
+    if (m_levels.empty()) {
+        return false;
+    }
+
+    auto level = m_levels.back();
+
+    if (!(level & inObject) || (level & expectKey)) {
+        separate();
+    }
+
+    return (level & (inObject | expectKey)) == (inObject | expectKey);
+}
+
+/******************************************************************************/
+
+/**
+ * Called once a value has been written, if it was a key we need the colon
+ * and then a value, otherwise if we're in an object the next thing is a key
+ */
+void
+amqp::internal::writer::
+JsonWriter::suffix() {
+    if (!m_levels.empty()) {
+        auto & level = m_levels.back();
+
+        if (level & inObject) {
+            if (level & expectKey) {
+                m_buffer.push_back (':');
+                level &= ~expectKey;
+            } else {
+                level |= expectKey;
+            }
+        }
+    }
+
+    if (m_file && m_buffer.size() >= flushAt) {
+        flush();
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * See Escape.h, anything that isn't UTF-8 becomes U+FFFD
+ */
+void
+amqp::internal::writer::
+JsonWriter::escape (std::string_view str_) {
+    writer::escape (m_buffer, str_);
+}
+
+/******************************************************************************/
+
+/**
+ * Numbers in key position need quoting since JSON keys are always strings
+ */
+template<typename T>
+void
+amqp::internal::writer::
+JsonWriter::number (T value_) {
+    auto isKey = prefix();
+
+    char buf[32];
+    auto [end, ec] = std::to_chars (buf, buf + sizeof (buf), value_);
+
+    if (isKey) m_buffer.push_back ('"');
+    m_buffer.append (buf, end);
+    if (isKey) m_buffer.push_back ('"');
+
+    suffix();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::beginObject() {
+    if (prefix()) {
+        throw std::runtime_error ("JSON keys must be strings or numbers");
+    }
+
+    m_buffer.push_back ('{');
+    m_levels.push_back (inObject | isFirst | expectKey);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::endObject() {
+    m_levels.pop_back();
+    m_buffer.push_back ('}');
+    suffix();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::beginArray() {
+    if (prefix()) {
+        throw std::runtime_error ("JSON keys must be strings or numbers");
+    }
+
+    m_buffer.push_back ('[');
+    m_levels.push_back (isFirst);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::endArray() {
+    m_levels.pop_back();
+    m_buffer.push_back (']');
+    suffix();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::key (std::string_view key_) {
+    if (m_levels.empty() || (m_levels.back() & (inObject | expectKey)) != (inObject | expectKey)) {
+        throw std::runtime_error ("JSON key written outside of an object");
+    }
+
+    string (key_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::string (std::string_view value_) {
+    prefix();
+    escape (value_);
+    suffix();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::integer (int64_t value_) {
+    number (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::unsignedInteger (uint64_t value_) {
+    number (value_);
+}
+
+/******************************************************************************/
+
+/**
+ * std::to_chars gives us the shortest representation that round trips.
+ * JSON has no way to express NaN or the infinities so they become null
+ */
+void
+amqp::internal::writer::
+JsonWriter::floating (double value_) {
+    if (!std::isfinite (value_)) {
+        null();
+    } else {
+        number (value_);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::boolean (bool value_) {
+    auto isKey = prefix();
+
+    m_buffer.append (
+        isKey ? (value_ ? "\"true\"" : "\"false\"")
+              : (value_ ? "true" : "false"));
+
+    suffix();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+JsonWriter::null() {
+    auto isKey = prefix();
+
+    m_buffer.append (isKey ? "\"null\"" : "null");
+
+    suffix();
+}
+
+/******************************************************************************/
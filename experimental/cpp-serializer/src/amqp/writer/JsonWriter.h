@@ -0,0 +1,76 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "amqp/writer/IWriter.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::writer {
+
+    /**
+     * RFC 8259 JSON, written compactly into a growable buffer. Given a FILE
+     * that buffer is flushed to it whenever it fills, otherwise it's left
+     * for the caller to collect once they've finished writing.
+     *
+     * All we keep per level of nesting is a byte of state, enough to know
+     * whether a separator is due and whether we're waiting on a key.
+     */
+    class JsonWriter : public amqp::writer::IWriter {
+        private :
+            enum State : uint8_t {
+                inObject  = 1 << 0,
+                isFirst   = 1 << 1,
+                expectKey = 1 << 2
+            };
+
+            std::string m_buffer;
+            std::vector<uint8_t> m_levels;
+            FILE * m_file;
+
+            void separate();
+            bool prefix();
+            void suffix();
+
+            void escape (std::string_view);
+
+            template<typename T>
+            void number (T);
+
+        public :
+            JsonWriter();
+            explicit JsonWriter (FILE *);
+
+            JsonWriter (const JsonWriter &) = delete;
+            JsonWriter & operator = (const JsonWriter &) = delete;
+
+            ~JsonWriter() override;
+
+            void beginObject() override;
+            void endObject() override;
+
+            void beginArray() override;
+            void endArray() override;
+
+            void key (std::string_view) override;
+
+            void string (std::string_view) override;
+            void integer (int64_t) override;
+            void unsignedInteger (uint64_t) override;
+            void floating (double) override;
+            void boolean (bool) override;
+            void null() override;
+
+            void flush();
+
+            const std::string & str() const { return m_buffer; }
+            std::string take();
+    };
+
+}
+
+/******************************************************************************/
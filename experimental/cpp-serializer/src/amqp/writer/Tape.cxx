@@ -0,0 +1,197 @@
+#include "Tape.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using Kind = amqp::internal::writer::Tape::Kind;
+
+    void
+    play (
+        amqp::writer::IWriter & writer_,
+        const amqp::internal::writer::Tape::Event & event_
+    ) {
+        switch (event_.kind) {
+            case Kind::BeginObject     : writer_.beginObject(); break;
+            case Kind::EndObject       : writer_.endObject(); break;
+            case Kind::BeginArray      : writer_.beginArray(); break;
+            case Kind::EndArray        : writer_.endArray(); break;
+            case Kind::Key             : writer_.key (event_.str); break;
+            case Kind::String          : writer_.string (event_.str); break;
+            case Kind::Integer         : writer_.integer (event_.i); break;
+            case Kind::UnsignedInteger : writer_.unsignedInteger (event_.u); break;
+            case Kind::Floating        : writer_.floating (event_.d); break;
+            case Kind::Boolean         : writer_.boolean (event_.b); break;
+            case Kind::Null            : writer_.null(); break;
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::writer::Tape
+ *
+ ******************************************************************************/
+
+amqp::internal::writer::
+Tape::Tape (amqp::writer::IWriter & writer_, sVec<Event> & events_)
+    : m_writer (writer_)
+    , m_events (events_)
+    , m_muted { 0 }
+    , m_hidden { 0 }
+{
+    m_events.clear();
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::writer::
+Tape::record (const Event & event_) {
+    m_events.push_back (event_);
+    m_events.back().hidden = m_hidden != 0;
+
+    return !m_muted && !m_hidden;
+}
+
+/******************************************************************************/
+
+/**
+ * Playing an event records it again, which may move the events about, so
+ * each is copied out before it's played
+ */
+void
+amqp::internal::writer::
+Tape::replay (size_t begin_, size_t end_) {
+    m_events.reserve (m_events.size() + (end_ - begin_));
+
+    for (auto i { begin_ } ; i < end_ ; ++i) {
+        auto event = m_events[i];
+        play (*this, event);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::forward (size_t begin_, size_t end_) {
+    for (auto i { begin_ } ; i < end_ ; ++i) {
+        if (!m_events[i].hidden) {
+            play (m_writer, m_events[i]);
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::beginObject() {
+    if (record ({ Kind::BeginObject, { }, { } })) m_writer.beginObject();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::endObject() {
+    if (record ({ Kind::EndObject, { }, { } })) m_writer.endObject();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::beginArray() {
+    if (record ({ Kind::BeginArray, { }, { } })) m_writer.beginArray();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::endArray() {
+    if (record ({ Kind::EndArray, { }, { } })) m_writer.endArray();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::key (std::string_view key_) {
+    if (record ({ Kind::Key, { }, key_ })) m_writer.key (key_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::string (std::string_view value_) {
+    if (record ({ Kind::String, { }, value_ })) m_writer.string (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::integer (int64_t value_) {
+    Event event { Kind::Integer, { }, { } };
+    event.i = value_;
+
+    if (record (event)) m_writer.integer (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::unsignedInteger (uint64_t value_) {
+    Event event { Kind::UnsignedInteger, { }, { } };
+    event.u = value_;
+
+    if (record (event)) m_writer.unsignedInteger (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::floating (double value_) {
+    Event event { Kind::Floating, { }, { } };
+    event.d = value_;
+
+    if (record (event)) m_writer.floating (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::boolean (bool value_) {
+    Event event { Kind::Boolean, { }, { } };
+    event.b = value_;
+
+    if (record (event)) m_writer.boolean (value_);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::null() {
+    if (record ({ Kind::Null, { }, { } })) m_writer.null();
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::writer::
+Tape::formatted (std::string_view value_) {
+    std::string_view kept { m_formatted.emplace_front (value_) };
+
+    if (record ({ Kind::String, { }, kept })) m_writer.string (kept);
+}
+
+/******************************************************************************/
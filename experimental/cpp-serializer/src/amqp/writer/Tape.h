@@ -0,0 +1,143 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <string_view>
+#include <forward_list>
+
+#include "types.h"
+
+#include "amqp/writer/IWriter.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::writer {
+
+    /**
+     * Passes everything written to it on to another writer, keeping a
+     * record as it goes so any stretch of it can be written again. That's
+     * how a reference back to a value already written is written without
+     * reading the value again.
+     *
+     * Strings are kept as views so whatever they're viewing, the blob or
+     * the program's names, must outlive the tape. Anything [formatted]
+     * is copied and kept for as long as the tape is.
+     *
+     * What's recorded goes into storage the caller hands us, that way a
+     * thread decoding blob after blob can keep reusing the same storage
+     * rather than growing a fresh one each time.
+     *
+     * While muted what's written is recorded but not passed on, it can be
+     * passed on later with [forward].
+     *
+     * While hidden what's written is recorded, so it can be replayed, but
+     * is never passed on nor forwarded, see [hide].
+     */
+    class Tape : public amqp::writer::IWriter {
+        public :
+            enum class Kind : uint8_t {
+                BeginObject,
+                EndObject,
+                BeginArray,
+                EndArray,
+                Key,
+                String,
+                Integer,
+                UnsignedInteger,
+                Floating,
+                Boolean,
+                Null
+            };
+
+            struct Event {
+                Kind kind;
+                union {
+                    int64_t  i;
+                    uint64_t u;
+                    double   d;
+                    bool     b;
+                };
+                std::string_view str;
+                bool hidden;
+            };
+
+        private :
+            amqp::writer::IWriter & m_writer;
+            sVec<Event> & m_events;
+            size_t m_muted;
+            size_t m_hidden;
+
+            // a list so what's been kept never moves from under its views
+            std::forward_list<std::string> m_formatted;
+
+            /**
+             * Whether what's being recorded should be passed on
+             */
+            bool record (const Event &);
+
+        public :
+            /**
+             * Anything already in [events_] is discarded
+             */
+            Tape (amqp::writer::IWriter &, sVec<Event> & events_);
+
+            Tape (const Tape &) = delete;
+            Tape & operator = (const Tape &) = delete;
+
+            /**
+             * Where the next thing written will be recorded
+             */
+            size_t mark() const { return m_events.size(); }
+
+            /**
+             * Write again everything recorded between [begin_] and [end_],
+             * which is also recorded again
+             */
+            void replay (size_t begin_, size_t end_);
+
+            /**
+             * Pass on to the writer everything recorded between [begin_]
+             * and [end_] without recording it again
+             */
+            void forward (size_t begin_, size_t end_);
+
+            /**
+             * Mutes nest, it takes as many calls to [unmute] as [mute]
+             */
+            void mute() { ++m_muted; }
+            void unmute() { --m_muted; }
+
+            /**
+             * For what's read only so anything later can refer to it, as
+             * with a property an [Evolution] drops. Replaying it is as if
+             * it were written afresh, so it's only hidden where it first
+             * was. Hides nest like mutes.
+             */
+            void hide() { ++m_hidden; }
+            void show() { --m_hidden; }
+
+            const Event & event (size_t i_) const { return m_events[i_]; }
+
+            void beginObject() override;
+            void endObject() override;
+
+            void beginArray() override;
+            void endArray() override;
+
+            void key (std::string_view) override;
+
+            void string (std::string_view) override;
+            void integer (int64_t) override;
+            void unsignedInteger (uint64_t) override;
+            void floating (double) override;
+            void boolean (bool) override;
+            void null() override;
+
+            void formatted (std::string_view) override;
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,242 @@
+#include "proton/codec.h"
+
+#include "Data.h"
+#include "Encoding.h"
+
+#if (defined (__x86_64__) || defined (__i386__)) && (defined (__GNUC__) || defined (__clang__))
+#define AMQP_BULK_X86
+#include <immintrin.h>
+#endif
+
+/******************************************************************************
+ *
+ * Reading a whole list or array of ints, longs or doubles at once.
+ *
+ * An AMQP array has one constructor for all its elements so they follow
+ * each other as a contiguous run of big endian values, which we can byte
+ * swap into place a register at a time. A list, which is what the JVM
+ * writes for int[] and List<Int>, has a constructor for each element,
+ * smallint and smalllong taking a byte, so the best we can do is a tight
+ * loop over them.
+ *
+ ******************************************************************************/
+
+using namespace amqp::internal::native;
+
+/******************************************************************************/
+
+namespace {
+
+    template<typename T>
+    void
+    swapScalar (const char * in_, T * out_, size_t n_) {
+        for (size_t i { 0 } ; i < n_ ; ++i) {
+            auto value = readBE<T> (in_ + i * sizeof (T));
+            std::memcpy (out_ + i, &value, sizeof (T));
+        }
+    }
+
+#ifdef AMQP_BULK_X86
+
+    /**
+     * For each element, its bytes in reverse
+     */
+    template<size_t W>
+    constexpr char
+    reverse (size_t i_) {
+        return static_cast<char> ((i_ / W) * W + (W - 1 - i_ % W));
+    }
+
+    template<typename T>
+    __attribute__ ((target ("ssse3"))) void
+    swapSSSE3 (const char * in_, T * out_, size_t n_) {
+        constexpr auto W = sizeof (T);
+
+        const auto mask = _mm_setr_epi8 (
+            reverse<W> (0), reverse<W> (1), reverse<W> (2), reverse<W> (3),
+            reverse<W> (4), reverse<W> (5), reverse<W> (6), reverse<W> (7),
+            reverse<W> (8), reverse<W> (9), reverse<W> (10), reverse<W> (11),
+            reverse<W> (12), reverse<W> (13), reverse<W> (14), reverse<W> (15));
+
+        size_t i { 0 };
+
+        for ( ; (i + 16 / W) <= n_ ; i += 16 / W) {
+            auto v = _mm_loadu_si128 (reinterpret_cast<const __m128i *>(in_ + i * W));
+            _mm_storeu_si128 (
+                    reinterpret_cast<__m128i *>(out_ + i),
+                    _mm_shuffle_epi8 (v, mask));
+        }
+
+        swapScalar (in_ + i * W, out_ + i, n_ - i);
+    }
+
+    template<typename T>
+    __attribute__ ((target ("avx2"))) void
+    swapAVX2 (const char * in_, T * out_, size_t n_) {
+        constexpr auto W = sizeof (T);
+
+        // the shuffle works on each 128 bit lane separately, as luck
+        // would have it elements never straddle the two
+        const auto mask = _mm256_setr_epi8 (
+            reverse<W> (0), reverse<W> (1), reverse<W> (2), reverse<W> (3),
+            reverse<W> (4), reverse<W> (5), reverse<W> (6), reverse<W> (7),
+            reverse<W> (8), reverse<W> (9), reverse<W> (10), reverse<W> (11),
+            reverse<W> (12), reverse<W> (13), reverse<W> (14), reverse<W> (15),
+            reverse<W> (0), reverse<W> (1), reverse<W> (2), reverse<W> (3),
+            reverse<W> (4), reverse<W> (5), reverse<W> (6), reverse<W> (7),
+            reverse<W> (8), reverse<W> (9), reverse<W> (10), reverse<W> (11),
+            reverse<W> (12), reverse<W> (13), reverse<W> (14), reverse<W> (15));
+
+        size_t i { 0 };
+
+        for ( ; (i + 32 / W) <= n_ ; i += 32 / W) {
+            auto v = _mm256_loadu_si256 (reinterpret_cast<const __m256i *>(in_ + i * W));
+            _mm256_storeu_si256 (
+                    reinterpret_cast<__m256i *>(out_ + i),
+                    _mm256_shuffle_epi8 (v, mask));
+        }
+
+        swapSSSE3 (in_ + i * W, out_ + i, n_ - i);
+    }
+
+#endif
+
+    /**
+     * [n_] big endian [T]s at [in_] into [out_], with whatever the CPU
+     * can best do it with
+     */
+    template<typename T>
+    void
+    swap (const char * in_, T * out_, size_t n_) {
+#ifdef AMQP_BULK_X86
+        static const auto best = []() {
+            __builtin_cpu_init();
+
+            return __builtin_cpu_supports ("avx2") ? &swapAVX2<T>
+                : __builtin_cpu_supports ("ssse3") ? &swapSSSE3<T>
+                : &swapScalar<T>;
+        }();
+
+        best (in_, out_, n_);
+#else
+        swapScalar (in_, out_, n_);
+#endif
+    }
+
+    /*
+     * The constructors each type can be written with, the full width one
+     * and, for ints and longs, the one byte form. Doubles only have one.
+     */
+    template<typename T> struct Codes;
+
+    template<> struct Codes<int32_t> { static constexpr uint8_t full = 0x71, small = 0x54; };
+    template<> struct Codes<int64_t> { static constexpr uint8_t full = 0x81, small = 0x55; };
+    template<> struct Codes<uint64_t> { static constexpr uint8_t full = 0x82, small = 0x82; };
+
+    template<typename T>
+    bool
+    array (const Node & node_, T * out_, size_t n_) {
+        const auto & c = constructor (node_.code);
+        auto element = node_.value + 2 * c.width;
+
+        if (element >= node_.end) {
+            return n_ == 0;
+        }
+
+        auto code = static_cast<uint8_t>(*element++);
+        auto width = constructor (code).width;
+
+        if (   (code != Codes<T>::full && code != Codes<T>::small)
+            || static_cast<size_t> (node_.end - element) < n_ * width)
+        {
+            return false;
+        }
+
+        if (width == sizeof (T)) {
+            swap (element, out_, n_);
+        } else {
+            for (size_t i { 0 } ; i < n_ ; ++i) {
+                out_[i] = static_cast<int8_t> (element[i]);
+            }
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    bool
+    list (const Node & node_, T * out_, size_t n_) {
+        const auto & c = constructor (node_.code);
+        auto pos = node_.value + 2 * c.width;
+        auto end = node_.end;
+
+        for (size_t i { 0 } ; i < n_ ; ++i) {
+            if (pos == end) {
+                return false;
+            }
+
+            auto code = static_cast<uint8_t>(*pos++);
+
+            if (code == Codes<T>::full && end - pos >= static_cast<ptrdiff_t> (sizeof (T))) {
+                auto value = readBE<T> (pos);
+                std::memcpy (out_ + i, &value, sizeof (T));
+                pos += sizeof (T);
+            } else if (code == Codes<T>::small && pos != end) {
+                out_[i] = static_cast<int8_t> (*pos++);
+            } else {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    bool
+    primitives (const pn_data_t * data_, T * out_, size_t n_) {
+        if (!data_->m_hasCurrent) {
+            return false;
+        }
+
+        const auto & node = data_->m_current;
+        const auto & c = constructor (node.code);
+
+        if (c.type == PN_LIST && c.category == Category::fixed) {
+            return n_ == 0;
+        }
+
+        if (   (c.type != PN_LIST && c.type != PN_ARRAY)
+            || readWidth (node.value + c.width, c.width) != n_)
+        {
+            return false;
+        }
+
+        return c.type == PN_ARRAY
+            ? array (node, out_, n_)
+            : list (node, out_, n_);
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Doubles are swapped as the 64 bit patterns they are, copied rather than
+ * assigned into place so they stay doubles
+ */
+bool
+pn_data_get_primitives (
+    pn_data_t * data_,
+    pn_type_t type_,
+    void * out_,
+    size_t count_
+) {
+    switch (type_) {
+        case PN_INT    : return primitives (data_, static_cast<int32_t *> (out_), count_);
+        case PN_LONG   : return primitives (data_, static_cast<int64_t *> (out_), count_);
+        case PN_DOUBLE : return primitives (data_, static_cast<uint64_t *> (out_), count_);
+        default        : return false;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,67 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <vector>
+
+#include "Encoding.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::native {
+
+    /**
+     * A node we have entered, tracking where its children live and how
+     * far through them we are.
+     */
+    struct Frame {
+        // the container itself and its position within its own parent
+        Node   node;
+        size_t index;
+
+        const char * first;    // the first child
+        size_t       children;
+
+        // arrays share one constructor between their elements, which for
+        // a described array follow the descriptor (the first child)
+        bool         array;
+        bool         described;
+        uint8_t      element;
+        const char * elements;
+    };
+
+    /**
+     * Build the frame for entering [node_], that node being the [index_]th
+     * child of its parent
+     */
+    Frame enter (const Node & node_, size_t index_);
+
+}
+
+/******************************************************************************
+ *
+ * pn_data_t
+ *
+ ******************************************************************************/
+
+/**
+ * The native decoder's cursor. Where qpid-proton builds a node tree this is
+ * nothing more than a position within the encoded bytes and a stack of the
+ * nodes we've entered to get there.
+ */
+struct pn_data_t {
+    const char * m_bytes { nullptr };
+    size_t       m_size  { 0 };
+
+    // m_parents.front() is a pseudo node containing the decoded value
+    std::vector<amqp::internal::native::Frame> m_parents;
+
+    amqp::internal::native::Node m_current { };
+    size_t m_index   { 0 };
+    bool   m_hasCurrent { false };
+
+    // bytes stepped over with pn_data_skip since the last decode
+    size_t m_skipped { 0 };
+};
+
+/******************************************************************************/
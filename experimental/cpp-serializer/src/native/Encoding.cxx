@@ -0,0 +1,205 @@
+#include "Encoding.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal::native;
+
+    constexpr Constructor
+    make (uint8_t code_) {
+        switch (code_) {
+            case 0x00 : return { PN_DESCRIBED,  Category::described, 0 };
+
+            case 0x40 : return { PN_NULL,       Category::fixed, 0 };
+            case 0x41 : return { PN_BOOL,       Category::fixed, 0 };
+            case 0x42 : return { PN_BOOL,       Category::fixed, 0 };
+            case 0x43 : return { PN_UINT,       Category::fixed, 0 };
+            case 0x44 : return { PN_ULONG,      Category::fixed, 0 };
+            case 0x45 : return { PN_LIST,       Category::fixed, 0 };
+
+            case 0x50 : return { PN_UBYTE,      Category::fixed, 1 };
+            case 0x51 : return { PN_BYTE,       Category::fixed, 1 };
+            case 0x52 : return { PN_UINT,       Category::fixed, 1 };
+            case 0x53 : return { PN_ULONG,      Category::fixed, 1 };
+            case 0x54 : return { PN_INT,        Category::fixed, 1 };
+            case 0x55 : return { PN_LONG,       Category::fixed, 1 };
+            case 0x56 : return { PN_BOOL,       Category::fixed, 1 };
+
+            case 0x60 : return { PN_USHORT,     Category::fixed, 2 };
+            case 0x61 : return { PN_SHORT,      Category::fixed, 2 };
+
+            case 0x70 : return { PN_UINT,       Category::fixed, 4 };
+            case 0x71 : return { PN_INT,        Category::fixed, 4 };
+            case 0x72 : return { PN_FLOAT,      Category::fixed, 4 };
+            case 0x73 : return { PN_CHAR,       Category::fixed, 4 };
+            case 0x74 : return { PN_DECIMAL32,  Category::fixed, 4 };
+
+            case 0x80 : return { PN_ULONG,      Category::fixed, 8 };
+            case 0x81 : return { PN_LONG,       Category::fixed, 8 };
+            case 0x82 : return { PN_DOUBLE,     Category::fixed, 8 };
+            case 0x83 : return { PN_TIMESTAMP,  Category::fixed, 8 };
+            case 0x84 : return { PN_DECIMAL64,  Category::fixed, 8 };
+
+            case 0x94 : return { PN_DECIMAL128, Category::fixed, 16 };
+            case 0x98 : return { PN_UUID,       Category::fixed, 16 };
+
+            case 0xa0 : return { PN_BINARY,     Category::variable, 1 };
+            case 0xa1 : return { PN_STRING,     Category::variable, 1 };
+            case 0xa3 : return { PN_SYMBOL,     Category::variable, 1 };
+            case 0xb0 : return { PN_BINARY,     Category::variable, 4 };
+            case 0xb1 : return { PN_STRING,     Category::variable, 4 };
+            case 0xb3 : return { PN_SYMBOL,     Category::variable, 4 };
+
+            case 0xc0 : return { PN_LIST,       Category::compound, 1 };
+            case 0xc1 : return { PN_MAP,        Category::compound, 1 };
+            case 0xd0 : return { PN_LIST,       Category::compound, 4 };
+            case 0xd1 : return { PN_MAP,        Category::compound, 4 };
+
+            case 0xe0 : return { PN_ARRAY,      Category::array, 1 };
+            case 0xf0 : return { PN_ARRAY,      Category::array, 4 };
+
+            default   : return { PN_INVALID,    Category::invalid, 0 };
+        }
+    }
+
+    constexpr std::array<Constructor, 256>
+    makeTable() {
+        std::array<Constructor, 256> rtn { };
+        for (size_t i { 0 } ; i < rtn.size() ; ++i) {
+            rtn[i] = make (static_cast<uint8_t>(i));
+        }
+        return rtn;
+    }
+
+    constexpr std::array<Constructor, 256> constructors = makeTable();
+
+}
+
+/******************************************************************************/
+
+const amqp::internal::native::Constructor &
+amqp::internal::native::
+constructor (uint8_t code_) {
+    return constructors[code_];
+}
+
+/******************************************************************************/
+
+namespace {
+
+    using namespace amqp::internal::native;
+
+    /**
+     * Described values nest by recursing, a descriptor or value being
+     * itself described, so how deep we'll go is capped rather than
+     * letting a crafted blob take the stack
+     */
+    constexpr int MaxDescribedDepth = 32;
+
+    bool element (const char *, const char *, uint8_t, Node &, int);
+
+    bool
+    node (const char * pos_, const char * limit_, Node & node_, int depth_) {
+        if (pos_ >= limit_) {
+            return false;
+        }
+
+        return element (
+                pos_ + 1,
+                limit_,
+                static_cast<uint8_t>(*pos_),
+                node_,
+                depth_);
+    }
+
+    bool
+    element (
+            const char * pos_,
+            const char * limit_,
+            uint8_t code_,
+            Node & node_,
+            int depth_
+    ) {
+        const auto & c = constructor (code_);
+
+        node_.code  = code_;
+        node_.value = pos_;
+
+        switch (c.category) {
+            case Category::fixed : {
+                if (limit_ - pos_ < c.width) {
+                    return false;
+                }
+                node_.end = pos_ + c.width;
+                break;
+            }
+            case Category::variable :
+            case Category::compound :
+            case Category::array : {
+                if (limit_ - pos_ < c.width) {
+                    return false;
+                }
+
+                auto size = readWidth (pos_, c.width);
+
+                if (static_cast<size_t>(limit_ - pos_ - c.width) < size) {
+                    return false;
+                }
+
+                // lists, maps and arrays have their count inside the size
+                if (c.category != Category::variable && size < c.width) {
+                    return false;
+                }
+
+                node_.end = pos_ + c.width + size;
+                break;
+            }
+            case Category::described : {
+                // a descriptor followed by the value being described, neither
+                // carries a size for the pair so we have to walk both
+                Node descriptor { };
+                Node value { };
+
+                if (   depth_ >= MaxDescribedDepth
+                    || !node (pos_, limit_, descriptor, depth_ + 1)
+                    || !node (descriptor.end, limit_, value, depth_ + 1))
+                {
+                    return false;
+                }
+
+                node_.end = value.end;
+                break;
+            }
+            case Category::invalid : {
+                return false;
+            }
+        }
+
+        return node_.end <= limit_;
+    }
+
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::native::
+decode (const char * pos_, const char * limit_, Node & node_) {
+    return node (pos_, limit_, node_, 0);
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::native::
+decodeElement (
+        const char * pos_,
+        const char * limit_,
+        uint8_t code_,
+        Node & node_
+) {
+    return element (pos_, limit_, code_, node_, 0);
+}
+
+/******************************************************************************/
@@ -0,0 +1,114 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "proton/codec.h"
+
+/******************************************************************************
+ *
+ * The AMQP 1.0 wire format as the native decoder sees it
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::native {
+
+    /**
+     * AMQP groups its constructors by how the size of the value that
+     * follows them is determined, the group being encoded in the high
+     * nibble of the constructor byte.
+     */
+    enum class Category : uint8_t {
+        invalid,
+        described,
+        fixed,     // a value of [width] bytes
+        variable,  // a [width] byte size then that many bytes
+        compound,  // a [width] byte size, a [width] byte count, then the elements
+        array      // as compound but with a single element constructor up front
+    };
+
+    struct Constructor {
+        pn_type_t type;
+        Category  category;
+        uint8_t   width;
+    };
+
+    /**
+     * Look up the constructor for a type code, unknown codes map to
+     * [Category::invalid].
+     */
+    const Constructor & constructor (uint8_t);
+
+    /**
+     * A single value within an encoded buffer.
+     *
+     * [value] points at the first byte after the constructor, for a
+     * described type that is the start of the descriptor. [end] is one past
+     * the last byte the value, and anything it contains, occupies.
+     */
+    struct Node {
+        const char * value;
+        const char * end;
+        uint8_t      code;
+    };
+
+    /**
+     * Decode the node whose constructor sits at [pos]. Fails if the
+     * constructor is unknown, the node would run past [limit], a list,
+     * map or array is too short to hold its count or described values
+     * nest too deep.
+     */
+    bool decode (const char * pos, const char * limit, Node &);
+
+    /**
+     * Array elements share the constructor at the head of the array so,
+     * unlike [decode], [pos] points straight at the element's value.
+     */
+    bool decodeElement (const char * pos, const char * limit, uint8_t, Node &);
+
+    /**
+     * AMQP is big endian on the wire
+     */
+    template<typename T>
+    inline T
+    readBE (const char * bytes_) {
+        std::make_unsigned_t<T> rtn;
+
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // one load and a byte swap rather than a loop over the bytes
+        std::memcpy (&rtn, bytes_, sizeof (T));
+
+        if constexpr (sizeof (T) == 2) {
+            rtn = __builtin_bswap16 (rtn);
+        } else if constexpr (sizeof (T) == 4) {
+            rtn = __builtin_bswap32 (rtn);
+        } else if constexpr (sizeof (T) == 8) {
+            rtn = __builtin_bswap64 (rtn);
+        }
+#else
+        rtn = 0;
+        for (size_t i { 0 } ; i < sizeof (T) ; ++i) {
+            rtn = (rtn << 8U) | static_cast<uint8_t>(bytes_[i]);
+        }
+#endif
+
+        return static_cast<T>(rtn);
+    }
+
+    /**
+     * Read a size or count field of [width_] bytes
+     */
+    inline size_t
+    readWidth (const char * bytes_, uint8_t width_) {
+        return width_ == 1
+            ? static_cast<uint8_t>(*bytes_)
+            : readBE<uint32_t> (bytes_);
+    }
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,678 @@
+#include "proton/codec.h"
+
+#include "Data.h"
+#include "Encoding.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::native;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * The node the cursor is on, or null if we're sat before the first
+     * child of a node we've just entered
+     */
+    inline const Node *
+    current (const pn_data_t * data_) {
+        return data_->m_hasCurrent ? &data_->m_current : nullptr;
+    }
+
+    /**
+     * Decode the [index_]th child of [frame_] found at [pos_]
+     */
+    bool
+    child (
+            const Frame & frame_,
+            const char * pos_,
+            size_t index_,
+            Node & node_
+    ) {
+        if (frame_.array && !(frame_.described && index_ == 0)) {
+            return decodeElement (
+                    pos_, frame_.node.end, frame_.element, node_);
+        }
+
+        return decode (pos_, frame_.node.end, node_);
+    }
+
+    template<typename T>
+    T
+    fixed (const Node & node_) {
+        return readBE<T> (node_.value);
+    }
+
+    pn_bytes_t
+    variable (const Node & node_) {
+        const auto & c = constructor (node_.code);
+        return pn_bytes_t {
+            readWidth (node_.value, c.width),
+            node_.value + c.width
+        };
+    }
+
+    /**
+     * Lists and maps have the element count after their size
+     */
+    size_t
+    count (const Node & node_) {
+        const auto & c = constructor (node_.code);
+
+        if (c.category != Category::compound && c.category != Category::array) {
+            return 0;
+        }
+
+        return readWidth (node_.value + c.width, c.width);
+    }
+
+}
+
+/******************************************************************************/
+
+amqp::internal::native::Frame
+amqp::internal::native::
+enter (const Node & node_, size_t index_) {
+    Frame frame {
+        node_, index_, node_.end, 0, false, false, 0, node_.end
+    };
+
+    const auto & c = constructor (node_.code);
+
+    switch (c.category) {
+        case Category::described : {
+            frame.first = node_.value;
+            frame.children = 2;
+            break;
+        }
+        case Category::compound : {
+            frame.first = node_.value + 2 * c.width;
+            frame.children = count (node_);
+            break;
+        }
+        case Category::array : {
+            const char * ctor = node_.value + 2 * c.width;
+
+            frame.array = true;
+            frame.children = count (node_);
+
+            if (ctor >= node_.end) {
+                frame.children = 0;
+                break;
+            }
+
+            if (*ctor == 0x00) {
+                Node descriptor { };
+                if (   !decode (ctor + 1, node_.end, descriptor)
+                    || descriptor.end >= node_.end)
+                {
+                    frame.children = 0;
+                    break;
+                }
+
+                frame.described = true;
+                frame.first = ctor + 1;
+                frame.element = static_cast<uint8_t>(*descriptor.end);
+                frame.elements = descriptor.end + 1;
+                frame.children += 1;
+            } else {
+                frame.element = static_cast<uint8_t>(*ctor);
+                frame.first = frame.elements = ctor + 1;
+            }
+            break;
+        }
+        default : {
+            break;
+        }
+    }
+
+    return frame;
+}
+
+/******************************************************************************/
+
+const char *
+pn_type_name (pn_type_t type_) {
+    switch (type_) {
+        case PN_NULL       : return "PN_NULL";
+        case PN_BOOL       : return "PN_BOOL";
+        case PN_UBYTE      : return "PN_UBYTE";
+        case PN_BYTE       : return "PN_BYTE";
+        case PN_USHORT     : return "PN_USHORT";
+        case PN_SHORT      : return "PN_SHORT";
+        case PN_UINT       : return "PN_UINT";
+        case PN_INT        : return "PN_INT";
+        case PN_CHAR       : return "PN_CHAR";
+        case PN_ULONG      : return "PN_ULONG";
+        case PN_LONG       : return "PN_LONG";
+        case PN_TIMESTAMP  : return "PN_TIMESTAMP";
+        case PN_FLOAT      : return "PN_FLOAT";
+        case PN_DOUBLE     : return "PN_DOUBLE";
+        case PN_DECIMAL32  : return "PN_DECIMAL32";
+        case PN_DECIMAL64  : return "PN_DECIMAL64";
+        case PN_DECIMAL128 : return "PN_DECIMAL128";
+        case PN_UUID       : return "PN_UUID";
+        case PN_BINARY     : return "PN_BINARY";
+        case PN_STRING     : return "PN_STRING";
+        case PN_SYMBOL     : return "PN_SYMBOL";
+        case PN_DESCRIBED  : return "PN_DESCRIBED";
+        case PN_ARRAY      : return "PN_ARRAY";
+        case PN_LIST       : return "PN_LIST";
+        case PN_MAP        : return "PN_MAP";
+        case PN_INVALID    : return "PN_INVALID";
+    }
+
+    return "<UNKNOWN>";
+}
+
+/******************************************************************************/
+
+pn_bytes_t
+pn_bytes (size_t size_, const char * start_) {
+    return pn_bytes_t { size_, start_ };
+}
+
+/******************************************************************************
+ *
+ * Lifecycle
+ *
+ ******************************************************************************/
+
+pn_data_t *
+pn_data (size_t capacity_) {
+    auto * data = new pn_data_t();
+    data->m_parents.reserve (capacity_ < 16 ? 16 : 16 + capacity_ / 1024);
+    return data;
+}
+
+/******************************************************************************/
+
+void
+pn_data_free (pn_data_t * data_) {
+    delete data_;
+}
+
+/******************************************************************************/
+
+void
+pn_data_clear (pn_data_t * data_) {
+    data_->m_bytes = nullptr;
+    data_->m_size = 0;
+    data_->m_parents.clear();
+    data_->m_hasCurrent = false;
+    data_->m_skipped = 0;
+}
+
+/******************************************************************************/
+
+/**
+ * Nothing is decoded here beyond working out how many bytes the top level
+ * value occupies. Unlike qpid-proton, where decoding appends to whatever
+ * the tree already holds, this replaces it.
+ */
+ssize_t
+pn_data_decode (pn_data_t * data_, const char * bytes_, size_t size_) {
+    pn_data_clear (data_);
+
+    Node node { };
+
+    if (!decode (bytes_, bytes_ + size_, node)) {
+        return PN_UNDERFLOW;
+    }
+
+    data_->m_bytes = bytes_;
+    data_->m_size = size_;
+
+    Frame root {
+        Node { bytes_, node.end, 0x00 }, 0, bytes_, 1, false, false, 0, node.end
+    };
+
+    data_->m_parents.push_back (root);
+    data_->m_current = node;
+    data_->m_index = 0;
+    data_->m_hasCurrent = true;
+
+    return node.end - bytes_;
+}
+
+/******************************************************************************
+ *
+ * Navigation
+ *
+ ******************************************************************************/
+
+void
+pn_data_rewind (pn_data_t * data_) {
+    if (!data_->m_parents.empty()) {
+        data_->m_parents.resize (1);
+    }
+    data_->m_hasCurrent = false;
+}
+
+/******************************************************************************/
+
+/**
+ * As with qpid-proton, failing to move leaves the cursor where it was
+ */
+bool
+pn_data_next (pn_data_t * data_) {
+    if (data_->m_parents.empty()) {
+        return false;
+    }
+
+    const auto & parent = data_->m_parents.back();
+
+    size_t index;
+    const char * pos;
+
+    if (data_->m_hasCurrent) {
+        index = data_->m_index + 1;
+        pos = (parent.described && index == 1)
+            ? parent.elements
+            : data_->m_current.end;
+    } else {
+        index = 0;
+        pos = parent.first;
+    }
+
+    Node node { };
+
+    if (index >= parent.children || !child (parent, pos, index, node)) {
+        return false;
+    }
+
+    data_->m_current = node;
+    data_->m_index = index;
+    data_->m_hasCurrent = true;
+
+    return true;
+}
+
+/******************************************************************************/
+
+/**
+ * Every node knows where it ends, containers from their size prefix, so
+ * moving on is the same jump however much the node holds. All we add is
+ * the count.
+ */
+bool
+pn_data_skip (pn_data_t * data_) {
+    if (!data_->m_hasCurrent) {
+        return pn_data_next (data_);
+    }
+
+    auto size = static_cast<size_t> (
+            data_->m_current.end - data_->m_current.value);
+
+    auto rtn = pn_data_next (data_);
+
+    data_->m_skipped += size;
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+size_t
+pn_data_skipped (pn_data_t * data_) {
+    return data_->m_skipped;
+}
+
+/******************************************************************************/
+
+size_t
+pn_data_offset (pn_data_t * data_) {
+    if (data_->m_hasCurrent) {
+        const auto & parent = data_->m_parents.back();
+
+        // bar an array's elements, which share the array's, each value
+        // starts with its one byte constructor
+        auto shared = parent.array && !(parent.described && data_->m_index == 0);
+
+        return data_->m_current.value - data_->m_bytes - (shared ? 0 : 1);
+    }
+
+    return data_->m_parents.empty()
+        ? 0
+        : data_->m_parents.back().first - data_->m_bytes;
+}
+
+/******************************************************************************/
+
+bool
+pn_data_enter (pn_data_t * data_) {
+    if (!data_->m_hasCurrent) {
+        return false;
+    }
+
+    data_->m_parents.push_back (enter (data_->m_current, data_->m_index));
+    data_->m_hasCurrent = false;
+
+    return true;
+}
+
+/******************************************************************************/
+
+bool
+pn_data_exit (pn_data_t * data_) {
+    if (data_->m_parents.size() <= 1) {
+        return false;
+    }
+
+    const auto & parent = data_->m_parents.back();
+
+    data_->m_current = parent.node;
+    data_->m_index = parent.index;
+    data_->m_hasCurrent = true;
+
+    data_->m_parents.pop_back();
+
+    return true;
+}
+
+/******************************************************************************
+ *
+ * Inspection
+ *
+ ******************************************************************************/
+
+pn_type_t
+pn_data_type (pn_data_t * data_) {
+    auto node = current (data_);
+    return node ? constructor (node->code).type : PN_INVALID;
+}
+
+/******************************************************************************/
+
+bool
+pn_data_is_described (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_DESCRIBED;
+}
+
+/******************************************************************************/
+
+bool
+pn_data_is_null (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_NULL;
+}
+
+/******************************************************************************/
+
+bool
+pn_data_is_array_described (pn_data_t * data_) {
+    if (pn_data_type (data_) != PN_ARRAY) {
+        return false;
+    }
+
+    return enter (data_->m_current, data_->m_index).described;
+}
+
+/******************************************************************************/
+
+size_t
+pn_data_get_list (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_LIST ? count (data_->m_current) : 0;
+}
+
+/******************************************************************************/
+
+size_t
+pn_data_get_map (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_MAP ? count (data_->m_current) : 0;
+}
+
+/******************************************************************************/
+
+size_t
+pn_data_get_array (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_ARRAY ? count (data_->m_current) : 0;
+}
+
+/******************************************************************************/
+
+pn_type_t
+pn_data_get_array_type (pn_data_t * data_) {
+    if (pn_data_type (data_) != PN_ARRAY) {
+        return PN_INVALID;
+    }
+
+    auto frame = enter (data_->m_current, data_->m_index);
+
+    // a zero element constructor means we couldn't find one
+    return frame.element == 0x00
+        ? PN_INVALID
+        : constructor (frame.element).type;
+}
+
+/******************************************************************************
+ *
+ * Scalar getters, each returns a zero value if the current node isn't
+ * of the requested type
+ *
+ ******************************************************************************/
+
+bool
+pn_data_get_bool (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node) return false;
+
+    switch (node->code) {
+        case 0x41 : return true;
+        case 0x56 : return *node->value != 0;
+        default   : return false;
+    }
+}
+
+/******************************************************************************/
+
+uint8_t
+pn_data_get_ubyte (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x50) ? fixed<uint8_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+int8_t
+pn_data_get_byte (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x51) ? fixed<int8_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+uint16_t
+pn_data_get_ushort (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x60) ? fixed<uint16_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+int16_t
+pn_data_get_short (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x61) ? fixed<int16_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+uint32_t
+pn_data_get_uint (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node) return 0;
+
+    switch (node->code) {
+        case 0x70 : return fixed<uint32_t> (*node);
+        case 0x52 : return fixed<uint8_t> (*node);
+        default   : return 0;
+    }
+}
+
+/******************************************************************************/
+
+int32_t
+pn_data_get_int (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node) return 0;
+
+    switch (node->code) {
+        case 0x71 : return fixed<int32_t> (*node);
+        case 0x54 : return fixed<int8_t> (*node);
+        default   : return 0;
+    }
+}
+
+/******************************************************************************/
+
+pn_char_t
+pn_data_get_char (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x73) ? fixed<uint32_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+uint64_t
+pn_data_get_ulong (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node) return 0;
+
+    switch (node->code) {
+        case 0x80 : return fixed<uint64_t> (*node);
+        case 0x53 : return fixed<uint8_t> (*node);
+        default   : return 0;
+    }
+}
+
+/******************************************************************************/
+
+int64_t
+pn_data_get_long (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node) return 0;
+
+    switch (node->code) {
+        case 0x81 : return fixed<int64_t> (*node);
+        case 0x55 : return fixed<int8_t> (*node);
+        default   : return 0;
+    }
+}
+
+/******************************************************************************/
+
+pn_timestamp_t
+pn_data_get_timestamp (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x83) ? fixed<int64_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+float
+pn_data_get_float (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node || node->code != 0x72) return 0;
+
+    float rtn;
+    auto bits = fixed<uint32_t> (*node);
+    std::memcpy (&rtn, &bits, sizeof (rtn));
+    return rtn;
+}
+
+/******************************************************************************/
+
+double
+pn_data_get_double (pn_data_t * data_) {
+    auto node = current (data_);
+    if (!node || node->code != 0x82) return 0;
+
+    double rtn;
+    auto bits = fixed<uint64_t> (*node);
+    std::memcpy (&rtn, &bits, sizeof (rtn));
+    return rtn;
+}
+
+/******************************************************************************/
+
+pn_decimal32_t
+pn_data_get_decimal32 (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x74) ? fixed<uint32_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+pn_decimal64_t
+pn_data_get_decimal64 (pn_data_t * data_) {
+    auto node = current (data_);
+    return (node && node->code == 0x84) ? fixed<uint64_t> (*node) : 0;
+}
+
+/******************************************************************************/
+
+pn_decimal128_t
+pn_data_get_decimal128 (pn_data_t * data_) {
+    pn_decimal128_t rtn { };
+    auto node = current (data_);
+    if (node && node->code == 0x94) {
+        std::memcpy (rtn.bytes, node->value, sizeof (rtn.bytes));
+    }
+    return rtn;
+}
+
+/******************************************************************************/
+
+pn_uuid_t
+pn_data_get_uuid (pn_data_t * data_) {
+    pn_uuid_t rtn { };
+    auto node = current (data_);
+    if (node && node->code == 0x98) {
+        std::memcpy (rtn.bytes, node->value, sizeof (rtn.bytes));
+    }
+    return rtn;
+}
+
+/******************************************************************************/
+
+pn_bytes_t
+pn_data_get_binary (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_BINARY
+        ? variable (data_->m_current)
+        : pn_bytes (0, nullptr);
+}
+
+/******************************************************************************/
+
+pn_bytes_t
+pn_data_get_string (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_STRING
+        ? variable (data_->m_current)
+        : pn_bytes (0, nullptr);
+}
+
+/******************************************************************************/
+
+pn_bytes_t
+pn_data_get_symbol (pn_data_t * data_) {
+    return pn_data_type (data_) == PN_SYMBOL
+        ? variable (data_->m_current)
+        : pn_bytes (0, nullptr);
+}
+
+/******************************************************************************/
+
+pn_bytes_t
+pn_data_get_bytes (pn_data_t * data_) {
+    switch (pn_data_type (data_)) {
+        case PN_BINARY :
+        case PN_STRING :
+        case PN_SYMBOL :
+            return variable (data_->m_current);
+        default :
+            return pn_bytes (0, nullptr);
+    }
+}
+
+/******************************************************************************/
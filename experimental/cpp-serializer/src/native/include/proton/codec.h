@@ -0,0 +1,145 @@
+#pragma once
+
+/******************************************************************************/
+
+/*
+ * A drop in replacement for the read side of qpid-proton's proton/codec.h.
+ *
+ * Rather than decoding a blob into a tree of nodes, as qpid-proton does,
+ * the native implementation walks the encoded bytes in place. The
+ * navigation semantics of pn_data_next, pn_data_enter and pn_data_exit are
+ * identical so anything written against the proton tree runs unchanged,
+ * the one caveat being the buffer handed to pn_data_decode must outlive
+ * the pn_data_t as nothing is copied out of it.
+ */
+
+/******************************************************************************/
+
+#include <sys/types.h>
+
+#include "proton/types.h"
+#include "proton/error.h"
+
+/******************************************************************************/
+
+typedef enum {
+    PN_NULL       = 1,
+    PN_BOOL       = 2,
+    PN_UBYTE      = 3,
+    PN_BYTE       = 4,
+    PN_USHORT     = 5,
+    PN_SHORT      = 6,
+    PN_UINT       = 7,
+    PN_INT        = 8,
+    PN_CHAR       = 9,
+    PN_ULONG      = 10,
+    PN_LONG       = 11,
+    PN_TIMESTAMP  = 12,
+    PN_FLOAT      = 13,
+    PN_DOUBLE     = 14,
+    PN_DECIMAL32  = 15,
+    PN_DECIMAL64  = 16,
+    PN_DECIMAL128 = 17,
+    PN_UUID       = 18,
+    PN_BINARY     = 19,
+    PN_STRING     = 20,
+    PN_SYMBOL     = 21,
+    PN_DESCRIBED  = 22,
+    PN_ARRAY      = 23,
+    PN_LIST       = 24,
+    PN_MAP        = 25,
+    PN_INVALID    = -1
+} pn_type_t;
+
+typedef struct pn_data_t pn_data_t;
+
+/******************************************************************************/
+
+extern "C" {
+
+    const char * pn_type_name (pn_type_t);
+
+    pn_data_t * pn_data (size_t);
+    void pn_data_free (pn_data_t *);
+    void pn_data_clear (pn_data_t *);
+
+    ssize_t pn_data_decode (pn_data_t *, const char *, size_t);
+
+    void pn_data_rewind (pn_data_t *);
+    bool pn_data_next (pn_data_t *);
+    bool pn_data_enter (pn_data_t *);
+    bool pn_data_exit (pn_data_t *);
+
+    pn_type_t pn_data_type (pn_data_t *);
+
+    bool pn_data_is_described (pn_data_t *);
+    bool pn_data_is_null (pn_data_t *);
+    bool pn_data_is_array_described (pn_data_t *);
+
+    size_t pn_data_get_list (pn_data_t *);
+    size_t pn_data_get_map (pn_data_t *);
+    size_t pn_data_get_array (pn_data_t *);
+    pn_type_t pn_data_get_array_type (pn_data_t *);
+
+    bool pn_data_get_bool (pn_data_t *);
+    uint8_t pn_data_get_ubyte (pn_data_t *);
+    int8_t pn_data_get_byte (pn_data_t *);
+    uint16_t pn_data_get_ushort (pn_data_t *);
+    int16_t pn_data_get_short (pn_data_t *);
+    uint32_t pn_data_get_uint (pn_data_t *);
+    int32_t pn_data_get_int (pn_data_t *);
+    pn_char_t pn_data_get_char (pn_data_t *);
+    uint64_t pn_data_get_ulong (pn_data_t *);
+    int64_t pn_data_get_long (pn_data_t *);
+    pn_timestamp_t pn_data_get_timestamp (pn_data_t *);
+    float pn_data_get_float (pn_data_t *);
+    double pn_data_get_double (pn_data_t *);
+    pn_decimal32_t pn_data_get_decimal32 (pn_data_t *);
+    pn_decimal64_t pn_data_get_decimal64 (pn_data_t *);
+    pn_decimal128_t pn_data_get_decimal128 (pn_data_t *);
+    pn_uuid_t pn_data_get_uuid (pn_data_t *);
+    pn_bytes_t pn_data_get_binary (pn_data_t *);
+    pn_bytes_t pn_data_get_string (pn_data_t *);
+    pn_bytes_t pn_data_get_symbol (pn_data_t *);
+    pn_bytes_t pn_data_get_bytes (pn_data_t *);
+
+}
+
+/******************************************************************************
+ *
+ * Not part of qpid-proton, see proton::skip for something that works
+ * against either
+ *
+ ******************************************************************************/
+
+extern "C" {
+
+    /**
+     * Move past the current value without looking inside it, counting the
+     * bytes it occupies as skipped
+     */
+    bool pn_data_skip (pn_data_t *);
+
+    /**
+     * How many bytes have been skipped since the last pn_data_decode
+     */
+    size_t pn_data_skipped (pn_data_t *);
+
+    /**
+     * How far into the decoded bytes the current value starts, or without
+     * one where the first child of the node we're in would be
+     */
+    size_t pn_data_offset (pn_data_t *);
+
+    /**
+     * With the cursor on a list or array of exactly [count_] values of
+     * [type_], one of PN_INT, PN_LONG or PN_DOUBLE, decode them all into
+     * [out_], an array of int32_t, int64_t or double. Should anything in
+     * it be something else, a null say, false is returned and [out_] is
+     * left however far we got. The cursor doesn't move.
+     */
+    bool pn_data_get_primitives (pn_data_t *, pn_type_t type_, void * out_, size_t count_);
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,18 @@
+#pragma once
+
+/******************************************************************************/
+
+/*
+ * Error codes as returned by qpid-proton's codec functions
+ */
+
+/******************************************************************************/
+
+#define PN_EOS        (-1)
+#define PN_ERR        (-2)
+#define PN_OVERFLOW   (-3)
+#define PN_UNDERFLOW  (-4)
+#define PN_STATE_ERR  (-5)
+#define PN_ARG_ERR    (-6)
+
+/******************************************************************************/
@@ -0,0 +1,42 @@
+#pragma once
+
+/******************************************************************************/
+
+/*
+ * The subset of qpid-proton's proton/types.h the native decoder needs. The
+ * layout of these types matches the real library so code written against
+ * one compiles unchanged against the other.
+ */
+
+/******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+/******************************************************************************/
+
+typedef int64_t  pn_timestamp_t;
+typedef uint32_t pn_char_t;
+typedef uint32_t pn_decimal32_t;
+typedef uint64_t pn_decimal64_t;
+
+typedef struct {
+    char bytes[16];
+} pn_decimal128_t;
+
+typedef struct {
+    char bytes[16];
+} pn_uuid_t;
+
+typedef struct pn_bytes_t {
+    size_t size;
+    const char * start;
+} pn_bytes_t;
+
+extern "C" {
+
+    pn_bytes_t pn_bytes (size_t, const char *);
+
+}
+
+/******************************************************************************/
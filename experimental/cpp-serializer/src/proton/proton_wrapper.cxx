@@ -1,6 +1,7 @@
 #include "proton_wrapper.h"
 
 #include <sstream>
+#include <string_view>
 #include <iomanip>
 #include <iostream>
 
@@ -75,6 +76,112 @@ proton::pn_data_enter(pn_data_t * data_) {
 
 /******************************************************************************/
 
+bool
+proton::skip (pn_data_t * data_) {
+#ifdef AMQP_CODEC_NATIVE
+    return pn_data_skip (data_);
+#else
+    return pn_data_next (data_);
+#endif
+}
+
+/******************************************************************************/
+
+size_t
+proton::skipped (pn_data_t * data_) {
+#ifdef AMQP_CODEC_NATIVE
+    return pn_data_skipped (data_);
+#else
+    return 0;
+#endif
+}
+
+/******************************************************************************/
+
+size_t
+proton::offset (pn_data_t * data_) {
+#ifdef AMQP_CODEC_NATIVE
+    return pn_data_offset (data_);
+#else
+    return 0;
+#endif
+}
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * qpid-proton has already decoded everything into its own tree so all
+     * we can save is the per element work of the readers
+     */
+    template<typename T, pn_type_t type_, auto get_>
+    bool
+    primitives (pn_data_t * data_, T * out_, size_t size_) {
+        auto type = pn_data_type (data_);
+
+        if (type == PN_ARRAY && pn_data_get_array_type (data_) != type_) {
+            return false;
+        }
+
+        if (type != PN_ARRAY && type != PN_LIST) {
+            return false;
+        }
+
+        ::pn_data_enter (data_);
+
+        size_t i { 0 };
+
+        for ( ; i < size_ && pn_data_next (data_) ; ++i) {
+            if (pn_data_type (data_) != type_) {
+                break;
+            }
+
+            out_[i] = get_ (data_);
+        }
+
+        pn_data_exit (data_);
+
+        return i == size_;
+    }
+
+}
+
+/******************************************************************************/
+
+bool
+proton::readPrimitives (pn_data_t * data_, int32_t * out_, size_t size_) {
+#ifdef AMQP_CODEC_NATIVE
+    return pn_data_get_primitives (data_, PN_INT, out_, size_);
+#else
+    return primitives<int32_t, PN_INT, &pn_data_get_int> (data_, out_, size_);
+#endif
+}
+
+/******************************************************************************/
+
+bool
+proton::readPrimitives (pn_data_t * data_, int64_t * out_, size_t size_) {
+#ifdef AMQP_CODEC_NATIVE
+    return pn_data_get_primitives (data_, PN_LONG, out_, size_);
+#else
+    return primitives<int64_t, PN_LONG, &pn_data_get_long> (data_, out_, size_);
+#endif
+}
+
+/******************************************************************************/
+
+bool
+proton::readPrimitives (pn_data_t * data_, double * out_, size_t size_) {
+#ifdef AMQP_CODEC_NATIVE
+    return pn_data_get_primitives (data_, PN_DOUBLE, out_, size_);
+#else
+    return primitives<double, PN_DOUBLE, &pn_data_get_double> (data_, out_, size_);
+#endif
+}
+
+/******************************************************************************/
+
 void
 proton::is_described (pn_data_t * data_) {
     if (pn_data_type(data_) != PN_DESCRIBED) {
@@ -312,6 +419,35 @@ readAndNext<std::string> (
 
 /******************************************************************************/
 
+/**
+ * As above but without the copy, the view is into the decoded blob so is
+ * only good for as long as that is
+ */
+template<>
+std::string_view
+proton::
+readAndNext<std::string_view> (
+    pn_data_t * data_,
+    bool tolerateDeviance_
+) {
+    auto_next an (data_);
+
+    if (pn_data_type(data_) == PN_STRING) {
+        auto str = pn_data_get_string(data_);
+        return std::string_view (str.start, str.size);
+    } else if (pn_data_type(data_) == PN_SYMBOL) {
+        auto symbol = pn_data_get_symbol(data_);
+        return std::string_view (symbol.start, symbol.size);
+    } else  if (tolerateDeviance_ && pn_data_type(data_) == PN_NULL) {
+        return { };
+    }
+    std::stringstream ss;
+    ss << "Expected a String but found [" << data_ << "]";
+    throw std::runtime_error (ss.str());
+}
+
+/******************************************************************************/
+
 template<>
 bool
 proton::
@@ -4,6 +4,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 
 #include <proton/types.h>
 #include <proton/codec.h>
@@ -39,11 +40,63 @@ namespace proton {
         return T {};
     }
 
+    template<> std::string get_symbol<std::string> (pn_data_t *);
+    template<> pn_bytes_t get_symbol<pn_bytes_t> (pn_data_t *);
+
     std::string get_symbol (pn_data_t *);
 
     bool get_boolean (pn_data_t *);
     std::string get_string (pn_data_t *, bool allowNull = false);
 
+    /**
+     * Move past the value [data_] is on without decoding any of it. With
+     * the native codec that's one jump over a list, map or array thanks to
+     * their size prefix, qpid-proton having already decoded the lot it's
+     * simply pn_data_next
+     */
+    bool skip (pn_data_t *);
+
+    /**
+     * How many bytes of the blob have been passed over with [skip], only
+     * the native codec keeps count so with qpid-proton it's always 0
+     */
+    size_t skipped (pn_data_t *);
+
+    /**
+     * How many bytes into the blob the value [data_] is on starts, only
+     * the native codec knows so with qpid-proton it's always 0
+     */
+    size_t offset (pn_data_t *);
+
+    /**
+     * With [data_] on a list or array of nothing but ints, longs or
+     * doubles read the lot into [out_] in one go, not moving off it. If
+     * anything in it is something else, a null say, it has to be read an
+     * element at a time so we return false.
+     */
+    bool readPrimitives (pn_data_t *, int32_t * out_, size_t);
+    bool readPrimitives (pn_data_t *, int64_t * out_, size_t);
+    bool readPrimitives (pn_data_t *, double * out_, size_t);
+
+    /**
+     * As above into a vector of [T]s sized to fit, left empty if we
+     * couldn't
+     */
+    template<class V>
+    bool
+    readPrimitives (pn_data_t * data_, V & out_) {
+        out_.resize (pn_data_type (data_) == PN_ARRAY
+            ? pn_data_get_array (data_)
+            : pn_data_get_list (data_));
+
+        if (!readPrimitives (data_, out_.data(), out_.size())) {
+            out_.clear();
+            return false;
+        }
+
+        return true;
+    }
+
     class auto_enter {
         private :
             pn_data_t * m_data;
@@ -104,6 +157,18 @@ namespace proton {
         return T{};
     }
 
+    /**
+     * Specialised in the CXX file, declared here so callers don't
+     * instantiate the default above instead
+     */
+    template<> int32_t readAndNext<int32_t> (pn_data_t *, bool);
+    template<> std::string readAndNext<std::string> (pn_data_t *, bool);
+    template<> std::string_view readAndNext<std::string_view> (pn_data_t *, bool);
+    template<> bool readAndNext<bool> (pn_data_t *, bool);
+    template<> double readAndNext<double> (pn_data_t *, bool);
+    template<> long readAndNext<long> (pn_data_t *, bool);
+    template<> u_long readAndNext<u_long> (pn_data_t *, bool);
+
 }
 
 /******************************************************************************/